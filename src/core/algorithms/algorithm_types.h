@@ -8,7 +8,7 @@ namespace algos {
 
 using AlgorithmTypes =
         std::tuple<Depminer, DFD, FastFDs, FDep, Fd_mine, Pyro, Tane, FUN, hyfd::HyFD, Aid, Apriori,
-                   metric::MetricVerifier, DataStats, fd_verifier::FDVerifier, HyUCC,
+                   FPGrowth, metric::MetricVerifier, DataStats, fd_verifier::FDVerifier, HyUCC,
                    cfd::FDFirstAlgorithm, ACAlgorithm, UCCVerifier>;
 
 // clang-format off
@@ -33,6 +33,7 @@ BETTER_ENUM(AlgorithmType, char,
 
 /* Association rules mining algorithms */
     apriori,
+    fpgrowth,
 
 /* Metric verifier algorithm */
     metric,
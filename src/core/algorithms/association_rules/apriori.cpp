@@ -2,12 +2,36 @@
 
 #include <algorithm>
 #include <cassert>
+#include <numeric>
 
 #include <easylogging++.h>
 
+#include "config/names_and_descriptions.h"
+#include "config/option_using.h"
+#include "util/parallel_for.h"
+
+namespace {
+
+// Every frequent itemset of the last level and every candidate of the next one keep a bitmap of
+// one bit per transaction. With tens of millions of transactions these bitmaps take megabytes
+// each, so the automatic support counting uses them only while they fit in this bound.
+constexpr size_t kMaxTidBitmapBytes = size_t{1} << 30;
+
+}  // namespace
+
 namespace algos {
 
-Apriori::Apriori() : ARAlgorithm({}) {}
+Apriori::Apriori() : ARAlgorithm({}) {
+    DESBORDANTE_OPTION_USING;
+
+    SupportCounting default_counting = SupportCounting::automatic;
+    RegisterOption(
+            Option{&support_counting_, kSupportCounting, kDSupportCounting, default_counting});
+}
+
+void Apriori::MakeExecuteOptsAvailableAr() {
+    MakeOptionsAvailable({config::names::kSupportCounting});
+}
 
 void Apriori::GenerateCandidates(std::vector<Node>& children) {
     auto const last_child_iter = std::prev(children.end());
@@ -17,10 +41,43 @@ void Apriori::GenerateCandidates(std::vector<Node>& children) {
             std::vector<unsigned> items = child_iter->items;
             items.push_back(child_right_sibling_iter->items.back());
 
-            if (!CanBePruned(items)) {
-                candidates_[&(*child_iter)].emplace_back(std::move(items));
+            if (CanBePruned(items)) {
+                continue;
+            }
+            Node& candidate = candidates_[&(*child_iter)].emplace_back(std::move(items));
+            if (use_tid_bitmaps_) {
+                bitmap_candidates_.push_back({&candidate, &(*child_iter),
+                                              &(*child_right_sibling_iter)});
+            }
+        }
+    }
+}
+
+void Apriori::CountSupportWithTidBitmaps() {
+    // Every thread intersects the bitmaps of its own part of the candidates in a reused buffer,
+    // and only the frequent candidates get a copy of it
+    std::vector<size_t> workers(std::min<size_t>(threads_num_, bitmap_candidates_.size()));
+    std::iota(workers.begin(), workers.end(), 0);
+    auto const count = [this, &workers](size_t worker) {
+        boost::dynamic_bitset<> tids;
+        size_t const first = worker * bitmap_candidates_.size() / workers.size();
+        size_t const last = (worker + 1) * bitmap_candidates_.size() / workers.size();
+        for (size_t i = first; i != last; ++i) {
+            auto const& [candidate, generator, sibling_generator] = bitmap_candidates_[i];
+            tids = generator->tids;
+            tids &= sibling_generator->tids;
+            candidate->support = GetSupportOf(tids.count());
+            if (candidate->support >= minsup_) {
+                candidate->tids = tids;
             }
         }
+    };
+    util::parallel_foreach(workers.begin(), workers.end(), threads_num_, count);
+    bitmap_candidates_.clear();
+
+    for (auto it = candidates_.begin(); it != candidates_.end();) {
+        it->second.remove_if([this](Node const& candidate) { return candidate.support < minsup_; });
+        it = it->second.empty() ? candidates_.erase(it) : std::next(it);
     }
 }
 
@@ -31,9 +88,48 @@ void Apriori::CreateFirstLevelCandidates() {
     ++level_num_;
 }
 
+bool Apriori::DoTidBitmapsFit(size_t num_bitmaps) const {
+    using Block = boost::dynamic_bitset<>::block_type;
+    size_t const bits_per_block = boost::dynamic_bitset<>::bits_per_block;
+    size_t const num_transactions = transactional_data_->GetNumTransactions();
+    size_t const bitmap_bytes =
+            (num_transactions + bits_per_block - 1) / bits_per_block * sizeof(Block);
+    LOG(DEBUG) << "Tid bitmaps: " << num_bitmaps << " of " << bitmap_bytes << " bytes";
+    return bitmap_bytes == 0 || num_bitmaps <= kMaxTidBitmapBytes / bitmap_bytes;
+}
+
+void Apriori::CreateFirstLevelWithTidBitmaps(std::vector<size_t> const& item_counts) {
+    size_t const num_transactions = transactional_data_->GetNumTransactions();
+    std::vector<boost::dynamic_bitset<>> item_tids(item_counts.size());
+    for (unsigned item_id = 0; item_id < item_counts.size(); ++item_id) {
+        if (GetSupportOf(item_counts[item_id]) >= minsup_) {
+            item_tids[item_id].resize(num_transactions);
+        }
+    }
+
+    for (size_t position = 0; position != num_transactions; ++position) {
+        for (unsigned item_id : transactional_data_->GetTransaction(position)) {
+            if (!item_tids[item_id].empty()) {
+                item_tids[item_id].set(position);
+            }
+        }
+    }
+
+    for (unsigned item_id = 0; item_id < item_counts.size(); ++item_id) {
+        if (item_tids[item_id].empty()) {
+            continue;
+        }
+        Node& candidate = candidates_[&root_].emplace_back(item_id);
+        candidate.support = GetSupportOf(item_counts[item_id]);
+        candidate.tids = std::move(item_tids[item_id]);
+    }
+    ++level_num_;
+}
+
 bool Apriori::GenerateNextCandidateLevel() {
     std::stack<Node*> path;
     path.push(&root_);
+    std::vector<Node*> generator_parents;
 
     assert(level_num_ >= 2);
     while (!path.empty()) {
@@ -41,13 +137,41 @@ bool Apriori::GenerateNextCandidateLevel() {
         path.pop();
         if (node->items.size() == level_num_ - 2 && !node->children.empty()) {
             GenerateCandidates(node->children);
+            generator_parents.push_back(node);
         } else {
             UpdatePath(path, node->children);
         }
     }
 
+    if (use_tid_bitmaps_ && support_counting_ == +SupportCounting::automatic) {
+        size_t num_generators = 0;
+        for (Node const* parent : generator_parents) {
+            num_generators += parent->children.size();
+        }
+        if (!DoTidBitmapsFit(num_generators + bitmap_candidates_.size())) {
+            // The candidates of this and all next levels are counted by the hash tree
+            LOG(DEBUG) << "Support counting: hash tree from level " << level_num_;
+            use_tid_bitmaps_ = false;
+            bitmap_candidates_.clear();
+            for (Node* parent : generator_parents) {
+                for (Node& generator : parent->children) {
+                    generator.tids = boost::dynamic_bitset<>();
+                }
+            }
+        }
+    }
+
+    if (use_tid_bitmaps_) {
+        CountSupportWithTidBitmaps();
+        for (Node* parent : generator_parents) {
+            for (Node& generator : parent->children) {
+                generator.tids = boost::dynamic_bitset<>();
+            }
+        }
+    }
+
     ++level_num_;
-    return candidate_hash_tree_->Size() > 0;
+    return !candidates_.empty();
 }
 
 void Apriori::UpdatePath(std::stack<Node*>& path, std::vector<Node>& vertices) {
@@ -64,13 +188,6 @@ void Apriori::UpdatePath(std::stack<Node const*>& path, std::vector<Node> const&
     }
 }
 
-void Apriori::UpdatePath(std::queue<Node const*>& path, std::vector<Node> const& vertices) {
-    for (auto const& vertex : vertices) {
-        Node const* node_ptr = &vertex;
-        path.push(node_ptr);
-    }
-}
-
 bool Apriori::CanBePruned(std::vector<unsigned> const& itemset) {
     // we are able not to skip the last element, because without it the itemset is surely frequent
     assert(itemset.size() >= 2);
@@ -118,26 +235,50 @@ bool Apriori::CanBePruned(std::vector<unsigned> const& itemset) {
 void Apriori::ResetStateAr() {
     level_num_ = 1;
     candidates_.clear();
+    bitmap_candidates_.clear();
     root_ = Node();
 }
 
+void Apriori::CountSupportWithHashTree() {
+    unsigned candidates_count = 0;
+    for (auto const& [parent, candidate_children] : candidates_) {
+        candidates_count += candidate_children.size();
+    }
+    auto const branching_degree = level_num_;
+    auto const min_treshold = candidates_count / branching_degree + 1;
+
+    candidate_hash_tree_ = std::make_unique<CandidateHashTree>(transactional_data_.get(),
+                                                               candidates_,
+                                                               branching_degree, min_treshold);
+    candidate_hash_tree_->PerformCounting(threads_num_);
+    candidate_hash_tree_->PruneNodes(minsup_);
+}
+
 unsigned long long Apriori::FindFrequent() {
     auto start_time = std::chrono::system_clock::now();
 
-    CreateFirstLevelCandidates();
+    std::vector<size_t> item_counts;
+    if (support_counting_ != +SupportCounting::hash_tree) {
+        item_counts = CountItems();
+    }
+    use_tid_bitmaps_ = support_counting_ == +SupportCounting::tid_bitmap;
+    if (support_counting_ == +SupportCounting::automatic) {
+        size_t const num_frequent_items =
+                std::count_if(item_counts.begin(), item_counts.end(),
+                              [this](size_t count) { return GetSupportOf(count) >= minsup_; });
+        use_tid_bitmaps_ = DoTidBitmapsFit(num_frequent_items);
+    }
+    LOG(DEBUG) << "Support counting: " << (use_tid_bitmaps_ ? "tid bitmaps" : "hash tree");
+
+    if (use_tid_bitmaps_) {
+        CreateFirstLevelWithTidBitmaps(item_counts);
+    } else {
+        CreateFirstLevelCandidates();
+    }
     while (!candidates_.empty()) {
-        unsigned candidates_count = 0;
-        for (auto const& [parent, candidate_children] : candidates_) {
-            candidates_count += candidate_children.size();
+        if (!use_tid_bitmaps_) {
+            CountSupportWithHashTree();
         }
-        auto const branching_degree = level_num_;
-        auto const min_treshold = candidates_count / branching_degree + 1;
-
-        candidate_hash_tree_ = std::make_unique<CandidateHashTree>(transactional_data_.get(),
-                                                                   candidates_,
-                                                                   branching_degree, min_treshold);
-        candidate_hash_tree_->PerformCounting();
-        candidate_hash_tree_->PruneNodes(minsup_);
         AppendToTree();
         candidates_.clear();
         GenerateNextCandidateLevel();
@@ -151,74 +292,15 @@ unsigned long long Apriori::FindFrequent() {
 }
 
 unsigned long long Apriori::GenerateAllRules() {
-    auto start_time = std::chrono::system_clock::now();
-
-    std::queue<Node const*> path;
-    UpdatePath(path, root_.children);
-    unsigned long long frequent_count = 0;
-
-    while (!path.empty()) {
-        auto curr_node = path.front();
-        path.pop();
-
-        ++frequent_count;
-        if (curr_node->items.size() >= 2) {
-            GenerateRulesFrom(curr_node->items, curr_node->support);
-        }
-        UpdatePath(path, curr_node->children);
-    }
-
-    auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now() - start_time);
-    long long millis = elapsed_milliseconds.count();
-
-    LOG(INFO) << "> Count of frequent itemsets: " << frequent_count;
-    return millis;
+    return GenerateAllRulesFrom(root_);
 }
 
 std::list<std::set<std::string>> Apriori::GetFrequentList() const {
-    std::list<std::set<std::string>> frequent_itemsets;
-
-    std::queue<Node const*> path;
-    UpdatePath(path, root_.children);
-
-    while (!path.empty()) {
-        auto const curr_node = path.front();
-        path.pop();
-
-        std::set<std::string> item_names;
-        for (unsigned int item : curr_node->items) {
-            item_names.insert(transactional_data_->GetItemUniverse()[item]);
-        }
-
-        frequent_itemsets.push_back(std::move(item_names));
-        UpdatePath(path, curr_node->children);
-    }
-
-    return frequent_itemsets;
+    return GetFrequentListFrom(root_);
 }
 
 double Apriori::GetSupport(std::vector<unsigned int> const& frequent_itemset) const {
-    auto const* path = &(root_.children);
-    unsigned item_index = 0;
-    auto node_comparator = [&item_index](Node const& node, std::vector<unsigned> const& items) {
-        return node.items[item_index] < items[item_index];
-    };
-
-    while (item_index != frequent_itemset.size()) {
-        auto const& node_vector = *path;
-        auto next_node = std::lower_bound(node_vector.begin(), node_vector.end(), frequent_itemset,
-                                          node_comparator);
-        if (next_node == node_vector.end()) {
-            break;
-        } else if (item_index == frequent_itemset.size() - 1) {
-            return next_node->support;
-        } else {
-            path = &(next_node->children);
-        }
-        ++item_index;
-    }
-    return -1;
+    return GetSupportFrom(root_, frequent_itemset);
 }
 
 void Apriori::AppendToTree() {
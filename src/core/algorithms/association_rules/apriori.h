@@ -1,10 +1,12 @@
 #pragma once
 
 #include <list>
-#include <queue>
 #include <stack>
 #include <vector>
 
+#include <boost/dynamic_bitset.hpp>
+
+#include "algorithms/association_rules/ar_algorithm_enums.h"
 #include "algorithms/association_rules/candidate_hash_tree.h"
 #include "algorithms/association_rules/node.h"
 #include "ar_algorithm.h"
@@ -21,6 +23,17 @@ private:
     std::unordered_map<Node*, std::list<Node>> candidates_;
     unsigned level_num_ = 1;
 
+    SupportCounting support_counting_ = SupportCounting::automatic;
+    bool use_tid_bitmaps_ = false;
+
+    // A candidate whose support is found by intersecting the tid bitmaps of its generators
+    struct BitmapCandidate {
+        Node* candidate;
+        Node const* generator;
+        Node const* sibling_generator;
+    };
+    std::vector<BitmapCandidate> bitmap_candidates_;
+
     bool GenerateNextCandidateLevel();
 
     bool CanBePruned(std::vector<unsigned> const& itemset);
@@ -28,8 +41,15 @@ private:
     void CreateFirstLevelCandidates();
     void AppendToTree();
 
+    // Checks whether the given number of tid bitmaps fits in the memory bound of the automatic
+    // support counting
+    bool DoTidBitmapsFit(size_t num_bitmaps) const;
+    void CountSupportWithHashTree();
+    // With tid bitmaps only the frequent candidates are created, their support is known right away
+    void CreateFirstLevelWithTidBitmaps(std::vector<size_t> const& item_counts);
+    void CountSupportWithTidBitmaps();
+
     static void UpdatePath(std::stack<Node*>& path, std::vector<Node>& vertices);
-    static void UpdatePath(std::queue<Node const*>& path, std::vector<Node> const& vertices);
     static void UpdatePath(std::stack<Node const*>& path, std::vector<Node> const& vertices);
 
     double GetSupport(std::vector<unsigned> const& frequent_itemset) const override;
@@ -37,6 +57,7 @@ private:
     unsigned long long FindFrequent() override;
 
     void ResetStateAr() final;
+    void MakeExecuteOptsAvailableAr() final;
 
 public:
     Apriori();
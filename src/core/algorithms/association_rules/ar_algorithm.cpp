@@ -2,12 +2,16 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <numeric>
 
 #include <easylogging++.h>
 
 #include "config/names_and_descriptions.h"
 #include "config/option_using.h"
 #include "config/tabular_data/input_table/option.h"
+#include "config/thread_number/option.h"
+#include "util/parallel_for.h"
 
 namespace algos {
 
@@ -32,6 +36,7 @@ void ARAlgorithm::RegisterOptions() {
     RegisterOption(Option{&tid_column_index_, kTIdColumnIndex, kDTIdColumnIndex, 0u});
     RegisterOption(Option{&input_format_, kInputFormat, kDInputFormat}.SetConditionalOpts(
             {{sing_eq, {kTIdColumnIndex, kItemColumnIndex}}, {tab_eq, {kFirstColumnTId}}}));
+    RegisterOption(config::ThreadNumberOpt(&threads_num_));
 }
 
 void ARAlgorithm::ResetState() {
@@ -41,7 +46,8 @@ void ARAlgorithm::ResetState() {
 
 void ARAlgorithm::MakeExecuteOptsAvailable() {
     using namespace config::names;
-    MakeOptionsAvailable({kMinimumSupport, kMinimumConfidence});
+    MakeOptionsAvailable({kMinimumSupport, kMinimumConfidence, config::ThreadNumberOpt.GetName()});
+    MakeExecuteOptsAvailableAr();
 }
 
 void ARAlgorithm::LoadDataInternal() {
@@ -77,8 +83,121 @@ void ARAlgorithm::UpdatePath(std::stack<RuleNode*>& path, std::list<RuleNode>& v
     }
 }
 
-void ARAlgorithm::GenerateRulesFrom(std::vector<unsigned> const& frequent_itemset, double support) {
-    root_.children.clear();
+std::vector<size_t> ARAlgorithm::CountItems() const {
+    std::vector<size_t> item_counts(transactional_data_->GetUniverseSize(), 0);
+    // An item may be listed several times in one transaction, but is counted once
+    std::vector<size_t> last_position(item_counts.size(), 0);
+    for (size_t position = 1; position <= transactional_data_->GetNumTransactions(); ++position) {
+        for (unsigned item_id : transactional_data_->GetTransaction(position - 1)) {
+            if (last_position[item_id] != position) {
+                last_position[item_id] = position;
+                ++item_counts[item_id];
+            }
+        }
+    }
+    return item_counts;
+}
+
+void ARAlgorithm::UpdatePath(std::queue<Node const*>& path, std::vector<Node> const& vertices) {
+    for (auto const& vertex : vertices) {
+        Node const* node_ptr = &vertex;
+        path.push(node_ptr);
+    }
+}
+
+unsigned long long ARAlgorithm::GenerateAllRulesFrom(Node const& root) {
+    auto start_time = std::chrono::system_clock::now();
+
+    std::queue<Node const*> path;
+    UpdatePath(path, root.children);
+    unsigned long long frequent_count = 0;
+    std::vector<Node const*> rule_sources;
+
+    while (!path.empty()) {
+        auto curr_node = path.front();
+        path.pop();
+
+        ++frequent_count;
+        if (curr_node->items.size() >= 2) {
+            rule_sources.push_back(curr_node);
+        }
+        UpdatePath(path, curr_node->children);
+    }
+
+    // Itemsets get larger towards the end of the order, so they are dealt to the threads one by
+    // one instead of in contiguous parts. The rules are collected in the sequential order.
+    std::vector<std::list<model::ArIDs>> rules(rule_sources.size());
+    std::vector<size_t> workers(std::min<size_t>(threads_num_, rule_sources.size()));
+    std::iota(workers.begin(), workers.end(), 0);
+    auto const generate = [this, &rule_sources, &rules, &workers](size_t worker) {
+        RuleNode rule_root;
+        for (size_t i = worker; i < rule_sources.size(); i += workers.size()) {
+            GenerateRulesFrom(rule_sources[i]->items, rule_sources[i]->support, rule_root,
+                              rules[i]);
+        }
+    };
+    util::parallel_foreach(workers.begin(), workers.end(), threads_num_, generate);
+    for (auto& itemset_rules : rules) {
+        ar_collection_.splice(ar_collection_.end(), itemset_rules);
+    }
+
+    auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now() - start_time);
+    long long millis = elapsed_milliseconds.count();
+
+    LOG(INFO) << "> Count of frequent itemsets: " << frequent_count;
+    return millis;
+}
+
+std::list<std::set<std::string>> ARAlgorithm::GetFrequentListFrom(Node const& root) const {
+    std::list<std::set<std::string>> frequent_itemsets;
+
+    std::queue<Node const*> path;
+    UpdatePath(path, root.children);
+
+    while (!path.empty()) {
+        auto const curr_node = path.front();
+        path.pop();
+
+        std::set<std::string> item_names;
+        for (unsigned int item : curr_node->items) {
+            item_names.insert(transactional_data_->GetItemUniverse()[item]);
+        }
+
+        frequent_itemsets.push_back(std::move(item_names));
+        UpdatePath(path, curr_node->children);
+    }
+
+    return frequent_itemsets;
+}
+
+double ARAlgorithm::GetSupportFrom(Node const& root,
+                                   std::vector<unsigned int> const& frequent_itemset) {
+    auto const* path = &(root.children);
+    unsigned item_index = 0;
+    auto node_comparator = [&item_index](Node const& node, std::vector<unsigned> const& items) {
+        return node.items[item_index] < items[item_index];
+    };
+
+    while (item_index != frequent_itemset.size()) {
+        auto const& node_vector = *path;
+        auto next_node = std::lower_bound(node_vector.begin(), node_vector.end(), frequent_itemset,
+                                          node_comparator);
+        if (next_node == node_vector.end()) {
+            break;
+        } else if (item_index == frequent_itemset.size() - 1) {
+            return next_node->support;
+        } else {
+            path = &(next_node->children);
+        }
+        ++item_index;
+    }
+    return -1;
+}
+
+void ARAlgorithm::GenerateRulesFrom(std::vector<unsigned> const& frequent_itemset, double support,
+                                    RuleNode& root, std::list<model::ArIDs>& rules) const {
+    root.children.clear();
     for (auto item_id : frequent_itemset) {
         std::vector<unsigned> rhs{item_id};
         std::vector<unsigned> lhs;
@@ -88,26 +207,26 @@ void ARAlgorithm::GenerateRulesFrom(std::vector<unsigned> const& frequent_itemse
         auto const lhs_support = GetSupport(lhs);
         auto const confidence = support / lhs_support;
         if (confidence >= minconf_) {
-            auto const& new_ar = ar_collection_.emplace_back(std::move(lhs), std::move(rhs),
-                                                             confidence);
-            root_.children.emplace_back(new_ar);
+            auto const& new_ar = rules.emplace_back(std::move(lhs), std::move(rhs), confidence);
+            root.children.emplace_back(new_ar);
         }
     }
-    if (root_.children.empty()) {
+    if (root.children.empty()) {
         return;
     }
 
     unsigned level_number = 2;
-    while (GenerateRuleLevel(frequent_itemset, support, level_number)) {
+    while (GenerateRuleLevel(frequent_itemset, support, level_number, root, rules)) {
         ++level_number;
     }
 }
 
 bool ARAlgorithm::GenerateRuleLevel(std::vector<unsigned> const& frequent_itemset, double support,
-                                    unsigned level_number) {
+                                    unsigned level_number, RuleNode& root,
+                                    std::list<model::ArIDs>& rules) const {
     bool generated_any = false;
     std::stack<RuleNode*> path;
-    path.push(&root_);
+    path.push(&root);
 
     assert(level_number >= 2);
     while (!path.empty()) {
@@ -115,7 +234,7 @@ bool ARAlgorithm::GenerateRuleLevel(std::vector<unsigned> const& frequent_itemse
         auto node = path.top();
         path.pop();
         if (node->rule.right.size() == level_number - 2) {  // levelNumber is at least 2
-            generated_any = MergeRules(frequent_itemset, support, node);
+            generated_any = MergeRules(frequent_itemset, support, node, rules);
         } else {
             UpdatePath(path, node->children);
         }
@@ -125,7 +244,7 @@ bool ARAlgorithm::GenerateRuleLevel(std::vector<unsigned> const& frequent_itemse
 }
 
 bool ARAlgorithm::MergeRules(std::vector<unsigned> const& frequent_itemset, double support,
-                             RuleNode* node) {
+                             RuleNode* node, std::list<model::ArIDs>& rules) const {
     auto& children = node->children;
     bool is_rule_produced = false;
 
@@ -148,8 +267,8 @@ bool ARAlgorithm::MergeRules(std::vector<unsigned> const& frequent_itemset, doub
             auto const lhs_support = GetSupport(lhs);
             auto const confidence = support / lhs_support;
             if (confidence >= minconf_) {
-                auto const& new_ar = ar_collection_.emplace_back(std::move(lhs), std::move(rhs),
-                                                                 confidence);
+                auto const& new_ar = rules.emplace_back(std::move(lhs), std::move(rhs),
+                                                        confidence);
                 child_iter->children.emplace_back(new_ar);
                 is_rule_produced = true;
             }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <list>
+#include <queue>
 #include <set>
 #include <stack>
 #include <vector>
@@ -10,7 +11,9 @@
 #include "algorithms/algorithm.h"
 #include "ar.h"
 #include "ar_algorithm_enums.h"
+#include "node.h"
 #include "config/tabular_data/input_table_type.h"
+#include "config/thread_number/type.h"
 #include "model/transaction/transactional_data.h"
 
 namespace algos {
@@ -38,12 +41,16 @@ private:
             : rule(rule) {}
     };
 
-    RuleNode root_;
-
-    bool GenerateRuleLevel(std::vector<unsigned> const& frequent_itemset,
-                           double support, unsigned level_number);
-    bool MergeRules(std::vector<unsigned> const& frequent_itemset, double support, RuleNode* node);
+    // Rules of a single itemset are generated into rules, root is the tree of these rules
+    void GenerateRulesFrom(std::vector<unsigned> const& frequent_itemset, double support,
+                           RuleNode& root, std::list<model::ArIDs>& rules) const;
+    bool GenerateRuleLevel(std::vector<unsigned> const& frequent_itemset, double support,
+                           unsigned level_number, RuleNode& root,
+                           std::list<model::ArIDs>& rules) const;
+    bool MergeRules(std::vector<unsigned> const& frequent_itemset, double support, RuleNode* node,
+                    std::list<model::ArIDs>& rules) const;
     static void UpdatePath(std::stack<RuleNode*>& path, std::list<RuleNode>& vertices);
+    static void UpdatePath(std::queue<Node const*>& path, std::vector<Node> const& vertices);
     void RegisterOptions();
 
     void ResetState() final;
@@ -52,12 +59,25 @@ private:
 protected:
     std::unique_ptr<model::TransactionalData> transactional_data_;
     double minsup_;
+    config::ThreadNumType threads_num_ = 1;
+
+    double GetSupportOf(size_t transaction_count) const noexcept {
+        return static_cast<double>(transaction_count) / transactional_data_->GetNumTransactions();
+    }
+    // Number of transactions that contain each item
+    std::vector<size_t> CountItems() const;
 
-    void GenerateRulesFrom(std::vector<unsigned> const& frequent_itemset, double support);
+    // Implementations for the algorithms that store the frequent itemsets in a prefix tree whose
+    // nodes have their children sorted by the last item
+    unsigned long long GenerateAllRulesFrom(Node const& root);
+    std::list<std::set<std::string>> GetFrequentListFrom(Node const& root) const;
+    static double GetSupportFrom(Node const& root, std::vector<unsigned> const& frequent_itemset);
 
+    // Rules are generated by several threads at once, so this has to be safe to call concurrently
     virtual double GetSupport(std::vector<unsigned> const& frequent_itemset) const = 0;
     virtual unsigned long long GenerateAllRules() = 0;
     virtual unsigned long long FindFrequent() = 0;
+    virtual void MakeExecuteOptsAvailableAr() {}
     void LoadDataInternal() final;
     void MakeExecuteOptsAvailable() final;
     unsigned long long ExecuteInternal() final;
@@ -9,4 +9,13 @@ BETTER_ENUM(InputFormat, char,
     tabular
 );
 
+BETTER_ENUM(SupportCounting, char,
+    automatic = 0,  /* Uses tid_bitmap while the bitmaps of the frequent itemsets of a level
+                     * and of the candidates of the next one fit in a memory bound, then
+                     * hash_tree for the remaining levels */
+    hash_tree,      /* Every transaction is passed through a hash tree of the candidates */
+    tid_bitmap      /* Every frequent itemset keeps a bitmap of the transactions containing it,
+                     * the support of a candidate is the popcount of its generators' AND */
+);
+
 }  // namespace algos
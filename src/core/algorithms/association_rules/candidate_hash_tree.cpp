@@ -2,6 +2,9 @@
 
 #include <algorithm>
 #include <cassert>
+#include <numeric>
+
+#include "util/parallel_for.h"
 
 namespace algos {
 
@@ -43,7 +46,7 @@ void CandidateHashTree::AddLevel(HashTreeNode& leaf_node) {
 }
 
 void CandidateHashTree::AddCandidate(NodeIterator candidate, Node* parent) {
-    AppendRow(LeafRow(candidate, parent), root_);
+    AppendRow(LeafRow(candidate, parent, total_row_count_), root_);
     ++total_row_count_;
 }
 
@@ -54,56 +57,90 @@ unsigned CandidateHashTree::HashFunction(LeafRow const& node_row, unsigned level
     return ItemHash(curr_level_element_id);
 }
 
-void CandidateHashTree::FindAndVisitLeaves(HashTreeNode& subtree_root,
-                                           std::vector<unsigned>::const_iterator start,
-                                           std::vector<unsigned> const& transaction_items,
-                                           int tid) {
+void CandidateHashTree::NumberLeaves(HashTreeNode& subtree_root) {
+    if (subtree_root.children.empty()) {
+        subtree_root.leaf_id = num_leaves_++;
+        return;
+    }
+    for (auto& child : subtree_root.children) {
+        NumberLeaves(child);
+    }
+}
+
+void CandidateHashTree::FindAndVisitLeaves(HashTreeNode const& subtree_root, unsigned const* start,
+                                           model::Itemset const& transaction_items,
+                                           size_t position, CountingState& state) const {
     unsigned const next_branch_number = ItemHash(*start);
-    auto& next_node = subtree_root.children[next_branch_number];
+    auto const& next_node = subtree_root.children[next_branch_number];
     if (next_node.children.empty()) {
         // if nextNode is a leaf itself, then we visit it and terminate the recursion
-        VisitLeaf(next_node, transaction_items, tid);
+        VisitLeaf(next_node, transaction_items, position, state);
     } else {
         for (auto new_start = std::next(start); new_start != transaction_items.end(); ++new_start) {
-            FindAndVisitLeaves(next_node, new_start, transaction_items, tid);
+            FindAndVisitLeaves(next_node, new_start, transaction_items, position, state);
         }
     }
 }
 
-void CandidateHashTree::VisitLeaf(HashTreeNode& leaf,
-                                  std::vector<unsigned> const& transaction_items, int tid) {
-    if (leaf.last_visited_transaction_id == tid) { return; }
+void CandidateHashTree::VisitLeaf(HashTreeNode const& leaf,
+                                  model::Itemset const& transaction_items, size_t position,
+                                  CountingState& state) {
+    size_t& last_visit = state.last_visits[leaf.leaf_id];
+    if (last_visit == position + 1) { return; }
 
-    leaf.last_visited_transaction_id = tid;
+    last_visit = position + 1;
 
-    for (auto& row : leaf.candidates) {
+    for (auto const& row : leaf.candidates) {
         auto const& candidate_items = row.candidate_node->items;
         if (std::includes(transaction_items.begin(), transaction_items.end(),
                           candidate_items.begin(), candidate_items.end())) {
-            row.transaction_count++;
+            state.row_counts[row.row_id]++;
         }
     }
 }
 
-void CandidateHashTree::PerformCounting() {
-    for (auto const& transaction : transactional_data_->GetTransactions()) {
-        auto const& items = transaction.second.GetItemsIDs();
-        auto const tid = transaction.first;
-        if (root_.children.empty()) {
-            // if the root is a leaf itself
-            VisitLeaf(root_, items, tid);
-        } else {
-            for (auto start = items.begin(); start != items.end(); ++start) {
-                FindAndVisitLeaves(root_, start, items, tid);
+void CandidateHashTree::PerformCounting(unsigned threads_num) {
+    num_leaves_ = 0;
+    NumberLeaves(root_);
+
+    size_t const num_transactions = transactional_data_->GetNumTransactions();
+    // Every thread counts over its own contiguous part of the transactions
+    std::vector<CountingState> states(
+            std::max<size_t>(1, std::min<size_t>(threads_num, num_transactions)));
+    std::vector<size_t> workers(states.size());
+    std::iota(workers.begin(), workers.end(), 0);
+    auto const count = [this, num_transactions, &states](size_t worker) {
+        CountingState& state = states[worker];
+        state.row_counts.assign(total_row_count_, 0);
+        state.last_visits.assign(num_leaves_, 0);
+        size_t const first = worker * num_transactions / states.size();
+        size_t const last = (worker + 1) * num_transactions / states.size();
+        for (size_t position = first; position != last; ++position) {
+            model::Itemset const items = transactional_data_->GetTransaction(position);
+            if (root_.children.empty()) {
+                // if the root is a leaf itself
+                VisitLeaf(root_, items, position, state);
+            } else {
+                for (auto start = items.begin(); start != items.end(); ++start) {
+                    FindAndVisitLeaves(root_, start, items, position, state);
+                }
             }
         }
+    };
+    util::parallel_foreach(workers.begin(), workers.end(), threads_num, count);
+
+    row_counts_.assign(total_row_count_, 0);
+    for (CountingState const& state : states) {
+        for (unsigned row_id = 0; row_id != total_row_count_; ++row_id) {
+            row_counts_[row_id] += state.row_counts[row_id];
+        }
     }
 }
 
 void CandidateHashTree::Prune(double minsup, HashTreeNode& subtree_root) {
     if (subtree_root.children.empty()) {
         for (auto& row : subtree_root.candidates) {
-            double const support = static_cast<double>(row.transaction_count) /
+            double const support = static_cast<double>(row_counts_[row.row_id]) /
                                    transactional_data_->GetNumTransactions();
             if (support < minsup) {
                 candidates_[row.parent].erase(row.candidate_node);
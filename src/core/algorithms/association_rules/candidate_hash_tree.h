@@ -1,5 +1,9 @@
 #pragma once
 
+#include <list>
+#include <unordered_map>
+#include <vector>
+
 #include "model/transaction/transactional_data.h"
 #include "node.h"
 
@@ -12,6 +16,9 @@ private:
     unsigned const branching_degree_;
     unsigned const min_threshold_;
     unsigned total_row_count_ = 0;
+    unsigned num_leaves_ = 0;
+    // Number of transactions that contain the candidate of each row
+    std::vector<unsigned> row_counts_;
     std::unordered_map<Node*, std::list<Node>>& candidates_;
 
     model::TransactionalData const* const transactional_data_ = nullptr;
@@ -19,19 +26,19 @@ private:
     struct LeafRow {
         NodeIterator candidate_node;
         Node* const parent;
-        unsigned transaction_count = 0;
+        unsigned const row_id;
 
         LeafRow(LeafRow&& other) = default;
         LeafRow& operator=(LeafRow&& other) = delete;
-        LeafRow(NodeIterator node, Node* parent)
-            : candidate_node(node), parent(parent) {}
+        LeafRow(NodeIterator node, Node* parent, unsigned row_id)
+            : candidate_node(node), parent(parent), row_id(row_id) {}
 
         LeafRow(LeafRow const& other) = delete;
     };
 
     struct HashTreeNode {
         unsigned level_number;
-        int last_visited_transaction_id = -1;
+        unsigned leaf_id = 0;
         std::vector<HashTreeNode> children;
         std::list<LeafRow> candidates;
 
@@ -40,16 +47,25 @@ private:
             : level_number(level_number) {}
     };
 
+    // Counters of a thread that counts the support over a part of the transactions
+    struct CountingState {
+        std::vector<unsigned> row_counts;
+        // Position of the last transaction that visited each leaf, plus one
+        std::vector<size_t> last_visits;
+    };
+
     HashTreeNode root_;
     unsigned HashFunction(LeafRow const& node_row, unsigned level_num) const;
     unsigned ItemHash(unsigned item_id) const noexcept { return item_id % branching_degree_; }
 
     void AppendRow(LeafRow row, HashTreeNode& subtree_root);
     void AddLevel(HashTreeNode& leaf_node);
-    void FindAndVisitLeaves(HashTreeNode& subtree_root, std::vector<unsigned>::const_iterator start,
-                            std::vector<unsigned> const& transaction_items, int tid);
-    static void VisitLeaf(HashTreeNode& leaf, std::vector<unsigned> const& transaction_items,
-                          int tid);
+    void NumberLeaves(HashTreeNode& subtree_root);
+    void FindAndVisitLeaves(HashTreeNode const& subtree_root,
+                            unsigned const* start, model::Itemset const& transaction_items,
+                            size_t position, CountingState& state) const;
+    static void VisitLeaf(HashTreeNode const& leaf, model::Itemset const& transaction_items,
+                          size_t position, CountingState& state);
     void Prune(double minsup, HashTreeNode& subtree_root);
     void AddCandidates();
 
@@ -67,7 +83,7 @@ public:
 
     void AddCandidate(NodeIterator candidate, Node* parent);
     unsigned Size() const noexcept { return total_row_count_; };
-    void PerformCounting();
+    void PerformCounting(unsigned threads_num);
     void PruneNodes(double minsup);
 };
 
@@ -0,0 +1,252 @@
+#include "algorithms/association_rules/fp_growth.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <numeric>
+
+#include <easylogging++.h>
+
+namespace {
+
+// Items of an FP-tree are numbered so that a more frequent item has a smaller id, paths of the
+// tree list the ids in increasing order
+using ItemId = unsigned;
+using NodeId = unsigned;
+
+struct WeightedPath {
+    std::vector<ItemId> items;
+    size_t count;
+
+    bool operator<(WeightedPath const& other) const {
+        return items < other.items;
+    }
+};
+
+// FP-tree stored in flat arrays. Node 0 is the root, the nodes of every item are kept together, so
+// the tree has no header table of linked lists.
+class FPTree {
+private:
+    // Transaction item of every id
+    std::vector<unsigned> labels_;
+    std::vector<ItemId> node_items_;
+    std::vector<NodeId> parents_;
+    std::vector<size_t> counts_;
+    // Nodes of the item with id i are nodes_by_item_[item_begins_[i]..item_begins_[i + 1])
+    std::vector<NodeId> nodes_by_item_;
+    std::vector<size_t> item_begins_;
+
+public:
+    // Paths must be sorted, so every path shares its common prefix with the path inserted before
+    // it, and the nodes of that prefix are still on the stack
+    FPTree(std::vector<WeightedPath> const& paths, std::vector<unsigned> labels)
+        : labels_(std::move(labels)), node_items_(1), parents_(1, 0), counts_(1, 0) {
+        assert(std::is_sorted(paths.begin(), paths.end()));
+        std::vector<NodeId> path_nodes{0};
+        std::vector<ItemId> const* previous = nullptr;
+        for (auto const& [items, count] : paths) {
+            size_t common = 0;
+            if (previous != nullptr) {
+                size_t const max_common = std::min(items.size(), previous->size());
+                while (common != max_common && items[common] == (*previous)[common]) {
+                    ++common;
+                }
+            }
+            path_nodes.resize(common + 1);
+            for (size_t depth = 1; depth <= common; ++depth) {
+                counts_[path_nodes[depth]] += count;
+            }
+            for (size_t i = common; i != items.size(); ++i) {
+                NodeId const node = node_items_.size();
+                node_items_.push_back(items[i]);
+                parents_.push_back(path_nodes.back());
+                counts_.push_back(count);
+                path_nodes.push_back(node);
+            }
+            previous = &items;
+        }
+
+        item_begins_.assign(labels_.size() + 1, 0);
+        for (NodeId node = 1; node != node_items_.size(); ++node) {
+            ++item_begins_[node_items_[node] + 1];
+        }
+        std::partial_sum(item_begins_.begin(), item_begins_.end(), item_begins_.begin());
+        nodes_by_item_.resize(node_items_.size() - 1);
+        std::vector<size_t> positions(item_begins_.begin(), std::prev(item_begins_.end()));
+        for (NodeId node = 1; node != node_items_.size(); ++node) {
+            nodes_by_item_[positions[node_items_[node]]++] = node;
+        }
+    }
+
+    size_t GetNumItems() const noexcept {
+        return labels_.size();
+    }
+
+    unsigned GetLabel(ItemId item) const noexcept {
+        return labels_[item];
+    }
+
+    size_t GetCount(ItemId item) const noexcept {
+        size_t count = 0;
+        for (size_t i = item_begins_[item]; i != item_begins_[item + 1]; ++i) {
+            count += counts_[nodes_by_item_[i]];
+        }
+        return count;
+    }
+
+    // Builds the tree of the prefixes that precede the item in this tree, keeping only the items
+    // that satisfy is_frequent there
+    template <typename IsFrequent>
+    FPTree BuildConditional(ItemId item, IsFrequent const& is_frequent) const {
+        std::vector<size_t> prefix_counts(item, 0);
+        for (size_t i = item_begins_[item]; i != item_begins_[item + 1]; ++i) {
+            NodeId const node = nodes_by_item_[i];
+            for (NodeId ancestor = parents_[node]; ancestor != 0; ancestor = parents_[ancestor]) {
+                prefix_counts[node_items_[ancestor]] += counts_[node];
+            }
+        }
+
+        // Ids of the conditional tree keep the order of the ids of this one
+        ItemId const kNoItem = item;
+        std::vector<ItemId> conditional_ids(item, kNoItem);
+        std::vector<unsigned> conditional_labels;
+        for (ItemId prefix_item = 0; prefix_item != item; ++prefix_item) {
+            if (is_frequent(prefix_counts[prefix_item])) {
+                conditional_ids[prefix_item] = conditional_labels.size();
+                conditional_labels.push_back(labels_[prefix_item]);
+            }
+        }
+
+        std::vector<WeightedPath> paths;
+        if (!conditional_labels.empty()) {
+            for (size_t i = item_begins_[item]; i != item_begins_[item + 1]; ++i) {
+                NodeId const node = nodes_by_item_[i];
+                WeightedPath path{{}, counts_[node]};
+                for (NodeId ancestor = parents_[node]; ancestor != 0;
+                     ancestor = parents_[ancestor]) {
+                    ItemId const conditional_id = conditional_ids[node_items_[ancestor]];
+                    if (conditional_id != kNoItem) {
+                        path.items.push_back(conditional_id);
+                    }
+                }
+                if (!path.items.empty()) {
+                    std::reverse(path.items.begin(), path.items.end());
+                    paths.push_back(std::move(path));
+                }
+            }
+            std::sort(paths.begin(), paths.end());
+        }
+        return FPTree(paths, std::move(conditional_labels));
+    }
+};
+
+// Reports every frequent itemset that consists of suffix and the items of the tree
+template <typename IsFrequent, typename Report>
+void Mine(FPTree const& tree, std::vector<unsigned>& suffix, IsFrequent const& is_frequent,
+          Report const& report) {
+    for (ItemId item = 0; item != tree.GetNumItems(); ++item) {
+        suffix.push_back(tree.GetLabel(item));
+        report(suffix, tree.GetCount(item));
+        if (item != 0) {
+            FPTree const conditional_tree = tree.BuildConditional(item, is_frequent);
+            Mine(conditional_tree, suffix, is_frequent, report);
+        }
+        suffix.pop_back();
+    }
+}
+
+}  // namespace
+
+namespace algos {
+
+FPGrowth::FPGrowth() : ARAlgorithm({}) {}
+
+void FPGrowth::ResetStateAr() {
+    root_ = Node();
+}
+
+unsigned long long FPGrowth::FindFrequent() {
+    auto start_time = std::chrono::system_clock::now();
+
+    auto const is_frequent = [this](size_t count) {
+        return count != 0 && GetSupportOf(count) >= minsup_;
+    };
+
+    std::vector<size_t> const item_counts = CountItems();
+    std::vector<unsigned> frequent_items;
+    for (unsigned item = 0; item != item_counts.size(); ++item) {
+        if (is_frequent(item_counts[item])) {
+            frequent_items.push_back(item);
+        }
+    }
+    std::stable_sort(frequent_items.begin(), frequent_items.end(),
+                     [&item_counts](unsigned left, unsigned right) {
+                         return item_counts[left] > item_counts[right];
+                     });
+    std::vector<ItemId> item_ids(item_counts.size(), frequent_items.size());
+    for (ItemId id = 0; id != frequent_items.size(); ++id) {
+        item_ids[frequent_items[id]] = id;
+    }
+
+    std::vector<WeightedPath> paths;
+    paths.reserve(transactional_data_->GetNumTransactions());
+    for (size_t position = 0; position != transactional_data_->GetNumTransactions(); ++position) {
+        WeightedPath path{{}, 1};
+        for (unsigned item : transactional_data_->GetTransaction(position)) {
+            if (item_ids[item] != frequent_items.size()) {
+                path.items.push_back(item_ids[item]);
+            }
+        }
+        std::sort(path.items.begin(), path.items.end());
+        path.items.erase(std::unique(path.items.begin(), path.items.end()), path.items.end());
+        if (!path.items.empty()) {
+            paths.push_back(std::move(path));
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    FPTree const tree(paths, frequent_items);
+    paths = std::vector<WeightedPath>();
+
+    std::vector<FrequentItemset> frequent_itemsets;
+    std::vector<unsigned> suffix;
+    auto const report = [this, &frequent_itemsets](std::vector<unsigned> const& items,
+                                                   size_t count) {
+        std::vector<unsigned> itemset = items;
+        std::sort(itemset.begin(), itemset.end());
+        frequent_itemsets.emplace_back(std::move(itemset), GetSupportOf(count));
+    };
+    Mine(tree, suffix, is_frequent, report);
+    BuildItemsetTree(std::move(frequent_itemsets));
+
+    auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now() - start_time);
+    return elapsed_milliseconds.count();
+}
+
+void FPGrowth::BuildItemsetTree(std::vector<FrequentItemset> frequent_itemsets) {
+    std::sort(frequent_itemsets.begin(), frequent_itemsets.end());
+    // In the sorted order every itemset comes after its prefix and after the itemsets that extend
+    // its prefix with smaller items, so its parent is always on the path to the previous itemset
+    std::vector<Node*> path{&root_};
+    for (auto& [items, support] : frequent_itemsets) {
+        path.resize(items.size());
+        Node& node = path.back()->children.emplace_back(std::move(items));
+        node.support = support;
+        path.push_back(&node);
+    }
+}
+
+unsigned long long FPGrowth::GenerateAllRules() {
+    return GenerateAllRulesFrom(root_);
+}
+
+std::list<std::set<std::string>> FPGrowth::GetFrequentList() const {
+    return GetFrequentListFrom(root_);
+}
+
+double FPGrowth::GetSupport(std::vector<unsigned> const& frequent_itemset) const {
+    return GetSupportFrom(root_, frequent_itemset);
+}
+
+}  // namespace algos
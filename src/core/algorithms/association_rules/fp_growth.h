@@ -0,0 +1,39 @@
+#pragma once
+
+#include <list>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "algorithms/association_rules/node.h"
+#include "ar_algorithm.h"
+
+namespace algos {
+
+// Mines the frequent itemsets without candidate generation: the frequent items of every
+// transaction are compressed into a prefix tree, which is then mined recursively by building
+// trees of the prefixes that precede each item. The data is read twice regardless of the itemset
+// lengths.
+class FPGrowth : public ARAlgorithm {
+private:
+    using FrequentItemset = std::pair<std::vector<unsigned>, double>;
+
+    Node root_;
+
+    // Stores the itemsets in root_, every prefix of an itemset must be among them as well
+    void BuildItemsetTree(std::vector<FrequentItemset> frequent_itemsets);
+
+    double GetSupport(std::vector<unsigned> const& frequent_itemset) const override;
+    unsigned long long GenerateAllRules() override;
+    unsigned long long FindFrequent() override;
+
+    void ResetStateAr() final;
+
+public:
+    FPGrowth();
+
+    std::list<std::set<std::string>> GetFrequentList() const override;
+};
+
+}  // namespace algos
@@ -3,12 +3,17 @@
 #include <list>
 #include <vector>
 
+#include <boost/dynamic_bitset.hpp>
+
 namespace algos {
 
 struct Node {
     std::vector<unsigned> items;
     double support = 0;
     std::vector<Node> children;
+    // Positions of the transactions that contain the items. Only filled when the support is
+    // counted with tid bitmaps, and only until the next level of candidates is generated
+    boost::dynamic_bitset<> tids;
 
     Node() = default;
     Node(Node&& other) = default;
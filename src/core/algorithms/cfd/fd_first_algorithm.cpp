@@ -1,6 +1,8 @@
 #include "fd_first_algorithm.h"
 
+#include <atomic>
 #include <iterator>
+#include <numeric>
 
 #include <boost/unordered_map.hpp>
 #include <easylogging++.h>
@@ -13,6 +15,8 @@
 #include "config/exceptions.h"
 #include "config/names_and_descriptions.h"
 #include "config/option_using.h"
+#include "config/thread_number/option.h"
+#include "util/parallel_for.h"
 
 // see algorithms/cfd/LICENSE
 
@@ -30,6 +34,7 @@ void FDFirstAlgorithm::RegisterOptions() {
     RegisterOption(Option{&min_conf_, kCfdMinimumConfidence, kDCfdMinimumConfidence, 0.0});
     RegisterOption(Option{&max_lhs_, kCfdMaximumLhs, kDCfdMaximumLhs, 0u});
     RegisterOption(Option{&substrategy_, kCfdSubstrategy, kDCfdSubstrategy, default_val});
+    RegisterOption(config::ThreadNumberOpt(&threads_num_));
 }
 
 void FDFirstAlgorithm::ResetStateCFD() {
@@ -39,6 +44,9 @@ void FDFirstAlgorithm::ResetStateCFD() {
     free_map_.clear();
     free_itemsets_.clear();
     rules_.clear();
+    tid_tables_.clear();
+    mining_tasks_.clear();
+    mining_partitions_.clear();
 }
 
 unsigned long long FDFirstAlgorithm::ExecuteInternal() {
@@ -93,8 +101,8 @@ void FDFirstAlgorithm::CheckForIncorrectInput() const {
 void FDFirstAlgorithm::MakeExecuteOptsAvailable() {
     using namespace config::names;
 
-    MakeOptionsAvailable(
-            {kCfdMinimumSupport, kCfdMinimumConfidence, kCfdMaximumLhs, kCfdSubstrategy});
+    MakeOptionsAvailable({kCfdMinimumSupport, kCfdMinimumConfidence, kCfdMaximumLhs,
+                          kCfdSubstrategy, config::ThreadNumberOpt.GetName()});
 }
 
 bool FDFirstAlgorithm::Precedes(const Itemset& a, const Itemset& b) {
@@ -117,7 +125,7 @@ bool FDFirstAlgorithm::Precedes(const Itemset& a, const Itemset& b) {
     return true;
 }
 
-bool FDFirstAlgorithm::IsConstRule(const PartitionTIdList& items, int rhs_a) {
+bool FDFirstAlgorithm::IsConstRule(const PartitionTIdList& items, int rhs_a) const {
     int rhs_value;
     bool first = true;
     for (size_t pos_index = 0; pos_index <= items.tids.size(); pos_index++) {
@@ -136,13 +144,22 @@ bool FDFirstAlgorithm::IsConstRule(const PartitionTIdList& items, int rhs_a) {
     return true;
 }
 
-void FDFirstAlgorithm::MineFD(const MinerNode<PartitionTIdList>& inode, const Itemset& lhs,
-                              int rhs) {
-    if (inode.tids.sets_number == 1 || IsConstRule(inode.tids, -1 - rhs)) return;
+void FDFirstAlgorithm::MineFD(const PartitionTIdList& tids, const Itemset& lhs, int rhs,
+                              std::vector<unsigned>& tid_table,
+                              std::vector<Discovery>& discoveries) const {
+    if (tids.sets_number == 1 || IsConstRule(tids, -1 - rhs)) return;
     const auto stored_sub = store_.find(lhs);
     if (stored_sub == store_.end()) {
         return;
     }
+    // Here the confidence computing method from the paper is used
+    double e = stored_sub->second.PartitionError(tids, tid_table);
+    double conf = 1 - (e / TIdUtil::Support(stored_sub->second));
+    discoveries.emplace_back(FoundFD{lhs, rhs, conf});
+}
+
+void FDFirstAlgorithm::AddFD(const FoundFD& fd) {
+    const auto& [lhs, rhs, conf] = fd;
     bool lhs_gen = true;
     if (free_itemsets_.find(lhs) == free_itemsets_.end()) {
         lhs_gen = false;
@@ -158,9 +175,6 @@ void FDFirstAlgorithm::MineFD(const MinerNode<PartitionTIdList>& inode, const It
         }
     }
     if (lhs_gen) {
-        // Here the confidence computing method from the paper is used
-        double e = stored_sub->second.PartitionError(inode.tids);
-        double conf = 1 - (e / TIdUtil::Support(stored_sub->second));
         if (conf >= min_conf_) {
             cfd_list_.emplace_back(lhs, rhs);
         }
@@ -170,9 +184,62 @@ void FDFirstAlgorithm::MineFD(const MinerNode<PartitionTIdList>& inode, const It
     }
 }
 
+void FDFirstAlgorithm::AddFreeItemset(const FreeItemset& free_itemset) {
+    const auto& [itemset, sp] = free_itemset;
+    const auto free_map_elem = free_map_.find(sp);
+    if (free_map_elem != free_map_.end()) {
+        for (const auto& sub_cand : free_map_elem->second) {
+            if (IsSubsetOf(sub_cand, itemset)) {
+                return;
+            }
+        }
+    }
+    free_map_[sp].push_back(itemset);
+    free_itemsets_.insert(itemset);
+}
+
+void FDFirstAlgorithm::MineCandidates() {
+    // Tasks are handed out one by one, as the time pattern mining takes varies a lot
+    std::atomic<size_t> next_task = 0;
+    std::vector<size_t> workers(std::min<size_t>(threads_num_, mining_tasks_.size()));
+    std::iota(workers.begin(), workers.end(), 0);
+    auto const mine = [this, &next_task](size_t worker) {
+        for (size_t task_index = next_task++; task_index < mining_tasks_.size();
+             task_index = next_task++) {
+            MiningTask& task = mining_tasks_[task_index];
+            if (task.partition == MiningTask::kNoPartition) {
+                continue;
+            }
+            const PartitionTIdList& tids = mining_partitions_[task.partition];
+            MineFD(tids, task.lhs, task.rhs, tid_tables_[worker], task.discoveries);
+            if (substrategy_ == +Substrategy::dfs) {
+                MinePatternsDFS(task.lhs, task.rhs, tids, task.discoveries);
+            } else if (substrategy_ == +Substrategy::bfs) {
+                MinePatternsBFS(task.lhs, task.rhs, tids, task.discoveries);
+            }
+        }
+    };
+    util::parallel_foreach(workers.begin(), workers.end(), threads_num_, mine);
+
+    for (const MiningTask& task : mining_tasks_) {
+        for (const Discovery& discovery : task.discoveries) {
+            if (const auto* fd = std::get_if<FoundFD>(&discovery)) {
+                AddFD(*fd);
+            } else if (const auto* cfd = std::get_if<FoundCFD>(&discovery)) {
+                AddCFD(*cfd);
+            } else {
+                AddFreeItemset(std::get<FreeItemset>(discovery));
+            }
+        }
+    }
+    mining_tasks_.clear();
+    mining_partitions_.clear();
+}
+
 // Initializing all objects that will be used in algorithm
 void FDFirstAlgorithm::FdsFirstDFS() {
     all_attrs_ = Range(-static_cast<int>(relation_->GetAttrsNumber()), 0);
+    tid_tables_.assign(threads_num_, std::vector<unsigned>(relation_->Size(), 0));
     PIdListMiners items = GetPartitionSingletons();
     for (auto& a : items) {
         a.candidates = all_attrs_;
@@ -183,7 +250,8 @@ void FDFirstAlgorithm::FdsFirstDFS() {
     cand_store_ = PrefixTree<Itemset, Itemset>();
     store_[Itemset()] = PartitionTIdList(Iota(relation_->Size()));
     cand_store_.Insert(Itemset(), all_attrs_);
-    FdsFirstDFS(Itemset(), items, substrategy_);
+    FdsFirstDFS(Itemset(), items);
+    MineCandidates();
 }
 
 std::pair<std::vector<const PartitionTIdList*>, FDFirstAlgorithm::PIdListMiners>
@@ -220,20 +288,19 @@ FDFirstAlgorithm::ExpandMiningFd(const MinerNode<PartitionTIdList>& inode, int i
     return {expands, tmp_suffix};
 }
 
-void FDFirstAlgorithm::FdsFirstDFS(const Itemset& prefix, const PIdListMiners& items,
-                                   Substrategy ss) {
+void FDFirstAlgorithm::FdsFirstDFS(const Itemset& prefix, const PIdListMiners& items) {
     for (int ix = static_cast<int>(items.size()) - 1; ix >= 0; ix--) {
         const MinerNode<PartitionTIdList>& inode = items[ix];
         const Itemset iset = Join(prefix, inode.item);
         const auto insect = ConstructIntersection(iset, inode.candidates);
-        for (int out : insect) {
-            const Itemset sub = ConstructSubset(iset, out);
-            MineFD(inode, sub, out);
-
-            if (ss == +Substrategy::dfs) {
-                MinePatternsDFS(sub, out, inode.tids);
-            } else if (ss == +Substrategy::bfs) {
-                MinePatternsBFS(sub, out, inode.tids);
+        if (!insect.empty()) {
+            for (int out : insect) {
+                mining_tasks_.push_back(
+                        {mining_partitions_.size(), ConstructSubset(iset, out), out, {}});
+            }
+            mining_partitions_.push_back(inode.tids);
+            if (mining_partitions_.size() >= kMiningPartitionsPerThread * threads_num_) {
+                MineCandidates();
             }
         }
 
@@ -244,26 +311,18 @@ void FDFirstAlgorithm::FdsFirstDFS(const Itemset& prefix, const PIdListMiners& i
 
         const auto [expands, tmp_suffix] = ExpandMiningFd(inode, ix, iset, items);
 
-        const auto exps = PartitionTIdListUtil::ConstructIntersection(items[ix].tids, expands);
+        // The search itself runs on the first table, the tasks are not mined meanwhile
+        const auto exps = PartitionTIdListUtil::ConstructIntersection(items[ix].tids, expands,
+                                                                      tid_tables_.front());
+        // Free itemsets of the search are added in turn with the discoveries of the tasks
+        MiningTask& search_task =
+                mining_tasks_.emplace_back(MiningTask{MiningTask::kNoPartition, {}, 0, {}});
         PIdListMiners suffix;
         for (size_t e = 0; e < exps.size(); e++) {
-            bool gen = true;
             const auto new_set = Join(tmp_suffix[e].prefix, tmp_suffix[e].item);
-            const auto sp = std::make_pair(TIdUtil::Support(exps[e]), exps[e].sets_number);
-            const auto free_map_elem = free_map_.find(sp);
-            if (free_map_elem != free_map_.end()) {
-                const auto free_cands = free_map_elem->second;
-                for (const auto& sub_cand : free_cands) {
-                    if (IsSubsetOf(sub_cand, new_set)) {
-                        gen = false;
-                        break;
-                    }
-                }
-            }
-            if (gen) {
-                free_map_[sp].push_back(new_set);
-                free_itemsets_.insert(new_set);
-            }
+            const auto sp = std::make_pair(TIdUtil::Support(exps[e]),
+                                           static_cast<int>(exps[e].sets_number));
+            search_task.discoveries.emplace_back(FreeItemset{new_set, sp});
             auto new_node = MinerNode<PartitionTIdList>(tmp_suffix[e].item, exps[e]);
             new_node.candidates = tmp_suffix[e].candidates;
             new_node.prefix = tmp_suffix[e].prefix;
@@ -273,7 +332,7 @@ void FDFirstAlgorithm::FdsFirstDFS(const Itemset& prefix, const PIdListMiners& i
             std::sort(suffix.begin(), suffix.end(), [](const auto& a, const auto& b) {
                 return a.tids.sets_number < b.tids.sets_number;
             });
-            FdsFirstDFS(iset, suffix, ss);
+            FdsFirstDFS(iset, suffix);
         }
     }
 }
@@ -309,9 +368,17 @@ void FDFirstAlgorithm::FillMinePatternsVars(PartitionList& partitions, RhsesPair
     }
 }
 
-void FDFirstAlgorithm::AddCFDToCFDList(const std::vector<int>& sub, int out,
-                                       const MinerNode<SimpleTIdList>& inode,
-                                       const PartitionList& partitions) {
+void FDFirstAlgorithm::RecordCFD(const std::vector<int>& sub, int out,
+                                 const MinerNode<SimpleTIdList>& inode,
+                                 const PartitionList& partitions,
+                                 std::vector<Discovery>& discoveries) const {
+    unsigned e = PartitionUtil::GetPartitionError(inode.tids, partitions);
+    double conf = 1.0 - (static_cast<double>(e) / static_cast<double>(inode.node_supp));
+    discoveries.emplace_back(FoundCFD{sub, out, conf});
+}
+
+void FDFirstAlgorithm::AddCFD(const FoundCFD& cfd) {
+    const auto& [sub, out, conf] = cfd;
     bool lhs_gen = true;
 
     if (rules_.find(out) != rules_.end()) {
@@ -325,8 +392,6 @@ void FDFirstAlgorithm::AddCFDToCFDList(const std::vector<int>& sub, int out,
         }
     }
     if (lhs_gen) {
-        unsigned e = PartitionUtil::GetPartitionError(inode.tids, partitions);
-        double conf = 1.0 - (static_cast<double>(e) / static_cast<double>(inode.node_supp));
         if (conf >= min_conf_) {
             cfd_list_.emplace_back(sub, out);
         }
@@ -340,72 +405,39 @@ void FDFirstAlgorithm::AddCFDToCFDList(const std::vector<int>& sub, int out,
 }
 
 void FDFirstAlgorithm::AnalyzeCFDFromPIdList(const std::pair<int, SimpleTIdList>& item,
-                                             const PartitionList& partitions,
                                              const std::vector<unsigned>& p_supps,
-                                             TIdListMiners& items, const Itemset& lhs) {
+                                             TIdListMiners& items, const Itemset& lhs,
+                                             std::vector<Discovery>& discoveries) const {
     unsigned p_supp = PartitionUtil::GetPartitionSupport(item.second, p_supps);
     if (p_supp < min_supp_) {
         return;
     }
     const Itemset ns = Join(Itemset{item.first},
                             ConstructSubset(lhs, -1 - relation_->GetAttrIndex(item.first)));
-    std::set<Itemset> nr_parts;
-    for (int pid : item.second) {
-        nr_parts.insert(partitions[pid].first);
-    }
-    bool gen = true;
-    const auto sp = std::make_pair(p_supp, nr_parts.size());
-    const auto free_map_pair = free_map_.find(sp);
-    if (free_map_pair != free_map_.end()) {
-        const auto free_cands = free_map_pair->second;
-        for (const auto& sub_cand : free_cands) {
-            if (IsSubsetOf(sub_cand, ns)) {
-                gen = false;
-                break;
-            }
-        }
-    }
-    if (gen) {
-        free_map_[sp].push_back(ns);
-        free_itemsets_.insert(ns);
-    }
+    // Every partition has its own lhs constants, so the pids are the distinct patterns
+    const auto sp = std::make_pair(static_cast<int>(p_supp), static_cast<int>(item.second.size()));
+    discoveries.emplace_back(FreeItemset{ns, sp});
     items.emplace_back(item.first, item.second, p_supp);
 }
 
-bool FDFirstAlgorithm::FillFreeMapAndItemsets(const PartitionList& partitions, const Itemset& lhs,
-                                              const Itemset& new_set, const SimpleTIdList& ij_tids,
-                                              unsigned ij_supp) {
+bool FDFirstAlgorithm::RecordFreeItemset(const Itemset& lhs, const Itemset& new_set,
+                                         const SimpleTIdList& ij_tids, unsigned ij_supp,
+                                         std::vector<Discovery>& discoveries) const {
     if (ij_supp < min_supp_) {
         return false;
     }
 
-    bool gen = true;
     const auto nas = relation_->GetAttrVectorItems(new_set);
     const Itemset ns = Join(new_set, SetDiff(lhs, nas));
-    std::set<Itemset> nr_parts;
-    for (int pid : ij_tids) {
-        nr_parts.insert(partitions[pid].first);
-    }
-    const auto sp = std::make_pair(ij_supp, nr_parts.size());
-    const auto free_map_pair = free_map_.find(sp);
-    if (free_map_pair != free_map_.end()) {
-        const auto free_cands = free_map_pair->second;
-        for (const auto& sub_cand : free_cands) {
-            if (IsSubsetOf(sub_cand, ns)) {
-                gen = false;
-                break;
-            }
-        }
-    }
-    if (gen) {
-        free_map_[sp].push_back(ns);
-        free_itemsets_.insert(ns);
-    }
+    // Every partition has its own lhs constants, so the pids are the distinct patterns
+    const auto sp = std::make_pair(static_cast<int>(ij_supp), static_cast<int>(ij_tids.size()));
+    discoveries.emplace_back(FreeItemset{ns, sp});
     return true;
 }
 
 void FDFirstAlgorithm::MinePatternsBFS(const Itemset& lhs, int rhs,
-                                       const PartitionTIdList& all_tids) {
+                                       const PartitionTIdList& all_tids,
+                                       std::vector<Discovery>& discoveries) const {
     std::map<int, SimpleTIdList> pid_lists;
     PartitionList partitions;
     RhsesPair2DList rhses_pairs;
@@ -425,7 +457,7 @@ void FDFirstAlgorithm::MinePatternsBFS(const Itemset& lhs, int rhs,
     }
 
     for (const auto& item : pid_lists) {
-        AnalyzeCFDFromPIdList(item, partitions, p_supps, items, lhs);
+        AnalyzeCFDFromPIdList(item, p_supps, items, lhs, discoveries);
     }
 
     while (!items.empty()) {
@@ -439,7 +471,7 @@ void FDFirstAlgorithm::MinePatternsBFS(const Itemset& lhs, int rhs,
             const auto sub = Join(iset, SetDiff(lhs, node_attrs));
 
             if (out > 0 || !PartitionUtil::IsConstRulePartition(inode.tids, rhses_pairs)) {
-                AddCFDToCFDList(sub, out, inode, partitions);
+                RecordCFD(sub, out, inode, partitions, discoveries);
             }
             for (size_t j = i + 1; j < items.size(); j++) {
                 const auto& jnode = items[j];
@@ -452,7 +484,7 @@ void FDFirstAlgorithm::MinePatternsBFS(const Itemset& lhs, int rhs,
                 Itemset new_set = Join(jset, inode.item);
                 SimpleTIdList ij_tids = ConstructIntersection(inode.tids, jnode.tids);
                 unsigned ij_supp = PartitionUtil::GetPartitionSupport(ij_tids, p_supps);
-                bool result = FillFreeMapAndItemsets(partitions, lhs, new_set, ij_tids, ij_supp);
+                bool result = RecordFreeItemset(lhs, new_set, ij_tids, ij_supp, discoveries);
                 if (!result) continue;
                 int jtem = new_set.back();
                 new_set.pop_back();
@@ -464,7 +496,8 @@ void FDFirstAlgorithm::MinePatternsBFS(const Itemset& lhs, int rhs,
 }
 
 void FDFirstAlgorithm::MinePatternsDFS(const Itemset& lhs, int rhs,
-                                       const PartitionTIdList& all_tids) {
+                                       const PartitionTIdList& all_tids,
+                                       std::vector<Discovery>& discoveries) const {
     std::map<int, SimpleTIdList> pid_lists;
     PartitionList partitions;
     RhsesPair2DList rhses_pairs;
@@ -484,15 +517,16 @@ void FDFirstAlgorithm::MinePatternsDFS(const Itemset& lhs, int rhs,
     }
 
     for (const auto& item : pid_lists) {
-        AnalyzeCFDFromPIdList(item, partitions, p_supps, items, lhs);
+        AnalyzeCFDFromPIdList(item, p_supps, items, lhs, discoveries);
     }
 
-    MinePatternsDFS(Itemset(), items, lhs, rhs, rhses_pairs, partitions, p_supps);
+    MinePatternsDFS(Itemset(), items, lhs, rhs, rhses_pairs, partitions, p_supps, discoveries);
 }
 
 void FDFirstAlgorithm::MinePatternsDFS(const Itemset& prefix, TIdListMiners& items,
                                        const Itemset& lhs, int rhs, RhsesPair2DList& rhses_pair,
-                                       PartitionList& partitions, std::vector<unsigned>& psupps) {
+                                       PartitionList& partitions, std::vector<unsigned>& psupps,
+                                       std::vector<Discovery>& discoveries) const {
     for (int ix = static_cast<int>(items.size()) - 1; ix >= 0; ix--) {
         const auto& inode = items[ix];
         if (inode.tids.empty() && items[ix].tids.empty()) {
@@ -504,7 +538,7 @@ void FDFirstAlgorithm::MinePatternsDFS(const Itemset& prefix, TIdListMiners& ite
         const auto sub = Join(iset, SetDiff(lhs, node_attrs));
 
         if (out > 0 || !PartitionUtil::IsConstRulePartition(inode.tids, rhses_pair)) {
-            AddCFDToCFDList(sub, out, inode, partitions);
+            RecordCFD(sub, out, inode, partitions, discoveries);
         }
         TIdListMiners suffix;
         for (size_t j = ix + 1; j < items.size(); j++) {
@@ -516,7 +550,7 @@ void FDFirstAlgorithm::MinePatternsDFS(const Itemset& prefix, TIdListMiners& ite
             SimpleTIdList ij_tids = ConstructIntersection(inode.tids, jnode.tids);
             unsigned ij_supp = PartitionUtil::GetPartitionSupport(ij_tids, psupps);
 
-            bool result = FillFreeMapAndItemsets(partitions, lhs, new_set, ij_tids, ij_supp);
+            bool result = RecordFreeItemset(lhs, new_set, ij_tids, ij_supp, discoveries);
             if (!result) continue;
             suffix.emplace_back(jnode.item, ij_tids, ij_supp);
         }
@@ -524,7 +558,7 @@ void FDFirstAlgorithm::MinePatternsDFS(const Itemset& prefix, TIdListMiners& ite
             std::sort(suffix.begin(), suffix.end(), [](const auto& a, const auto& b) {
                 return TIdUtil::Support(a.tids) < TIdUtil::Support(b.tids);
             });
-            MinePatternsDFS(iset, suffix, lhs, rhs, rhses_pair, partitions, psupps);
+            MinePatternsDFS(iset, suffix, lhs, rhs, rhses_pair, partitions, psupps, discoveries);
         }
     }
 }
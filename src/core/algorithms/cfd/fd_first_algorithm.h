@@ -1,8 +1,12 @@
 #pragma once
 
+#include <limits>
+#include <variant>
+
 #include "algorithms/cfd/model/partition_tidlist.h"
 #include "algorithms/cfd/util/prefix_tree.h"
 #include "cfd_discovery.h"
+#include "config/thread_number/type.h"
 #include "enums.h"
 #include "miner_node.h"
 
@@ -14,12 +18,46 @@ class FDFirstAlgorithm : public algos::cfd::CFDDiscovery {
     using PIdListMiners = std::vector<MinerNode<PartitionTIdList>>;
     using TIdListMiners = std::vector<MinerNode<SimpleTIdList>>;
 
+    // What the mining finds is recorded by the threads and applied to the shared state (free
+    // itemsets, rules and the CFD list) afterwards, in the order of the sequential algorithm
+    struct FreeItemset {
+        Itemset itemset;
+        // Support and the number of partitions
+        std::pair<int, int> sp;
+    };
+    struct FoundFD {
+        Itemset lhs;
+        int rhs;
+        double conf;
+    };
+    struct FoundCFD {
+        Itemset lhs;
+        int rhs;
+        double conf;
+    };
+    using Discovery = std::variant<FreeItemset, FoundFD, FoundCFD>;
+
+    // Mining of the FD with the given lhs and rhs and of its patterns. The search for the
+    // candidate FDs does not depend on their mining, so the tasks are collected and run in batches.
+    struct MiningTask {
+        static constexpr size_t kNoPartition = std::numeric_limits<size_t>::max();
+
+        // Index of the partition of lhs and rhs in mining_partitions_, none for a task that only
+        // holds the free itemsets found by the search
+        size_t partition;
+        Itemset lhs;
+        int rhs;
+        std::vector<Discovery> discoveries;
+    };
+    static constexpr size_t kMiningPartitionsPerThread = 4;
+
 private:
     unsigned min_supp_;
     unsigned max_cfd_size_;
     unsigned max_lhs_;
     double min_conf_;
     Substrategy substrategy_ = Substrategy::dfs;
+    config::ThreadNumType threads_num_ = 1;
 
     std::map<Itemset, PartitionTIdList> store_;
     PrefixTree<Itemset, Itemset> cand_store_;
@@ -27,23 +65,35 @@ private:
     std::map<std::pair<int, int>, std::vector<Itemset>> free_map_;
     std::set<Itemset> free_itemsets_;
     std::unordered_map<int, std::vector<Itemset>> rules_;
+    // Tables indexed by tids, one per thread, filled with zeros between the partition
+    // intersections that use them
+    std::vector<std::vector<unsigned>> tid_tables_;
+    std::vector<MiningTask> mining_tasks_;
+    std::vector<PartitionTIdList> mining_partitions_;
 
     void ResetStateCFD() final;
     void CheckForIncorrectInput() const;
 
     void FdsFirstDFS();
-    void FdsFirstDFS(const Itemset &, const std::vector<MinerNode<PartitionTIdList>> &,
-                     Substrategy = Substrategy::dfs);
-    void MinePatternsBFS(const Itemset &lhs, int rhs, const PartitionTIdList &all_tids);
-    void MinePatternsDFS(const Itemset &lhs, int rhs, const PartitionTIdList &all_tids);
+    void FdsFirstDFS(const Itemset &, const std::vector<MinerNode<PartitionTIdList>> &);
+    void MineCandidates();
+    void MinePatternsBFS(const Itemset &lhs, int rhs, const PartitionTIdList &all_tids,
+                         std::vector<Discovery> &discoveries) const;
+    void MinePatternsDFS(const Itemset &lhs, int rhs, const PartitionTIdList &all_tids,
+                         std::vector<Discovery> &discoveries) const;
     void MinePatternsDFS(const Itemset &, std::vector<MinerNode<SimpleTIdList>> &, const Itemset &,
-                         int, RhsesPair2DList &, PartitionList &, std::vector<unsigned> &);
+                         int, RhsesPair2DList &, PartitionList &, std::vector<unsigned> &,
+                         std::vector<Discovery> &) const;
     std::vector<MinerNode<PartitionTIdList>> GetPartitionSingletons();
 
     bool Precedes(const Itemset &a, const Itemset &b);
-    bool IsConstRule(const PartitionTIdList &items, int rhs_a);
+    bool IsConstRule(const PartitionTIdList &items, int rhs_a) const;
 
-    void MineFD(const MinerNode<PartitionTIdList> &inode, const Itemset &lhs, int rhs);
+    void MineFD(const PartitionTIdList &tids, const Itemset &lhs, int rhs,
+                std::vector<unsigned> &tid_table, std::vector<Discovery> &discoveries) const;
+    void AddFD(const FoundFD &fd);
+    void AddCFD(const FoundCFD &cfd);
+    void AddFreeItemset(const FreeItemset &free_itemset);
     std::pair<std::vector<const PartitionTIdList *>, std::vector<MinerNode<PartitionTIdList>>>
     ExpandMiningFd(const MinerNode<PartitionTIdList> &inode, int ix, const Itemset &iset,
                    const std::vector<MinerNode<PartitionTIdList>> &items) const;
@@ -51,15 +101,16 @@ private:
     void FillMinePatternsVars(PartitionList &, RhsesPair2DList &, RuleIxs &, std::vector<int> &,
                               const Itemset &, int, const PartitionTIdList &) const;
 
-    void AddCFDToCFDList(const std::vector<int> &sub, int out,
-                         const MinerNode<SimpleTIdList> &inode, const PartitionList &partitions);
+    void RecordCFD(const std::vector<int> &sub, int out, const MinerNode<SimpleTIdList> &inode,
+                   const PartitionList &partitions, std::vector<Discovery> &discoveries) const;
 
-    void AnalyzeCFDFromPIdList(const std::pair<int, SimpleTIdList> &, const PartitionList &,
-                               const std::vector<unsigned> &,
-                               std::vector<MinerNode<SimpleTIdList>> &, const Itemset &);
+    void AnalyzeCFDFromPIdList(const std::pair<int, SimpleTIdList> &, const std::vector<unsigned> &,
+                               std::vector<MinerNode<SimpleTIdList>> &, const Itemset &,
+                               std::vector<Discovery> &) const;
 
-    bool FillFreeMapAndItemsets(const PartitionList &partitions, const Itemset &lhs,
-                                const Itemset &new_set, const SimpleTIdList &ij_tids, unsigned);
+    bool RecordFreeItemset(const Itemset &lhs, const Itemset &new_set,
+                           const SimpleTIdList &ij_tids, unsigned,
+                           std::vector<Discovery> &discoveries) const;
 
 protected:
     void RegisterOptions();
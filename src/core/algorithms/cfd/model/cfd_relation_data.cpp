@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <iostream>
+#include <limits>
 #include <random>
 
 #include <easylogging++.h>
@@ -17,146 +18,78 @@ size_t CFDRelationData::GetNumRows() const {
     return data_rows_.size();
 }
 
-void CFDRelationData::AddNewItemsInFullTable(ItemDictionary& item_dictionary,
-                                             ColumnesValuesDict& columns_values_dict,
-                                             std::vector<ItemInfo>& items,
-                                             const std::vector<std::string>& string_row,
-                                             std::vector<int>& int_row,
-                                             std::vector<Transaction>& data_rows,
-                                             int& unique_elems_number, unsigned num_columns) {
-    int it;
-    for (size_t i = 0; i < num_columns; i++) {
-        auto ptr = item_dictionary.find(std::make_pair(i, string_row[i]));
-        if (ptr != item_dictionary.end()) {
-            it = ptr->second;
-        } else {
-            items.emplace_back(string_row[i], i);
-            columns_values_dict[static_cast<AttributeIndex>(i)].push_back(unique_elems_number);
-            item_dictionary[std::make_pair(i, string_row[i])] = unique_elems_number;
-            it = unique_elems_number++;
-        }
-        int_row[i] = it;
-        items[it - 1].frequency++;
-    }
-    data_rows.push_back(int_row);
-}
-
-std::unique_ptr<CFDRelationData> CFDRelationData::CreateFrom(model::IDatasetStream& parser,
-                                                             unsigned columns_number,
-                                                             unsigned tuples_number,
-                                                             double c_sample, double r_sample) {
-    if (columns_number == 0 || tuples_number == 0) {
-        return CFDRelationData::CreateFrom(parser, c_sample, r_sample);
-    }
-
+std::unique_ptr<CFDRelationData> CFDRelationData::CreateFromColumns(
+        model::IDatasetStream& file_input, const std::vector<int>& columns, size_t max_tuples,
+        double r_sample) {
     // Fields of CFDRelationData class
-    auto schema = std::make_unique<RelationalSchema>(parser.GetRelationName());
+    auto schema = std::make_unique<RelationalSchema>(file_input.GetRelationName());
     std::vector<Transaction> data_rows;
-    ItemDictionary item_dictionary;
-    std::vector<ItemInfo> items;
-    ColumnesValuesDict columns_values_dict;
-    int unique_elems_number = 1;
+    std::vector<ItemDictionary> item_dictionaries(columns.size());
+    std::deque<ItemInfo> items;
+    std::vector<std::vector<int>> domains(columns.size());
+    std::random_device rd;   // only used once to initialise (seed) engine
+    std::mt19937 rng(rd());  // random-number engine used (Mersenne-Twister in this case)
+    std::uniform_real_distribution<double> uni(0.0, 1.0);  // guaranteed unbiased
 
-    unsigned num_columns = parser.GetNumberOfColumns();
-    std::vector<std::string> line;
-    num_columns = std::min(num_columns, columns_number);
-    std::vector<std::string> string_row(num_columns);
-    while (parser.HasNextRow() && data_rows.size() < tuples_number) {
-        line = parser.GetNextRow();
-        std::vector<int> int_row(num_columns);
-        for (size_t k = 0; k < num_columns; k++) {
-            string_row[k] = line[k];
+    while (file_input.HasNextRow() && data_rows.size() < max_tuples) {
+        std::vector<std::string> line = file_input.GetNextRow();
+        if ((r_sample < 1 && uni(rng) >= r_sample) || columns.empty()) {
+            continue;
         }
 
-        AddNewItemsInFullTable(item_dictionary, columns_values_dict, items, string_row, int_row,
-                               data_rows, unique_elems_number, num_columns);
+        Transaction int_row(columns.size());
+        for (size_t j = 0; j < columns.size(); j++) {
+            std::string& value = line[columns[j]];
+            ItemDictionary& item_dictionary = item_dictionaries[j];
+            auto ptr = item_dictionary.find(value);
+            if (ptr == item_dictionary.end()) {
+                int const item = static_cast<int>(items.size()) + 1;
+                ItemInfo const& info = items.emplace_back(std::move(value), j);
+                domains[j].push_back(item);
+                ptr = item_dictionary.emplace(info.value, item).first;
+            }
+            int_row[j] = ptr->second;
+            items[ptr->second - 1].frequency++;
+        }
+        data_rows.push_back(std::move(int_row));
     }
 
     std::vector<CFDColumnData> column_data;
-    for (AttributeIndex i = 0; static_cast<size_t>(i) < num_columns; ++i) {
-        auto column = Column(schema.get(), parser.GetColumnName(i), i);
+    for (AttributeIndex i = 0; static_cast<size_t>(i) < columns.size(); ++i) {
+        auto column = Column(schema.get(), file_input.GetColumnName(columns[i]), i);
         schema->AppendColumn(std::move(column));
-        column_data.emplace_back(schema->GetColumn(i), columns_values_dict[i]);
+        column_data.emplace_back(schema->GetColumn(i), std::move(domains[i]));
     }
     schema->Init();
-
     return std::make_unique<CFDRelationData>(std::move(schema), std::move(column_data),
-                                             std::move(data_rows), std::move(item_dictionary),
+                                             std::move(data_rows), std::move(item_dictionaries),
                                              std::move(items));
 }
 
-void CFDRelationData::AddNewItemsInPartialTable(ItemDictionary& item_dictionary,
-                                                ColumnesValuesDict& columns_values_dict,
-                                                std::vector<ItemInfo>& items,
-                                                const std::vector<std::string>& string_row,
-                                                const std::vector<int>& columns_numbers_list,
-                                                std::vector<Transaction>& data_rows,
-                                                int& unique_elems_number, int size) {
-    std::vector<int> int_row(size);
-    AttributeIndex j = 0;
-    int it;
-    for (size_t i = 0; i < string_row.size(); i++) {
-        if (!std::binary_search(columns_numbers_list.begin(), columns_numbers_list.end(), i)) {
-            continue;
-        }
-        auto ptr = item_dictionary.find(std::make_pair(j, string_row[i]));
-        if (ptr != item_dictionary.end()) {
-            it = ptr->second;
-        } else {
-            items.emplace_back(string_row[i], j);
-            columns_values_dict[j].push_back(unique_elems_number);
-            item_dictionary[std::make_pair(j, string_row[i])] = unique_elems_number;
-            it = unique_elems_number++;
-        }
-        items[it - 1].frequency++;
-        int_row[j] = it;
-        j++;
-    }
-    if (j > 0) {
-        data_rows.push_back(int_row);
+std::unique_ptr<CFDRelationData> CFDRelationData::CreateFrom(model::IDatasetStream& parser,
+                                                             unsigned columns_number,
+                                                             unsigned tuples_number,
+                                                             double c_sample, double r_sample) {
+    if (columns_number == 0 || tuples_number == 0) {
+        return CFDRelationData::CreateFrom(parser, c_sample, r_sample);
     }
+
+    unsigned num_columns = parser.GetNumberOfColumns();
+    num_columns = std::min(num_columns, columns_number);
+    return CreateFromColumns(parser, Range(0, static_cast<int>(num_columns)), tuples_number, 1);
 }
 
 std::unique_ptr<CFDRelationData> CFDRelationData::CreateFrom(model::IDatasetStream& file_input,
                                                              double c_sample, double r_sample) {
-    // Fields of CFDRelationData class
-    auto schema = std::make_unique<RelationalSchema>(file_input.GetRelationName());
-    std::vector<Transaction> data_rows;
-    ItemDictionary item_dictionary;
-    std::vector<ItemInfo> items;
-    ColumnesValuesDict columns_values_dict;
-    int unique_elems_number = 1;
-    std::random_device rd;   // only used once to initialise (seed) engine
-    std::mt19937 rng(rd());  // random-number engine used (Mersenne-Twister in this case)
-    std::uniform_real_distribution<double> uni(0.0, 1.0);  // guaranteed unbiased
     int num_columns = static_cast<int>(file_input.GetNumberOfColumns());
-    std::vector<std::string> line;
     std::vector<int> columns_numbers_list = Range(0, num_columns);
     int size = static_cast<int>(static_cast<double>(columns_numbers_list.size()) * c_sample);
     Shuffle(columns_numbers_list);
     columns_numbers_list =
             std::vector<int>(columns_numbers_list.begin(), columns_numbers_list.begin() + size);
     std::sort(columns_numbers_list.begin(), columns_numbers_list.end());
-    while (file_input.HasNextRow()) {
-        if (uni(rng) >= r_sample) {
-            continue;
-        }
-        line = file_input.GetNextRow();
-
-        AddNewItemsInPartialTable(item_dictionary, columns_values_dict, items, line,
-                                  columns_numbers_list, data_rows, unique_elems_number, size);
-    }
-
-    std::vector<CFDColumnData> column_data;
-    for (AttributeIndex i = 0; i < num_columns; ++i) {
-        auto column = Column(schema.get(), file_input.GetColumnName(i), i);
-        schema->AppendColumn(std::move(column));
-        column_data.emplace_back(schema->GetColumn(i), columns_values_dict[i]);
-    }
-    schema->Init();
-    return std::make_unique<CFDRelationData>(std::move(schema), std::move(column_data),
-                                             std::move(data_rows), std::move(item_dictionary),
-                                             std::move(items));
+    return CreateFromColumns(file_input, columns_numbers_list,
+                             std::numeric_limits<size_t>::max(), r_sample);
 }
 
 unsigned CFDRelationData::Size() const {
@@ -208,7 +141,7 @@ int CFDRelationData::GetAttr(const std::string& s) const {
 }
 
 int CFDRelationData::GetItem(int attr, const std::string& str_value) const {
-    return item_dictionary_.at(std::make_pair(attr, str_value));
+    return item_dictionaries_.at(attr).at(str_value);
 }
 
 void CFDRelationData::Sort() {
@@ -1,11 +1,11 @@
 #pragma once
 
 #include <cstddef>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 
-#include <boost/functional/hash.hpp>
-#include <boost/unordered_map.hpp>
-
 #include "cfd_column_data.h"
 #include "cfd_types.h"
 #include "model/table/idataset_stream.h"
@@ -18,8 +18,9 @@ namespace algos::cfd {
 // Data presentation class that CFDDiscovery uses.
 class CFDRelationData : public AbstractRelationData<CFDColumnData> {
 private:
-    using ItemDictionary = boost::unordered_map<std::pair<int, std::string>, int, PairHash>;
-    using ColumnesValuesDict = std::unordered_map<AttributeIndex, std::vector<int>>;
+    // Maps a value of one column to the corresponding item id. The keys view the values stored in
+    // items_, which is a deque so that adding an item does not move the values of the others.
+    using ItemDictionary = std::unordered_map<std::string_view, int>;
     // ItemInfo contains info about one elem in the table.
     struct ItemInfo {
         ItemInfo() = default;
@@ -32,19 +33,15 @@ private:
 
     // array of data represented as rows of integers
     std::vector<Transaction> data_rows_;
-    // maps a value string for the given attribute index to corresponding item id
-    boost::unordered_map<std::pair<int, std::string>, int, PairHash> item_dictionary_;
-    std::vector<ItemInfo> items_;
-
-    static void AddNewItemsInFullTable(ItemDictionary &, ColumnesValuesDict &,
-                                       std::vector<ItemInfo> &, const std::vector<std::string> &,
-                                       std::vector<int> &, std::vector<Transaction> &, int &,
-                                       unsigned);
+    // dictionary of every attribute
+    std::vector<ItemDictionary> item_dictionaries_;
+    std::deque<ItemInfo> items_;
 
-    static void AddNewItemsInPartialTable(ItemDictionary &, ColumnesValuesDict &,
-                                          std::vector<ItemInfo> &, const std::vector<std::string> &,
-                                          const std::vector<int> &, std::vector<Transaction> &,
-                                          int &, int);
+    // Encodes the given columns of at most max_tuples rows in a single pass over the stream,
+    // keeping each row with probability r_sample
+    static std::unique_ptr<CFDRelationData> CreateFromColumns(model::IDatasetStream &file_input,
+                                                              const std::vector<int> &columns,
+                                                              size_t max_tuples, double r_sample);
 
 public:
     unsigned Size() const;
@@ -77,11 +74,10 @@ public:
 
     CFDRelationData(std::unique_ptr<RelationalSchema> schema,
                     std::vector<CFDColumnData> column_data, std::vector<Transaction> data,
-                    boost::unordered_map<std::pair<int, std::string>, int, PairHash> item_dict,
-                    std::vector<ItemInfo> items)
+                    std::vector<ItemDictionary> item_dictionaries, std::deque<ItemInfo> items)
         : AbstractRelationData(std::move(schema), std::move(column_data)),
           data_rows_(std::move(data)),
-          item_dictionary_(std::move(item_dict)),
+          item_dictionaries_(std::move(item_dictionaries)),
           items_(std::move(items)) {}
 };
 }  // namespace algos::cfd
@@ -8,7 +8,6 @@
 #include <utility>
 #include <vector>
 
-#include <boost/functional/hash.hpp>
 #include <boost/unordered_map.hpp>
 
 #include "raw_cfd.h"
@@ -30,7 +29,6 @@ using Itemset = std::vector<Item>;
 
 // the set of tids of tuples (indexes of rows in a table) that support concrete Item.
 using SimpleTIdList = std::vector<Item>;
-using PairHash = boost::hash<std::pair<int, std::string>>;
 
 // Representation of CFD of the form left items -> right item
 using ItemsetCFD = std::pair<Itemset, Item>;
@@ -1,5 +1,9 @@
 #include "partition_tidlist.h"
 
+#include <algorithm>
+
+#include "algorithms/cfd/util/partition_tidlist_util.h"
+
 namespace algos::cfd {
 
 const int PartitionTIdList::SEP = -1;
@@ -26,55 +30,26 @@ SimpleTIdList PartitionTIdList::Convert() const {
 }
 
 PartitionTIdList PartitionTIdList::Intersection(const PartitionTIdList& rhs) const {
-    std::unordered_map<int, int> eqIndices;
-    eqIndices.reserve(this->tids.size() + 1 - this->sets_number);
-    std::vector<std::vector<int> > eqClasses(this->sets_number);
-
-    int eix = 0;
-    int count = 0;
-    for (unsigned ix = 0; ix <= this->tids.size(); ix++) {
-        count++;
-        if (ix == this->tids.size() || this->tids[ix] == PartitionTIdList::SEP) {
-            eqClasses[eix].reserve(count);
-            count = 0;
-            eix++;
-        } else {
-            eqIndices[this->tids[ix]] = eix + 1;
-        }
-    }
-    PartitionTIdList res;
-    res.sets_number = 0;
-    for (unsigned ix = 0; ix <= rhs.tids.size(); ix++) {
-        if (ix == rhs.tids.size() || rhs.tids[ix] == PartitionTIdList::SEP) {
-            for (auto& eqcl : eqClasses) {
-                if (!eqcl.empty()) {
-                    res.tids.insert(res.tids.end(), eqcl.begin(), eqcl.end());
-                    res.tids.push_back(PartitionTIdList::SEP);
-                    res.sets_number++;
-                    eqcl.clear();
-                }
-            }
-        } else {
-            const int jt = rhs.tids[ix];
-            if (eqIndices[jt]) {
-                eqClasses[eqIndices[jt] - 1].push_back(jt);
-            }
-        }
+    int max_tid = SEP;
+    for (int tid : tids) {
+        max_tid = std::max(max_tid, tid);
     }
-    if (!res.tids.empty() && res.tids.back() == PartitionTIdList::SEP) {
-        res.tids.pop_back();
+    for (int tid : rhs.tids) {
+        max_tid = std::max(max_tid, tid);
     }
-    return res;
+    std::vector<unsigned> tid_table(max_tid + 1, 0);
+    return std::move(PartitionTIdListUtil::ConstructIntersection(*this, {&rhs}, tid_table).front());
 }
 
-int PartitionTIdList::PartitionError(const PartitionTIdList& xa) const {
+int PartitionTIdList::PartitionError(const PartitionTIdList& xa,
+                                     std::vector<unsigned>& tid_table) const {
     int e = 0;
 
-    std::map<int, int> bigt;
+    // The size of every class of xa is kept at the last tid of the class
     int count = 0;
     for (unsigned pi = 0; pi <= xa.tids.size(); pi++) {
         if (pi == xa.tids.size() || xa.tids[pi] == PartitionTIdList::SEP) {
-            bigt[xa.tids[pi - 1]] = count;
+            tid_table[xa.tids[pi - 1]] = count;
             count = 0;
         } else {
             count++;
@@ -90,12 +65,18 @@ int PartitionTIdList::PartitionError(const PartitionTIdList& xa) const {
             count = 0;
         } else {
             count++;
-            int t = this->tids[cix];
-            if (bigt.count(t) && bigt[t] > m) {
-                m = bigt[t];
+            int const bigt = tid_table[this->tids[cix]];
+            if (bigt > m) {
+                m = bigt;
             }
         }
     }
+
+    for (unsigned pi = 0; pi < xa.tids.size(); pi++) {
+        if (pi + 1 == xa.tids.size() || xa.tids[pi + 1] == PartitionTIdList::SEP) {
+            tid_table[xa.tids[pi]] = 0;
+        }
+    }
     return e;
 }
 }  // namespace algos::cfd
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "cfd_types.h"
 
 namespace algos::cfd {
@@ -24,6 +26,7 @@ struct PartitionTIdList {
 
     PartitionTIdList Intersection(const PartitionTIdList& rhs) const;
 
-    int PartitionError(const PartitionTIdList&) const;
+    // tid_table is indexed by tids and has to be filled with zeros, it is left so on return
+    int PartitionError(const PartitionTIdList&, std::vector<unsigned>& tid_table) const;
 };
 }  // namespace algos::cfd
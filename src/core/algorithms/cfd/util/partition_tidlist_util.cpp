@@ -1,53 +1,81 @@
 #include "partition_tidlist_util.h"
 
-#include "tidlist_util.h"
+#include <algorithm>
+
+// see algorithms/cfd/LICENSE
 
 namespace algos::cfd {
 
 // Computes intersection
 std::vector<PartitionTIdList> PartitionTIdListUtil::ConstructIntersection(
-        PartitionTIdList const& lhs, const std::vector<const PartitionTIdList*>& rhses) {
-    std::unordered_map<int, int> eqIndices(TIdUtil::Support(lhs.tids));
-    std::vector<std::vector<int> > eqClasses(lhs.sets_number);
-    // Construct a lookup from tid to equivalence class
-    int eix = 0;
-    int count = 0;
-    for (unsigned ix = 0; ix <= lhs.tids.size(); ix++) {
-        count++;
-        if (ix == lhs.tids.size() || lhs.tids[ix] == PartitionTIdList::SEP) {
-            eqClasses[eix++].reserve(count);
-            count = 0;
+        PartitionTIdList const& lhs, const std::vector<const PartitionTIdList*>& rhses,
+        std::vector<unsigned>& tid_table) {
+    // Construct a lookup from tid to the number of its equivalence class, counted from 1
+    unsigned classes_number = 1;
+    for (int tid : lhs.tids) {
+        if (tid == PartitionTIdList::SEP) {
+            classes_number++;
         } else {
-            eqIndices[lhs.tids[ix]] = eix + 1;
+            tid_table[tid] = classes_number;
         }
     }
+
+    // Sizes of the classes of lhs within one class of rhs, then the positions to write them at
+    std::vector<size_t> class_slots(classes_number + 1, 0);
+    std::vector<unsigned> met_classes;
     std::vector<PartitionTIdList> res;
+    res.reserve(rhses.size());
     for (const PartitionTIdList* rhs : rhses) {
         PartitionTIdList p_tid_list = PartitionTIdList();
         p_tid_list.sets_number = 0;
         p_tid_list.tids.reserve(lhs.tids.size());
-        for (unsigned ix = 0; ix <= rhs->tids.size(); ix++) {
-            if (ix == rhs->tids.size() || rhs->tids[ix] == PartitionTIdList::SEP) {
-                for (auto& eqcl : eqClasses) {
-                    if (!eqcl.empty()) {
-                        p_tid_list.tids.insert(p_tid_list.tids.end(), eqcl.begin(), eqcl.end());
-                        p_tid_list.tids.push_back(PartitionTIdList::SEP);
-                        p_tid_list.sets_number++;
-                        eqcl.clear();
-                    }
+        auto class_begin = rhs->tids.begin();
+        while (class_begin != rhs->tids.end()) {
+            auto const class_end = std::find(class_begin, rhs->tids.end(), PartitionTIdList::SEP);
+            for (auto it = class_begin; it != class_end; ++it) {
+                unsigned const eix = tid_table[*it];
+                if (eix != 0 && class_slots[eix]++ == 0) {
+                    met_classes.push_back(eix);
                 }
-            } else {
-                int jt = rhs->tids[ix];
-                if (eqIndices.count(jt)) {
-                    eqClasses[eqIndices[jt] - 1].push_back(jt);
+            }
+            // The parts of the rhs class go in the order of the lhs classes
+            std::sort(met_classes.begin(), met_classes.end());
+            size_t added = met_classes.size();
+            for (unsigned eix : met_classes) {
+                added += class_slots[eix];
+            }
+            size_t position = p_tid_list.tids.size();
+            p_tid_list.tids.resize(position + added);
+            for (unsigned eix : met_classes) {
+                size_t const size = class_slots[eix];
+                class_slots[eix] = position;
+                position += size;
+                p_tid_list.tids[position++] = PartitionTIdList::SEP;
+            }
+            for (auto it = class_begin; it != class_end; ++it) {
+                unsigned const eix = tid_table[*it];
+                if (eix != 0) {
+                    p_tid_list.tids[class_slots[eix]++] = *it;
                 }
             }
+            for (unsigned eix : met_classes) {
+                class_slots[eix] = 0;
+            }
+            p_tid_list.sets_number += met_classes.size();
+            met_classes.clear();
+            class_begin = class_end == rhs->tids.end() ? class_end : std::next(class_end);
         }
 
         if (!p_tid_list.tids.empty() && p_tid_list.tids.back() == PartitionTIdList::SEP) {
             p_tid_list.tids.pop_back();
         }
-        res.push_back(p_tid_list);
+        res.push_back(std::move(p_tid_list));
+    }
+
+    for (int tid : lhs.tids) {
+        if (tid != PartitionTIdList::SEP) {
+            tid_table[tid] = 0;
+        }
     }
     return res;
 }
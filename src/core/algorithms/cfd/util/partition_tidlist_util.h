@@ -6,7 +6,9 @@ namespace algos::cfd {
 
 class PartitionTIdListUtil {
 public:
+    // tid_table is indexed by tids and has to be filled with zeros, it is left so on return
     static std::vector<PartitionTIdList> ConstructIntersection(
-            PartitionTIdList const& lhs, const std::vector<const PartitionTIdList*>& rhses);
+            PartitionTIdList const& lhs, const std::vector<const PartitionTIdList*>& rhses,
+            std::vector<unsigned>& tid_table);
 };
 }  // namespace algos::cfd
@@ -1,39 +1,40 @@
 #include "aid.h"
 
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+#include "config/thread_number/option.h"
+#include "util/parallel_for.h"
+
 namespace algos {
 
-Aid::Aid() : FDAlgorithm({kDefaultPhaseName}) {}
+Aid::Aid() : FDAlgorithm({kDefaultPhaseName}) {
+    RegisterOptions();
+}
+
+void Aid::RegisterOptions() {
+    RegisterOption(config::ThreadNumberOpt(&threads_num_));
+}
+
+void Aid::MakeExecuteOptsAvailable() {
+    MakeOptionsAvailable({config::ThreadNumberOpt.GetName()});
+}
 
 void Aid::LoadDataInternal() {
-    number_of_attributes_ = input_table_->GetNumberOfColumns();
+    relation_ = model::ColumnLayoutEncodedRelationData::CreateFrom(*input_table_);
+    number_of_attributes_ = relation_->GetNumColumns();
     if (number_of_attributes_ == 0) {
         throw std::runtime_error("Unable to work on an empty dataset.");
     }
 
-    schema_ = std::make_unique<RelationalSchema>(input_table_->GetRelationName());
-
-    for (size_t i = 0; i < number_of_attributes_; ++i) {
-        const std::string& column_name = input_table_->GetColumnName(static_cast<int>(i));
-        schema_->AppendColumn(column_name);
-    }
-
-    while (input_table_->HasNextRow()) {
-        const std::vector<std::string>& next_line = input_table_->GetNextRow();
-        if (next_line.empty()) {
-            break;
-        }
-
-        tuples_.emplace_back(std::vector<size_t>(number_of_attributes_));
-        for (size_t i = 0; i < number_of_attributes_; ++i) {
-            tuples_.back()[i] = std::hash<std::string>{}(next_line[i]);
-        }
-    }
-    number_of_tuples_ = tuples_.size();
+    number_of_tuples_ = relation_->GetNumRows();
+    num_agree_set_blocks_ = boost::dynamic_bitset<>(number_of_attributes_).num_blocks();
     constant_columns_ = boost::dynamic_bitset<>(number_of_attributes_);
 }
 
 void Aid::ResetStateFd() {
-    clusters_.assign(number_of_attributes_, std::unordered_map<size_t, Cluster>{});
+    clusters_.assign(number_of_attributes_, std::vector<Cluster>{});
     indices_in_clusters_.assign(number_of_attributes_, std::vector<size_t>(number_of_tuples_));
     constant_columns_.reset();
     prev_ratios_.assign(window_size_, 1.0);
@@ -61,21 +62,16 @@ void Aid::BuildClusters() {
     }
 
     for (size_t attr_num = 0; attr_num < number_of_attributes_; ++attr_num) {
-        std::unordered_map<size_t, Cluster>& column_values = clusters_[attr_num];
-        bool is_constant = true;
-        size_t first_value = tuples_[0][attr_num];
+        model::EncodedColumnData const& column = relation_->GetColumnData(attr_num);
+        std::vector<Cluster>& column_clusters = clusters_[attr_num];
+        column_clusters.resize(column.GetNumValues());
         for (size_t tuple_num = 0; tuple_num < number_of_tuples_; ++tuple_num) {
-            size_t entry_value = tuples_[tuple_num][attr_num];
-            if (entry_value != first_value) {
-                is_constant = false;
-            }
-
-            Cluster& cluster = column_values[entry_value];
+            Cluster& cluster = column_clusters[column.GetValueId(tuple_num)];
             cluster.push_back(tuple_num);
             indices_in_clusters_[attr_num][tuple_num] = cluster.size() - 1;
         }
 
-        if (is_constant) {
+        if (column.GetNumValues() == 1) {
             constant_columns_[attr_num] = true;
         }
     }
@@ -95,10 +91,22 @@ bool Aid::IsNegativeCoverGrowthSmall(size_t iteration_num, double curr_ratio) {
 }
 
 void Aid::CreateNegativeCover() {
+    // Every buffer is filled by one task of a round, the buffers are merged after the round
+    size_t const num_buffers =
+        std::max<size_t>(1, std::min<size_t>(threads_num_, number_of_tuples_));
+    std::vector<SampleBuffer> buffers(num_buffers);
+    for (size_t i = 0; i < num_buffers; ++i) {
+        buffers[i].first_tuple = number_of_tuples_ * i / num_buffers;
+        buffers[i].last_tuple = number_of_tuples_ * (i + 1) / num_buffers;
+        buffers[i].agree_set.resize(number_of_attributes_);
+    }
+
     size_t prev_neg_cover_size = 0;
     for (size_t index = 1;; ++index) {
-        for (size_t tuple_num = 0; tuple_num < number_of_tuples_; ++tuple_num) {
-            HandleTuple(tuple_num, index);
+        auto const sample = [this, index](SampleBuffer& buffer) { SampleRound(buffer, index); };
+        util::parallel_foreach(buffers.begin(), buffers.end(), threads_num_, sample);
+        for (SampleBuffer const& buffer : buffers) {
+            MergeIntoNegativeCover(buffer);
         }
 
         size_t curr_neg_cover_size = neg_cover_.size();
@@ -118,40 +126,94 @@ void Aid::CreateNegativeCover() {
     }
 }
 
-void Aid::HandleTuple(size_t tuple_num, size_t iteration_num) {
+void Aid::SampleRound(SampleBuffer& buffer, size_t iteration_num) const {
+    buffer.agree_sets.clear();
+    for (size_t tuple_num = buffer.first_tuple; tuple_num < buffer.last_tuple; ++tuple_num) {
+        HandleTuple(tuple_num, iteration_num, buffer);
+    }
+    DeduplicateAgreeSets(buffer.agree_sets);
+}
+
+void Aid::HandleTuple(size_t tuple_num, size_t iteration_num, SampleBuffer& buffer) const {
     for (size_t attr_num = 0; attr_num < number_of_attributes_; ++attr_num) {
-        size_t value = tuples_[tuple_num][attr_num];
-        const Cluster& cluster = clusters_[attr_num].at(value);
+        model::EncodedColumnData::ValueId value =
+            relation_->GetColumnData(attr_num).GetValueId(tuple_num);
+        const Cluster& cluster = clusters_[attr_num][value];
         size_t index_in_cluster = indices_in_clusters_[attr_num][tuple_num];
         if (iteration_num <= index_in_cluster) {
             size_t another_index_in_cluster =
                 GenerateSecondClusterIndex(index_in_cluster, iteration_num);
             size_t another_tuple_num = cluster[another_index_in_cluster];
-            auto tuples_agree_set = BuildAgreeSet(tuple_num, another_tuple_num);
-            neg_cover_.insert(tuples_agree_set);
+            BuildAgreeSet(tuple_num, another_tuple_num, buffer.agree_set);
+            // The negative cover is only read while a round is sampled
+            if (neg_cover_.find(buffer.agree_set) == neg_cover_.end()) {
+                boost::to_block_range(buffer.agree_set, std::back_inserter(buffer.agree_sets));
+            }
         }
     }
 }
 
-boost::dynamic_bitset<> Aid::BuildAgreeSet(size_t t1, size_t t2) {
-    boost::dynamic_bitset<> equal_attr(number_of_attributes_);
+void Aid::BuildAgreeSet(size_t t1, size_t t2, boost::dynamic_bitset<>& agree_set) const {
+    agree_set.reset();
     for (size_t attr_num = 0; attr_num < number_of_attributes_; ++attr_num) {
-        if (tuples_[t1][attr_num] == tuples_[t2][attr_num]) {
-            equal_attr.set(attr_num);
+        model::EncodedColumnData const& column = relation_->GetColumnData(attr_num);
+        if (column.GetValueId(t1) == column.GetValueId(t2)) {
+            agree_set.set(attr_num);
         }
     }
+}
 
-    return equal_attr;
+void Aid::DeduplicateAgreeSets(std::vector<AgreeSetBlock>& agree_sets) const {
+    size_t const width = num_agree_set_blocks_;
+    if (width == 1) {
+        std::sort(agree_sets.begin(), agree_sets.end());
+        agree_sets.erase(std::unique(agree_sets.begin(), agree_sets.end()), agree_sets.end());
+        return;
+    }
+
+    auto const agree_set_begin = [&agree_sets, width](size_t i) {
+        return agree_sets.begin() + i * width;
+    };
+    std::vector<size_t> order(agree_sets.size() / width);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&agree_set_begin, width](size_t lhs, size_t rhs) {
+        return std::lexicographical_compare(agree_set_begin(lhs), agree_set_begin(lhs) + width,
+                                            agree_set_begin(rhs), agree_set_begin(rhs) + width);
+    });
+    order.erase(std::unique(order.begin(), order.end(),
+                            [&agree_set_begin, width](size_t lhs, size_t rhs) {
+                                return std::equal(agree_set_begin(lhs),
+                                                  agree_set_begin(lhs) + width,
+                                                  agree_set_begin(rhs));
+                            }),
+                order.end());
+
+    std::vector<AgreeSetBlock> distinct_agree_sets;
+    distinct_agree_sets.reserve(order.size() * width);
+    for (size_t i : order) {
+        distinct_agree_sets.insert(distinct_agree_sets.end(), agree_set_begin(i),
+                                   agree_set_begin(i) + width);
+    }
+    agree_sets = std::move(distinct_agree_sets);
+}
+
+void Aid::MergeIntoNegativeCover(SampleBuffer const& buffer) {
+    auto const& agree_sets = buffer.agree_sets;
+    for (auto it = agree_sets.begin(); it != agree_sets.end(); it += num_agree_set_blocks_) {
+        boost::dynamic_bitset<> agree_set(number_of_attributes_);
+        boost::from_block_range(it, it + num_agree_set_blocks_, agree_set);
+        neg_cover_.insert(std::move(agree_set));
+    }
 }
 
 void Aid::HandleConstantColumns(boost::dynamic_bitset<>& attributes) {
     boost::dynamic_bitset<> empty_set(number_of_attributes_);
-    Vertical lhs = *schema_->empty_vertical_;
+    Vertical lhs = *relation_->GetSchema()->empty_vertical_;
     for (size_t attr_num = constant_columns_.find_first();
          attr_num != boost::dynamic_bitset<>::npos;
          attr_num = constant_columns_.find_next(attr_num)) {
         attributes[attr_num] = false;
-        Column rhs = *schema_->GetColumn(attr_num);
+        Column rhs = *relation_->GetSchema()->GetColumn(attr_num);
         RegisterFd(lhs, rhs);
     }
 }
@@ -234,9 +296,9 @@ void Aid::InvertNegativeCover() {
 
 void Aid::RegisterFDs(size_t rhs_attribute,
                       const std::vector<boost::dynamic_bitset<>>& list_of_lhs_attributes) {
-    Column rhs = *schema_->GetColumn(rhs_attribute);
+    Column rhs = *relation_->GetSchema()->GetColumn(rhs_attribute);
     for (const auto& lhs_attributes : list_of_lhs_attributes) {
-        Vertical lhs = schema_->GetVertical(lhs_attributes);
+        Vertical lhs = relation_->GetSchema()->GetVertical(lhs_attributes);
         RegisterFd(lhs, rhs);
     }
 }
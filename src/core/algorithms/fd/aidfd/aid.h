@@ -1,14 +1,14 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <unordered_set>
 
 #include <boost/dynamic_bitset.hpp>
 
+#include "config/thread_number/type.h"
 #include "fd/fd_algorithm.h"
 #include "model/table/column.h"
-#include "model/table/relational_schema.h"
+#include "model/table/column_layout_encoded_relation_data.h"
 #include "model/table/vertical.h"
 #include "search_tree.h"
 
@@ -17,12 +17,26 @@ namespace algos {
 class Aid : public FDAlgorithm {
 private:
     using Cluster = std::vector<size_t>;
+    using AgreeSetBlock = boost::dynamic_bitset<>::block_type;
 
-    std::unique_ptr<RelationalSchema> schema_{};
-    std::vector<std::vector<size_t>> tuples_;
+    // Agree sets sampled from a range of tuples in one round that are missing from the negative
+    // cover, each stored as num_agree_set_blocks_ consecutive blocks laid out like those of a
+    // dynamic_bitset
+    struct SampleBuffer {
+        size_t first_tuple;
+        size_t last_tuple;
+        std::vector<AgreeSetBlock> agree_sets;
+        // reused for every sampled pair of tuples
+        boost::dynamic_bitset<> agree_set;
+    };
+
+    std::unique_ptr<model::ColumnLayoutEncodedRelationData> relation_;
 
     size_t number_of_attributes_{};
     size_t number_of_tuples_{};
+    size_t num_agree_set_blocks_{};
+
+    config::ThreadNumType threads_num_;
 
     std::unordered_set<boost::dynamic_bitset<>> neg_cover_{};
 
@@ -33,11 +47,15 @@ private:
     std::vector<double> prev_ratios_;
     double sum_{};
 
-    std::vector<std::unordered_map<size_t, Cluster>> clusters_;
+    // Clusters of every column, indexed by value id
+    std::vector<std::vector<Cluster>> clusters_;
     std::vector<std::vector<size_t>> indices_in_clusters_;
 
     boost::dynamic_bitset<> constant_columns_;
 
+    void RegisterOptions();
+    void MakeExecuteOptsAvailable() final;
+
     void ResetStateFd() final;
 
     void LoadDataInternal() final;
@@ -47,7 +65,10 @@ private:
     void CreateNegativeCover();
     void InvertNegativeCover();
 
-    void HandleTuple(size_t tuple_num, size_t index);
+    void SampleRound(SampleBuffer& buffer, size_t iteration_num) const;
+    void HandleTuple(size_t tuple_num, size_t iteration_num, SampleBuffer& buffer) const;
+    void DeduplicateAgreeSets(std::vector<AgreeSetBlock>& agree_sets) const;
+    void MergeIntoNegativeCover(SampleBuffer const& buffer);
     void HandleInvalidFd(const boost::dynamic_bitset<>& neg_cover_el, SearchTree& pos_cover_tree,
                          size_t rhs);
     size_t GenerateSecondClusterIndex(size_t index_in_cluster, size_t iteration_num) const;
@@ -61,7 +82,7 @@ private:
     std::vector<size_t> GetAttributesSortedByFrequency(
         const std::vector<boost::dynamic_bitset<>>& neg_cover_vector) const;
 
-    boost::dynamic_bitset<> BuildAgreeSet(size_t t1, size_t t2);
+    void BuildAgreeSet(size_t t1, size_t t2, boost::dynamic_bitset<>& agree_set) const;
 
 public:
     Aid();
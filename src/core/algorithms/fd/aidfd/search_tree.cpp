@@ -1,46 +1,89 @@
 #include "search_tree.h"
 
-SearchTree::Node::Node(size_t bit, SearchTree::Bitset set, SearchTree::Bitset sets_union,
-                       SearchTree::Bitset sets_inter, const std::shared_ptr<Node>& parent,
-                       std::shared_ptr<Node> left, std::shared_ptr<Node> right)
-    : bit_(bit),
-      set_(std::move(set)),
-      union_(std::move(sets_union)),
-      inter_(std::move(sets_inter)),
-      left_(std::move(left)),
-      right_(std::move(right)),
-      parent_(parent) {}
-
-SearchTree::Node::Node(size_t bit, SearchTree::Bitset sets_union, SearchTree::Bitset sets_inter,
-                       const std::shared_ptr<Node>& parent, std::shared_ptr<Node> left,
-                       std::shared_ptr<Node> right)
-    : bit_(bit),
-      union_(std::move(sets_union)),
-      inter_(std::move(sets_inter)),
-      left_(std::move(left)),
-      right_(std::move(right)),
-      parent_(parent) {}
-
-SearchTree::Node::Node(size_t bit, SearchTree::Bitset set, const std::shared_ptr<Node>& parent)
-    : bit_(bit), set_(std::move(set)), parent_(parent) {}
-
-bool SearchTree::Node::IsLeaf() const {
-    assert((left_ != nullptr) ^ (right_ == nullptr));
-    return !left_ && !right_;
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+
+SearchTree::SearchTree(size_t number_of_attributes)
+    : number_of_attributes_(number_of_attributes),
+      num_blocks_((number_of_attributes + kBitsPerBlock - 1) / kBitsPerBlock) {}
+
+SearchTree::SearchTree(const Bitset& set) : SearchTree(set.size()) {
+    CreateSingleElementSets(set);
 }
 
-const SearchTree::Bitset& SearchTree::Node::GetUnion() const {
-    return IsLeaf() ? set_ : union_;
+SearchTree::NodeId SearchTree::AllocateNode(size_t bit, NodeId parent) {
+    NodeId node;
+    if (free_nodes_.empty()) {
+        node = nodes_.size();
+        nodes_.emplace_back();
+        bitset_blocks_.resize(bitset_blocks_.size() + kBitsetsPerNode * num_blocks_);
+    } else {
+        node = free_nodes_.back();
+        free_nodes_.pop_back();
+        nodes_[node] = Node{};
+        std::fill_n(GetSetBlocks(node), kBitsetsPerNode * num_blocks_, Block{0});
+    }
+
+    nodes_[node].bit = bit;
+    nodes_[node].parent = parent;
+    return node;
 }
 
-const SearchTree::Bitset& SearchTree::Node::GetInter() const {
-    return IsLeaf() ? set_ : inter_;
+void SearchTree::FreeNode(NodeId node) {
+    free_nodes_.push_back(node);
 }
 
-SearchTree::SearchTree(size_t number_of_attributes) : number_of_attributes_(number_of_attributes) {}
+SearchTree::Block const* SearchTree::GetUnion(NodeId node) const {
+    return nodes_[node].IsLeaf() ? GetSetBlocks(node) : GetUnionBlocks(node);
+}
 
-SearchTree::SearchTree(const Bitset& set) : number_of_attributes_(set.size()) {
-    CreateSingleElementSets(set);
+SearchTree::Block const* SearchTree::GetInter(NodeId node) const {
+    return nodes_[node].IsLeaf() ? GetSetBlocks(node) : GetInterBlocks(node);
+}
+
+std::vector<SearchTree::Block> SearchTree::ToBlocks(const Bitset& set) const {
+    assert(set.size() == number_of_attributes_);
+    std::vector<Block> blocks(num_blocks_);
+    boost::to_block_range(set, blocks.begin());
+    return blocks;
+}
+
+void SearchTree::CopyBlocks(Block const* from, Block* to) const {
+    std::copy_n(from, num_blocks_, to);
+}
+
+bool SearchTree::IsSubset(Block const* lhs, Block const* rhs) const {
+    for (size_t i = 0; i < num_blocks_; ++i) {
+        if ((lhs[i] & ~rhs[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SearchTree::AreEqual(Block const* lhs, Block const* rhs) const {
+    return std::equal(lhs, lhs + num_blocks_, rhs);
+}
+
+bool SearchTree::Test(Block const* set, size_t bit) {
+    return (set[bit / kBitsPerBlock] >> (bit % kBitsPerBlock)) & 1;
+}
+
+size_t SearchTree::FindFrom(Block const* set, size_t bit) const {
+    if (bit >= number_of_attributes_) {
+        return Bitset::npos;
+    }
+
+    size_t block_index = bit / kBitsPerBlock;
+    Block block = set[block_index] & (~Block{0} << (bit % kBitsPerBlock));
+    while (block == 0) {
+        if (++block_index == num_blocks_) {
+            return Bitset::npos;
+        }
+        block = set[block_index];
+    }
+    return block_index * kBitsPerBlock + std::bitset<kBitsPerBlock>(block)._Find_first();
 }
 
 void SearchTree::CreateSingleElementSets(const Bitset& set) {
@@ -55,47 +98,51 @@ bool SearchTree::Add(const Bitset& set) {
     assert(!set.empty());
     assert(set.size() == number_of_attributes_);
 
-    if (!root_) {
-        root_ = std::make_shared<Node>(set.find_first(), set, nullptr);
+    std::vector<Block> const set_blocks = ToBlocks(set);
+    Block const* blocks = set_blocks.data();
+
+    if (root_ == kNoNode) {
+        root_ = AllocateNode(FindFrom(blocks, 0), kNoNode);
+        CopyBlocks(blocks, GetSetBlocks(root_));
         ++cardinality_;
         return true;
     }
 
-    auto current_node = root_;
-    for (size_t prev_node_bit = 0, curr_node_bit = current_node->bit_; !current_node->IsLeaf();
-         current_node = set[curr_node_bit] ? current_node->right_ : current_node->left_,
-                prev_node_bit = std::exchange(curr_node_bit, current_node->bit_) + 1) {
+    NodeId current_node = root_;
+    for (size_t prev_node_bit = 0, curr_node_bit = nodes_[current_node].bit;
+         !nodes_[current_node].IsLeaf();
+         current_node = Test(blocks, curr_node_bit) ? nodes_[current_node].right
+                                                    : nodes_[current_node].left,
+                prev_node_bit = std::exchange(curr_node_bit, nodes_[current_node].bit) + 1) {
         assert(curr_node_bit != Bitset::npos);
         assert(prev_node_bit <= curr_node_bit);
         for (size_t set_bit = prev_node_bit; set_bit < curr_node_bit; ++set_bit) {
-            if (set[set_bit] != current_node->union_[set_bit]) {
-                InsertLeafIntoMiddle(current_node, set, set_bit);
+            if (Test(blocks, set_bit) != Test(GetUnionBlocks(current_node), set_bit)) {
+                InsertLeafIntoMiddle(current_node, blocks, set_bit);
                 ++cardinality_;
                 return true;
             }
         }
     }
 
-    auto bits = FindNodeAndSetBits(current_node->set_, set);
-    size_t node_bit = bits.first;
-    size_t set_bit = bits.second;
+    auto [node_bit, set_bit] = FindNodeAndSetBits(GetSetBlocks(current_node), blocks);
     if (node_bit == set_bit) {
         return false;
     }
 
-    InsertLeafIntoEnd(current_node, set, node_bit, set_bit);
+    InsertLeafIntoEnd(current_node, blocks, node_bit, set_bit);
     ++cardinality_;
     return true;
 }
 
 bool SearchTree::Remove(const Bitset& set) {
     assert(!set.empty());
-    if (!root_) {
+    if (root_ == kNoNode) {
         return false;
     }
 
-    auto node_to_remove = FindNode(set);
-    if (!node_to_remove) {
+    NodeId node_to_remove = FindNode(ToBlocks(set).data());
+    if (node_to_remove == kNoNode) {
         return false;
     }
 
@@ -104,123 +151,135 @@ bool SearchTree::Remove(const Bitset& set) {
     return true;
 }
 
-void SearchTree::CollectSubsets(const Bitset& set, const std::shared_ptr<Node>& current_node,
-                                const BitsetConsumer& collect, bool& go_further) const {
-    if (current_node->IsLeaf()) {
-        auto node_set = current_node->set_;
-        if (node_set.is_subset_of(set)) {
-            collect(node_set);
-        }
-        return;
+template <typename Visitor>
+bool SearchTree::VisitSubsets(Block const* set, NodeId current_node, Visitor&& visit) const {
+    Node const& node = nodes_[current_node];
+    if (node.IsLeaf()) {
+        return !IsSubset(GetSetBlocks(current_node), set) || visit(current_node);
     }
 
-    if (go_further && current_node->inter_.is_subset_of(set)) {
-        CollectSubsets(set, current_node->left_, collect, go_further);
-        if (set[current_node->bit_]) {
-            CollectSubsets(set, current_node->right_, collect, go_further);
-        }
+    if (!IsSubset(GetInterBlocks(current_node), set)) {
+        return true;
     }
+    if (!VisitSubsets(set, node.left, visit)) {
+        return false;
+    }
+    return !Test(set, node.bit) || VisitSubsets(set, node.right, visit);
 }
 
 bool SearchTree::ContainsAnySubsetOf(const Bitset& set) const {
-    bool go_further = true;
-    auto contains_func = [&go_further](const Bitset&) { go_further = false; };
-
-    if (root_) {
-        CollectSubsets(set, root_, contains_func, go_further);
+    if (root_ == kNoNode) {
+        return false;
     }
 
-    return !go_further;
+    return !VisitSubsets(ToBlocks(set).data(), root_, [](NodeId) { return false; });
 }
 
-void SearchTree::ForEach(const std::shared_ptr<Node>& current_node,
+void SearchTree::ForEach(NodeId current_node, Bitset& leaf_set,
                          const BitsetConsumer& collect) const {
-    if (current_node->IsLeaf()) {
-        collect(current_node->set_);
+    Node const& node = nodes_[current_node];
+    if (node.IsLeaf()) {
+        Block const* blocks = GetSetBlocks(current_node);
+        boost::from_block_range(blocks, blocks + num_blocks_, leaf_set);
+        collect(leaf_set);
         return;
     }
 
-    ForEach(current_node->left_, collect);
-    ForEach(current_node->right_, collect);
+    ForEach(node.left, leaf_set, collect);
+    ForEach(node.right, leaf_set, collect);
 }
 
 void SearchTree::ForEach(const BitsetConsumer& collect) const {
-    if (root_) {
-        ForEach(root_, collect);
+    if (root_ != kNoNode) {
+        Bitset leaf_set(number_of_attributes_);
+        ForEach(root_, leaf_set, collect);
     }
 }
 
 void SearchTree::ForEachSubset(const SearchTree::Bitset& set, const BitsetConsumer& collect) const {
-    if (root_) {
-        bool go_further = true;
-        CollectSubsets(set, root_, collect, go_further);
+    if (root_ == kNoNode) {
+        return;
     }
+
+    Bitset leaf_set(number_of_attributes_);
+    VisitSubsets(ToBlocks(set).data(), root_, [this, &leaf_set, &collect](NodeId leaf) {
+        Block const* blocks = GetSetBlocks(leaf);
+        boost::from_block_range(blocks, blocks + num_blocks_, leaf_set);
+        collect(leaf_set);
+        return true;
+    });
 }
 
-void SearchTree::UpdateInterAndUnion(const std::shared_ptr<Node>& node) {
-    auto node_copy = node;
-    while (node_copy) {
-        const auto& left = node_copy->left_;
-        const auto& right = node_copy->right_;
-        node_copy->union_ = left->GetUnion() | right->GetUnion();
-        node_copy->inter_ = left->GetInter() & right->GetInter();
-        node_copy = node_copy->parent_.lock();
+void SearchTree::UpdateInterAndUnion(NodeId node) {
+    for (; node != kNoNode; node = nodes_[node].parent) {
+        Block const* left_union = GetUnion(nodes_[node].left);
+        Block const* right_union = GetUnion(nodes_[node].right);
+        Block const* left_inter = GetInter(nodes_[node].left);
+        Block const* right_inter = GetInter(nodes_[node].right);
+        Block* node_union = GetUnionBlocks(node);
+        Block* node_inter = GetInterBlocks(node);
+        for (size_t i = 0; i < num_blocks_; ++i) {
+            node_union[i] = left_union[i] | right_union[i];
+            node_inter[i] = left_inter[i] & right_inter[i];
+        }
     }
 }
 
-std::shared_ptr<SearchTree::Node> SearchTree::FindNode(const Bitset& set) {
-    auto current_node = root_;
-    for (size_t set_bit = set.find_first(), node_bit = current_node->bit_; !current_node->IsLeaf();
-         node_bit = current_node->bit_) {
-        if (!(set.is_subset_of(current_node->union_) && current_node->inter_.is_subset_of(set))) {
-            return nullptr;
+SearchTree::NodeId SearchTree::FindNode(Block const* set) const {
+    NodeId current_node = root_;
+    while (!nodes_[current_node].IsLeaf()) {
+        if (!(IsSubset(set, GetUnionBlocks(current_node)) &&
+              IsSubset(GetInterBlocks(current_node), set))) {
+            return kNoNode;
         }
 
-        if (set[node_bit]) {
-            current_node = current_node->right_;
-            set_bit = set.find_next(set_bit);
-        } else {
-            current_node = current_node->left_;
-        }
+        Node const& node = nodes_[current_node];
+        current_node = Test(set, node.bit) ? node.right : node.left;
     }
 
-    if (current_node->set_ != set) {
-        return nullptr;
+    if (!AreEqual(GetSetBlocks(current_node), set)) {
+        return kNoNode;
     }
 
     return current_node;
 }
 
-void SearchTree::CutLeaf(const std::shared_ptr<Node>& node_to_remove) {
+void SearchTree::CutLeaf(NodeId node_to_remove) {
     if (node_to_remove == root_) {
-        root_ = nullptr;
+        root_ = kNoNode;
+        FreeNode(node_to_remove);
         return;
     }
 
-    auto parent_node = node_to_remove->parent_.lock();
-    auto another_child_node =
-        (parent_node->right_ == node_to_remove) ? parent_node->left_ : parent_node->right_;
-
-    parent_node->left_ = another_child_node->left_;
-    parent_node->right_ = another_child_node->right_;
-    parent_node->set_ = another_child_node->set_;
-    parent_node->union_ = another_child_node->union_;
-    parent_node->inter_ = another_child_node->inter_;
-    if (!another_child_node->IsLeaf()) {
-        parent_node->bit_ = another_child_node->bit_;
-        parent_node->left_->parent_ = parent_node;
-        parent_node->right_->parent_ = parent_node;
+    NodeId parent_node = nodes_[node_to_remove].parent;
+    NodeId another_child_node = (nodes_[parent_node].right == node_to_remove)
+                                        ? nodes_[parent_node].left
+                                        : nodes_[parent_node].right;
+    Node const& another_child = nodes_[another_child_node];
+    Node& parent = nodes_[parent_node];
+
+    parent.left = another_child.left;
+    parent.right = another_child.right;
+    std::copy_n(GetSetBlocks(another_child_node), kBitsetsPerNode * num_blocks_,
+                GetSetBlocks(parent_node));
+    if (!another_child.IsLeaf()) {
+        parent.bit = another_child.bit;
+        nodes_[parent.left].parent = parent_node;
+        nodes_[parent.right].parent = parent_node;
     }
 
-    UpdateInterAndUnion(parent_node->parent_.lock());
+    FreeNode(node_to_remove);
+    FreeNode(another_child_node);
+
+    UpdateInterAndUnion(nodes_[parent_node].parent);
 }
 
-std::pair<size_t, size_t> SearchTree::FindNodeAndSetBits(const Bitset& node_set,
-                                                         const Bitset& set) {
-    size_t node_bit = node_set.find_first();
-    size_t set_bit = set.find_first();
+std::pair<size_t, size_t> SearchTree::FindNodeAndSetBits(Block const* node_set,
+                                                         Block const* set) const {
+    size_t node_bit = FindFrom(node_set, 0);
+    size_t set_bit = FindFrom(set, 0);
     for (; node_bit == set_bit;
-         node_bit = node_set.find_next(node_bit), set_bit = set.find_next(set_bit)) {
+         node_bit = FindFrom(node_set, node_bit + 1), set_bit = FindFrom(set, set_bit + 1)) {
         if (node_bit == Bitset::npos) {
             break;
         }
@@ -229,45 +288,50 @@ std::pair<size_t, size_t> SearchTree::FindNodeAndSetBits(const Bitset& node_set,
     return std::make_pair(node_bit, set_bit);
 }
 
-void SearchTree::InsertLeafIntoEnd(const std::shared_ptr<Node>& current_node, const Bitset& set,
-                         size_t node_bit, size_t set_bit) {
-    const Bitset& node_set = current_node->set_;
-    auto new_left = std::make_shared<Node>(node_bit, node_set, current_node);
-    auto new_right = std::make_shared<Node>(set_bit, set, current_node);
+void SearchTree::InsertLeafIntoEnd(NodeId current_node, Block const* set, size_t node_bit,
+                                   size_t set_bit) {
+    NodeId new_left = AllocateNode(node_bit, current_node);
+    NodeId new_right = AllocateNode(set_bit, current_node);
+    CopyBlocks(GetSetBlocks(current_node), GetSetBlocks(new_left));
+    CopyBlocks(set, GetSetBlocks(new_right));
 
     if (node_bit < set_bit) {
-        new_left->bit_ = node_set.find_next(node_bit);
+        nodes_[new_left].bit = FindFrom(GetSetBlocks(new_left), node_bit + 1);
         std::swap(new_left, new_right);
-        current_node->bit_ = node_bit;
+        nodes_[current_node].bit = node_bit;
     } else {
-        new_right->bit_ = set.find_next(set_bit);
-        current_node->bit_ = set_bit;
+        nodes_[new_right].bit = FindFrom(set, set_bit + 1);
+        nodes_[current_node].bit = set_bit;
     }
 
-    current_node->left_ = new_left;
-    current_node->right_ = new_right;
+    nodes_[current_node].left = new_left;
+    nodes_[current_node].right = new_right;
 
     UpdateInterAndUnion(current_node);
 }
 
-void SearchTree::InsertLeafIntoMiddle(const std::shared_ptr<Node>& current_node,
-                            const SearchTree::Bitset& set, size_t set_bit) {
-    auto new_left = std::make_shared<Node>(
-        current_node->bit_, current_node->set_,current_node->union_, current_node->inter_,
-        current_node, current_node->left_, current_node->right_);
-    auto new_right = std::make_shared<Node>(set.find_next(set_bit), set, current_node);
-    auto replacing_node = new_left;
-    if (!set[set_bit]) {
+void SearchTree::InsertLeafIntoMiddle(NodeId current_node, Block const* set, size_t set_bit) {
+    NodeId moved_node = AllocateNode(nodes_[current_node].bit, current_node);
+    NodeId new_leaf = AllocateNode(FindFrom(set, set_bit + 1), current_node);
+    std::copy_n(GetSetBlocks(current_node), kBitsetsPerNode * num_blocks_,
+                GetSetBlocks(moved_node));
+    CopyBlocks(set, GetSetBlocks(new_leaf));
+
+    Node& moved = nodes_[moved_node];
+    moved.left = nodes_[current_node].left;
+    moved.right = nodes_[current_node].right;
+    nodes_[moved.left].parent = moved_node;
+    nodes_[moved.right].parent = moved_node;
+
+    NodeId new_left = moved_node;
+    NodeId new_right = new_leaf;
+    if (!Test(set, set_bit)) {
         std::swap(new_left, new_right);
-        replacing_node = new_right;
     }
 
-    current_node->left_->parent_ = replacing_node;
-    current_node->right_->parent_ = replacing_node;
-
-    current_node->bit_ = set_bit;
-    current_node->left_ = new_left;
-    current_node->right_ = new_right;
+    nodes_[current_node].bit = set_bit;
+    nodes_[current_node].left = new_left;
+    nodes_[current_node].right = new_right;
 
     UpdateInterAndUnion(current_node);
 }
@@ -1,7 +1,9 @@
 #pragma once
 
-#include <unordered_map>
+#include <functional>
+#include <limits>
 #include <utility>
+#include <vector>
 
 #include <boost/dynamic_bitset.hpp>
 
@@ -11,55 +13,91 @@ public:
     using BitsetConsumer = std::function<void(const Bitset&)>;
 
 private:
-    struct Node {
-        size_t bit_{};
-
-        Bitset set_;
-        Bitset union_;
-        Bitset inter_;
-
-        std::shared_ptr<Node> left_{};
-        std::shared_ptr<Node> right_{};
-        std::weak_ptr<Node> parent_{};
-
-        [[nodiscard]] bool IsLeaf() const;
+    using Block = Bitset::block_type;
+    using NodeId = unsigned int;
 
-        [[nodiscard]] const Bitset& GetUnion() const;
-        [[nodiscard]] const Bitset& GetInter() const;
+    static constexpr NodeId kNoNode = std::numeric_limits<NodeId>::max();
+    static constexpr size_t kBitsPerBlock = Bitset::bits_per_block;
 
-        // for inner nodes
-        Node(size_t bit, Bitset sets_union, Bitset sets_inter, const std::shared_ptr<Node>& parent,
-             std::shared_ptr<Node> left = nullptr, std::shared_ptr<Node> right = nullptr);
+    // Nodes refer to each other by their index in nodes_. Bitsets of a node are not stored in the
+    // node itself: they occupy kBitsetsPerNode * num_blocks_ consecutive blocks of bitset_blocks_
+    // at the node's index, laid out like the blocks of a Bitset
+    struct Node {
+        size_t bit{};
 
-        // for leaves
-        Node(size_t bit, Bitset set, const std::shared_ptr<Node>& parent);
+        NodeId left = kNoNode;
+        NodeId right = kNoNode;
+        NodeId parent = kNoNode;
 
-        // for both types of nodes
-        Node(size_t bit, Bitset set, Bitset sets_union, Bitset sets_inter,
-             const std::shared_ptr<Node>& parent, std::shared_ptr<Node> left = nullptr,
-             std::shared_ptr<Node> right = nullptr);
+        [[nodiscard]] bool IsLeaf() const {
+            return left == kNoNode;
+        }
     };
 
+    // set, union and intersection
+    static constexpr size_t kBitsetsPerNode = 3;
+
     size_t cardinality_{};
     size_t number_of_attributes_{};
-    std::shared_ptr<Node> root_{};
+    size_t num_blocks_{};
+    NodeId root_ = kNoNode;
+
+    std::vector<Node> nodes_;
+    std::vector<Block> bitset_blocks_;
+    // Indices of removed nodes to be reused
+    std::vector<NodeId> free_nodes_;
+
+    NodeId AllocateNode(size_t bit, NodeId parent);
+    void FreeNode(NodeId node);
+
+    Block* GetSetBlocks(NodeId node) {
+        return bitset_blocks_.data() + node * kBitsetsPerNode * num_blocks_;
+    }
+    Block const* GetSetBlocks(NodeId node) const {
+        return bitset_blocks_.data() + node * kBitsetsPerNode * num_blocks_;
+    }
+    Block* GetUnionBlocks(NodeId node) {
+        return GetSetBlocks(node) + num_blocks_;
+    }
+    Block const* GetUnionBlocks(NodeId node) const {
+        return GetSetBlocks(node) + num_blocks_;
+    }
+    Block* GetInterBlocks(NodeId node) {
+        return GetSetBlocks(node) + 2 * num_blocks_;
+    }
+    Block const* GetInterBlocks(NodeId node) const {
+        return GetSetBlocks(node) + 2 * num_blocks_;
+    }
+    // Union and intersection of the sets in the subtree of the node
+    [[nodiscard]] Block const* GetUnion(NodeId node) const;
+    [[nodiscard]] Block const* GetInter(NodeId node) const;
+
+    std::vector<Block> ToBlocks(const Bitset& set) const;
+    void CopyBlocks(Block const* from, Block* to) const;
+    bool IsSubset(Block const* lhs, Block const* rhs) const;
+    bool AreEqual(Block const* lhs, Block const* rhs) const;
+    static bool Test(Block const* set, size_t bit);
+    // Index of the first set bit not less than the given one or Bitset::npos
+    size_t FindFrom(Block const* set, size_t bit) const;
 
     void CreateSingleElementSets(const Bitset& set);
 
-    void CollectSubsets(const Bitset& set, const std::shared_ptr<Node>& current_node,
-                        const BitsetConsumer& collect, bool& go_further) const;
+    // Calls visit for every leaf whose set is a subset of the given one, stops as soon as visit
+    // returns false. Returns false if the traversal was stopped
+    template <typename Visitor>
+    bool VisitSubsets(Block const* set, NodeId current_node, Visitor&& visit) const;
 
-    void ForEach(const std::shared_ptr<Node>& current_node, const BitsetConsumer& collect) const;
+    void ForEach(NodeId current_node, Bitset& leaf_set, const BitsetConsumer& collect) const;
 
-    std::shared_ptr<Node> FindNode(const Bitset& set);
-    void CutLeaf(const std::shared_ptr<Node>& node_to_remove);
-    void InsertLeafIntoEnd(const std::shared_ptr<Node>& current_node, const Bitset& set,
-                 size_t node_bit, size_t set_bit);
-    void InsertLeafIntoMiddle(const std::shared_ptr<Node>& current_node, const Bitset& set, size_t set_bit);
+    NodeId FindNode(Block const* set) const;
+    void CutLeaf(NodeId node_to_remove);
+    void InsertLeafIntoEnd(NodeId current_node, Block const* set, size_t node_bit,
+                           size_t set_bit);
+    void InsertLeafIntoMiddle(NodeId current_node, Block const* set, size_t set_bit);
 
-    static void UpdateInterAndUnion(const std::shared_ptr<Node>& node);
+    void UpdateInterAndUnion(NodeId node);
 
-    static std::pair<size_t, size_t> FindNodeAndSetBits(const Bitset& node_set, const Bitset& set);
+    std::pair<size_t, size_t> FindNodeAndSetBits(Block const* node_set, Block const* set) const;
 
 public:
     explicit SearchTree(size_t number_of_attributes);
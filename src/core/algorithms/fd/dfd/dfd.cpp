@@ -1,8 +1,12 @@
 #include "dfd.h"
 
+#include <algorithm>
+
 #include <boost/asio.hpp>
 #include <easylogging++.h>
 
+#include "config/names_and_descriptions.h"
+#include "config/option_using.h"
 #include "config/thread_number/option.h"
 #include "lattice_traversal/lattice_traversal.h"
 #include "model/table/column_layout_relation_data.h"
@@ -16,17 +20,28 @@ DFD::DFD() : PliBasedFDAlgorithm({kDefaultPhaseName}) {
 }
 
 void DFD::RegisterOptions() {
+    DESBORDANTE_OPTION_USING;
+
     RegisterOption(config::ThreadNumberOpt(&number_of_threads_));
+    RegisterOption(Option{&seed_, kSeed, kDSeed, 0});
 }
 
 void DFD::MakeExecuteOptsAvailable() {
-    MakeOptionsAvailable({config::ThreadNumberOpt.GetName()});
+    using namespace config::names;
+    MakeOptionsAvailable({config::ThreadNumberOpt.GetName(), kSeed});
 }
 
 void DFD::ResetStateFd() {
     unique_columns_.clear();
 }
 
+std::mt19937::result_type DFD::GetTraversalSeed(Column const& rhs) const {
+    std::seed_seq seed_sequence{seed_, static_cast<int>(rhs.GetIndex())};
+    std::mt19937::result_type traversal_seed;
+    seed_sequence.generate(&traversal_seed, &traversal_seed + 1);
+    return traversal_seed;
+}
+
 unsigned long long DFD::ExecuteInternal() {
     auto partition_storage = std::make_unique<PartitionStorage>(
             relation_.get(), CachingMethod::kAllCaching, CacheEvictionMethod::kMedainUsage);
@@ -48,36 +63,44 @@ unsigned long long DFD::ExecuteInternal() {
 
     double progress_step = 100.0 / schema->GetNumColumns();
     boost::asio::thread_pool search_space_pool(number_of_threads_);
+    // minimal LHSs found for each RHS, registered in column order once all traversals are done
+    // so that the resulting FD list does not depend on thread scheduling
+    std::vector<std::vector<Vertical>> lhss_by_rhs(schema->GetNumColumns());
 
     for (auto& rhs : schema->GetColumns()) {
-        boost::asio::post(
-                search_space_pool, [this, &rhs, schema, progress_step, &partition_storage]() {
+        boost::asio::post(search_space_pool, [this, &rhs, schema, progress_step,
+                                              &partition_storage, &lhss_by_rhs]() {
             ColumnData const& rhs_data = relation_->GetColumnData(rhs->GetIndex());
             model::PositionListIndex const* const rhs_pli = rhs_data.GetPositionListIndex();
+            std::vector<Vertical>& lhss = lhss_by_rhs[rhs->GetIndex()];
 
             /* if all the rows have the same value, then we register FD with empty LHS
              * if we have minimal FD like []->RHS, it is impossible to find smaller FD with this RHS,
              * so we register it and move to the next RHS
              * */
             if (rhs_pli->GetNepAsLong() == relation_->GetNumTuplePairs()) {
-                RegisterFd(*(schema->empty_vertical_), *rhs);
+                lhss.push_back(*(schema->empty_vertical_));
                 AddProgress(progress_step);
                 return;
             }
 
             auto search_space = LatticeTraversal(rhs.get(), relation_.get(), unique_columns_,
-                                                 partition_storage.get());
+                                                 partition_storage.get(), GetTraversalSeed(*rhs));
             auto const minimal_deps = search_space.FindLHSs();
 
-            for (auto const& minimal_dependency_lhs: minimal_deps) {
-                RegisterFd(minimal_dependency_lhs, *rhs);
-            }
+            lhss.assign(minimal_deps.begin(), minimal_deps.end());
+            std::sort(lhss.begin(), lhss.end());
             AddProgress(progress_step);
             LOG(INFO) << static_cast<int>(GetProgress().second);
         });
     }
 
     search_space_pool.join();
+    for (auto const& rhs : schema->GetColumns()) {
+        for (auto const& minimal_dependency_lhs : lhss_by_rhs[rhs->GetIndex()]) {
+            RegisterFd(minimal_dependency_lhs, *rhs);
+        }
+    }
     SetProgress(100);
 
     auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -15,6 +15,7 @@ private:
     std::vector<Vertical> unique_columns_;
 
     config::ThreadNumType number_of_threads_;
+    int seed_;
 
     void MakeExecuteOptsAvailable() final;
     void RegisterOptions();
@@ -22,6 +23,10 @@ private:
     void ResetStateFd() final;
     unsigned long long ExecuteInternal() final;
 
+    // Seed of the random walk over the lattice of the given RHS. It depends only on seed_ and the
+    // RHS, so every traversal takes the same path regardless of the number of threads.
+    std::mt19937::result_type GetTraversalSeed(Column const& rhs) const;
+
 public:
     DFD();
 };
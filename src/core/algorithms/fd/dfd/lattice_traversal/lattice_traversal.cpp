@@ -7,7 +7,8 @@
 LatticeTraversal::LatticeTraversal(const Column* const rhs,
                                    const ColumnLayoutRelationData* const relation,
                                    const std::vector<Vertical>& unique_verticals,
-                                   PartitionStorage* const partition_storage)
+                                   PartitionStorage* const partition_storage,
+                                   std::mt19937::result_type seed)
     : rhs_(rhs),
       dependencies_map_(relation->GetSchema()),
       non_dependencies_map_(relation->GetSchema()),
@@ -15,7 +16,7 @@ LatticeTraversal::LatticeTraversal(const Column* const rhs,
       unique_columns_(unique_verticals),
       relation_(relation),
       partition_storage_(partition_storage),
-      gen_(rd_()) {}
+      gen_(seed) {}
 
 std::unordered_set<Vertical> LatticeTraversal::FindLHSs() {
     RelationalSchema const* const schema = relation_->GetSchema();
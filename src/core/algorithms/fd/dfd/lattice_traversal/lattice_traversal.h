@@ -26,7 +26,6 @@ private:
     ColumnLayoutRelationData const* const relation_;
     PartitionStorage* const partition_storage_;
 
-    std::random_device rd_;
     std::mt19937 gen_;
 
     bool InferCategory(Vertical const& node, unsigned int rhs_index);
@@ -41,7 +40,7 @@ private:
 public:
     LatticeTraversal(Column const* const rhs, ColumnLayoutRelationData const* const relation,
                      std::vector<Vertical> const& unique_verticals,
-                     PartitionStorage* const partition_storage);
+                     PartitionStorage* const partition_storage, std::mt19937::result_type seed);
 
     std::unordered_set<Vertical> FindLHSs();
 };
@@ -27,9 +27,10 @@ PartitionStorage::PartitionStorage(ColumnLayoutRelationData* relation_data,
 PartitionStorage::~PartitionStorage() {}
 
 // obtains or calculates a PositionListIndex using cache
+// Cached PLIs are looked up under the shared lock of the index, so concurrent traversals only
+// block each other while a freshly computed PLI is being inserted, never during an intersection.
 std::variant<model::PositionListIndex*, std::unique_ptr<model::PositionListIndex>>
 PartitionStorage::GetOrCreateFor(Vertical const& vertical) {
-    std::scoped_lock lock(getting_pli_mutex_);
     LOG(DEBUG) << boost::format{"PLI for %1% requested: "} % vertical.ToString();
 
     // is PLI already cached?
@@ -155,6 +156,12 @@ size_t PartitionStorage::Size() const {
 std::variant<model::PositionListIndex*, std::unique_ptr<model::PositionListIndex>>
 PartitionStorage::CachingProcess(Vertical const& vertical,
                                  std::unique_ptr<model::PositionListIndex> pli) {
+    std::scoped_lock lock(caching_mutex_);
+    // another traversal may have cached the same PLI while this one was computing it. The cached
+    // one must be kept, since raw pointers to it might have been handed out already
+    if (model::PositionListIndex* cached_pli = Get(vertical); cached_pli != nullptr) {
+        return cached_pli;
+    }
     auto pli_pointer = pli.get();
     index_->Put(vertical, std::move(pli));
     return pli_pointer;
@@ -25,7 +25,9 @@ private:
 
     int saved_intersections_ = 0;
 
-    mutable std::mutex getting_pli_mutex_;
+    // Serializes insertions into index_ so that a PLI computed concurrently by several threads
+    // gets cached only once. Lookups rely on the reader-writer lock of index_ alone.
+    std::mutex caching_mutex_;
 
     CachingMethod caching_method_;
     CacheEvictionMethod eviction_method_;
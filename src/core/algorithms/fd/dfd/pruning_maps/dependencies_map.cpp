@@ -14,44 +14,16 @@ std::unordered_set<Vertical> DependenciesMap::GetPrunedSubsets(std::unordered_se
 }
 
 void DependenciesMap::AddNewDependency(Vertical const& node_to_add) {
-    for (auto& map_row : *this) {
-        Vertical const& key = map_row.first;
-
-        if (node_to_add.Contains(key)) {
-            auto& deps_for_key = map_row.second;
-            bool has_subset_entry = false;
-
-            for (auto iter = deps_for_key.begin(); iter != deps_for_key.end();) {
-                //if verticals are the same, then contains == true
-                Vertical const& dep = *iter;
-                if (node_to_add.Contains(dep)) {
-                    has_subset_entry = true;
-                    break;
-                } else if (dep.Contains(node_to_add)) {
-                    iter = deps_for_key.erase(iter);
-                } else {
-                    iter++;
-                }
-            }
-
-            if (!has_subset_entry) {
-                deps_for_key.insert(node_to_add);
-            }
-        }
+    auto const& indices = node_to_add.GetColumnIndicesRef();
+    //the empty node is neither stored nor pruned
+    if (indices.none() || nodes_.ContainsSubsetOf(indices)) {
+        return;
     }
-    Rebalance();
+    nodes_.EraseSupersetsOf(indices);
+    nodes_.Insert(indices);
 }
 
 bool DependenciesMap::CanBePruned(Vertical const& node) const {
-    for (auto const& map_row : *this) {
-        Vertical const& key = map_row.first;
-        if (node.Contains(key)) {
-            for (Vertical const& dependency : map_row.second) {
-                if (node.Contains(dependency)) {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
+    auto const& indices = node.GetColumnIndicesRef();
+    return indices.any() && nodes_.ContainsSubsetOf(indices);
 }
@@ -3,6 +3,7 @@
 #include "model/table/vertical.h"
 #include "pruning_map.h"
 
+// Keeps minimal dependencies, a node can be pruned if it contains one of them
 class DependenciesMap : public PruningMap {
 public:
     explicit DependenciesMap(RelationalSchema const* schema);
@@ -3,6 +3,7 @@
 #include "model/table/vertical.h"
 #include "pruning_map.h"
 
+// Keeps maximal non-dependencies, a node can be pruned if one of them contains it
 class NonDependenciesMap : public PruningMap {
 public:
     explicit NonDependenciesMap(RelationalSchema const* schema);
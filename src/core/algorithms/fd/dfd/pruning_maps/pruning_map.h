@@ -1,16 +1,24 @@
 #pragma once
 
-#include <unordered_map>
 #include <unordered_set>
 
-#include "../lattice_observations/lattice_observations.h"
+#include "model/table/relational_schema.h"
 #include "model/table/vertical.h"
+#include "util/bitset_trie.h"
+#include "util/custom_hashes.h"
+
+/* Stores an antichain of lattice nodes in a set-trie so that the subset/superset checks needed
+ * for pruning do not have to scan the whole collection.
+ */
+class PruningMap {
+protected:
+    util::BitsetTrie nodes_;
 
-class PruningMap : public std::unordered_map<Vertical, std::unordered_set<Vertical>> {
 public:
-    PruningMap(RelationalSchema const* schema);
+    explicit PruningMap(RelationalSchema const* schema) : nodes_(schema->GetNumColumns()) {}
     PruningMap() = default;
 
-    void Rebalance();
-    void RebalanceGroup(Vertical const& key);
+    size_t Size() const noexcept {
+        return nodes_.Size();
+    }
 };
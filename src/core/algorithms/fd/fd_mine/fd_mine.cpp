@@ -1,25 +1,53 @@
 #include "fd_mine.h"
 
-#include <queue>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
-#include <boost/unordered_map.hpp>
 #include <easylogging++.h>
 
+#include "config/thread_number/option.h"
+#include "util/parallel_for.h"
+
 namespace algos {
 
 using boost::dynamic_bitset;
 
-Fd_mine::Fd_mine() : PliBasedFDAlgorithm({kDefaultPhaseName}) {}
+namespace {
+
+// Checks whether the columns partitioned by pli determine the column with the given probing
+// table, i.e. whether intersecting them would leave the number of clusters unchanged
+bool Determines(model::PositionListIndex const& pli, std::vector<int> const& probing_table) {
+    for (model::PositionListIndex::Cluster const& cluster : pli.GetIndex()) {
+        int const value = probing_table[cluster.front()];
+        if (value == model::PositionListIndex::singleton_value_id_) {
+            return false;
+        }
+        for (int position : cluster) {
+            if (probing_table[position] != value) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+Fd_mine::Fd_mine() : PliBasedFDAlgorithm({kDefaultPhaseName}) {
+    RegisterOption(config::ThreadNumberOpt(&threads_num_));
+}
+
+void Fd_mine::MakeExecuteOptsAvailable() {
+    MakeOptionsAvailable({config::ThreadNumberOpt.GetName()});
+}
 
 void Fd_mine::ResetStateFd() {
-    candidate_set_.clear();
-    eq_set_.clear();
-    fd_set_.clear();
+    candidates_.clear();
     final_fd_set_.clear();
-    key_set_.clear();
-    closure_.clear();
-    plis_.clear();
 }
 
 unsigned long long Fd_mine::ExecuteInternal() {
@@ -27,28 +55,34 @@ unsigned long long Fd_mine::ExecuteInternal() {
     schema_ = relation_->GetSchema();
     auto start_time = std::chrono::system_clock::now();
 
-    relation_indices_ = dynamic_bitset<>(schema_->GetNumColumns());
-
-    for (size_t column_index = 0; column_index < schema_->GetNumColumns(); column_index++) {
-        dynamic_bitset<> tmp(schema_->GetNumColumns());
-        tmp[column_index] = 1;
-        relation_indices_[column_index] = 1;
-        candidate_set_.insert(std::move(tmp));
-    }
+    size_t const num_columns = schema_->GetNumColumns();
+    relation_indices_ = dynamic_bitset<>(num_columns);
+    relation_indices_.set();
 
-    for (auto const& candidate : candidate_set_) {
-        closure_[candidate] = dynamic_bitset<>(schema_->GetNumColumns());
+    for (size_t column_index = 0; column_index < num_columns; column_index++) {
+        Candidate candidate;
+        candidate.attrs = dynamic_bitset<>(num_columns);
+        candidate.attrs.set(column_index);
+        candidate.pli = relation_->GetColumnData(column_index).GetPliOwnership();
+        candidates_.push_back(std::move(candidate));
     }
 
     // 2
-    while (!candidate_set_.empty()) {
-        for (auto const& candidate : candidate_set_) {
+    CandidateId level_begin = 0;
+    while (level_begin != candidates_.size()) {
+        auto const compute_closure = [this](Candidate& candidate) {
             ComputeNonTrivialClosure(candidate);
-            ObtainFDandKey(candidate);
+        };
+        util::parallel_foreach(candidates_.begin() + level_begin, candidates_.end(), threads_num_,
+                               compute_closure);
+        ObtainEqSet(level_begin);
+
+        CandidateId const next_level_begin = candidates_.size();
+        GenerateNextLevelCandidates(PruneCandidates(level_begin));
+        for (CandidateId id = level_begin; id != next_level_begin; ++id) {
+            candidates_[id].pli.reset();
         }
-        ObtainEqSet();
-        PruneCandidates();
-        GenerateNextLevelCandidates();
+        level_begin = next_level_begin;
     }
 
     // 3
@@ -60,206 +94,194 @@ unsigned long long Fd_mine::ExecuteInternal() {
     return elapsed_milliseconds.count();
 }
 
-void Fd_mine::ComputeNonTrivialClosure(dynamic_bitset<> const& xi) {
-    if (!closure_.count(xi)) {
-        closure_[xi] = dynamic_bitset<>(xi.size());
-    }
+void Fd_mine::ComputeNonTrivialClosure(Candidate& xi) const {
+    xi.closure = dynamic_bitset<>(xi.attrs.size());
     for (size_t column_index = 0; column_index < schema_->GetNumColumns(); column_index++) {
-        if ((relation_indices_ - xi - closure_[xi])[column_index]) {
-            dynamic_bitset<> candidate_xy = xi;
-            dynamic_bitset<> candidate_y(schema_->GetNumColumns());
-            candidate_xy[column_index] = 1;
-            candidate_y[column_index] = 1;
-
-            if (xi.count() == 1) {
-                auto candidate_x_pli =
-                    relation_->GetColumnData(xi.find_first()).GetPositionListIndex();
-                auto candidate_y_pli =
-                    relation_->GetColumnData(column_index).GetPositionListIndex();
-
-                plis_[candidate_xy] = candidate_x_pli->Intersect(candidate_y_pli);
-
-                if (candidate_x_pli->GetNumCluster() == plis_[candidate_xy]->GetNumCluster()) {
-                    closure_[xi][column_index] = 1;
-                }
+        if (!xi.attrs[column_index] &&
+            Determines(*xi.pli, relation_->GetColumnData(column_index).GetProbingTable())) {
+            xi.closure[column_index] = 1;
+        }
+    }
+    xi.is_key = relation_indices_ == (xi.attrs | xi.closure);
+}
 
+void Fd_mine::ObtainEqSet(CandidateId level_begin) {
+    CandidateId const level_end = candidates_.size();
+    std::vector<CandidateId> level(level_end - level_begin);
+    std::iota(level.begin(), level.end(), level_begin);
+    std::vector<std::vector<CandidateId>> found(level.size());
+
+    auto const find_equivalents = [this, level_begin, &found](CandidateId candidate_id) {
+        Candidate const& candidate = candidates_[candidate_id];
+        std::vector<CandidateId>& equivalents = found[candidate_id - level_begin];
+        // Both candidates of a pair from this level find each other, keep only one of them
+        for (CandidateId lhs_id = 0; lhs_id != candidates_.size(); ++lhs_id) {
+            if (lhs_id == candidate_id || (lhs_id >= level_begin && lhs_id < candidate_id)) {
                 continue;
             }
-
-            if (!plis_.count(candidate_xy)) {
-                auto candidate_y_pli =
-                    relation_->GetColumnData(candidate_y.find_first()).GetPositionListIndex();
-                plis_[candidate_xy] = plis_[xi]->Intersect(candidate_y_pli);
-            }
-
-            if (plis_[xi]->GetNumCluster() == plis_[candidate_xy]->GetNumCluster()) {
-                closure_[xi][column_index] = 1;
+            Candidate const& lhs = candidates_[lhs_id];
+            auto common_atrs = candidate.attrs & lhs.attrs;
+            if ((candidate.attrs - common_atrs).is_subset_of(lhs.closure) &&
+                (lhs.attrs - common_atrs).is_subset_of(candidate.closure)) {
+                equivalents.push_back(lhs_id);
             }
         }
-    }
-}
+    };
+    util::parallel_foreach(level.begin(), level.end(), threads_num_, find_equivalents);
 
-void Fd_mine::ObtainFDandKey(dynamic_bitset<> const& xi) {
-    fd_set_[xi] = closure_[xi];
-    if (relation_indices_ == (xi | closure_[xi])) {
-        key_set_.insert(xi);
-    }
-}
-
-void Fd_mine::ObtainEqSet() {
-    for (auto const& candidate: candidate_set_) {
-        for (auto &[lhs, closure] : fd_set_) {
-            auto common_atrs = candidate & lhs;
-            if ((candidate - common_atrs).is_subset_of(closure) &&
-                (lhs - common_atrs).is_subset_of(closure_[candidate])) {
-                if (lhs != candidate) {
-                    eq_set_[lhs].insert(candidate);
-                    eq_set_[candidate].insert(lhs);
-                }
-            }
+    for (CandidateId candidate_id : level) {
+        for (CandidateId lhs_id : found[candidate_id - level_begin]) {
+            candidates_[candidate_id].equivalents.push_back(lhs_id);
+            candidates_[lhs_id].equivalents.push_back(candidate_id);
         }
     }
 }
 
-void Fd_mine::PruneCandidates() {
-    auto it = candidate_set_.begin();
-    while (it != candidate_set_.end()) {
-        bool found = false;
-        auto const& xi = *it;
-
-        for (auto const& xj : eq_set_[xi]) {
-            if (candidate_set_.find(xj) != candidate_set_.end()) {
-                it = candidate_set_.erase(it);
-                found = true;
-                break;
-            }
-        }
-
-        if (found) continue;
-
-        if (key_set_.find(xi) != key_set_.end()) {
-            it = candidate_set_.erase(it);
+std::vector<Fd_mine::CandidateId> Fd_mine::PruneCandidates(CandidateId level_begin) const {
+    // Of equivalent candidates only the last one in the level order is kept
+    std::vector<bool> in_level(candidates_.size(), false);
+    std::fill(in_level.begin() + level_begin, in_level.end(), true);
+
+    std::vector<CandidateId> kept;
+    for (CandidateId id = level_begin; id != candidates_.size(); ++id) {
+        Candidate const& xi = candidates_[id];
+        bool const has_equivalent =
+                std::any_of(xi.equivalents.begin(), xi.equivalents.end(),
+                            [&in_level](CandidateId xj) { return in_level[xj]; });
+        if (has_equivalent || xi.is_key) {
+            in_level[id] = false;
             continue;
         }
-        it++;
+        kept.push_back(id);
     }
+    return kept;
 }
 
-void Fd_mine::GenerateNextLevelCandidates() {
-    std::vector<dynamic_bitset<>> candidates(candidate_set_.begin(), candidate_set_.end());
-
-    dynamic_bitset<> candidate_i;
-    dynamic_bitset<> candidate_j;
-    dynamic_bitset<> candidate_ij;
-
-    for (size_t i = 0; i < candidates.size(); i++) {
-        candidate_i = candidates[i];
-
-        for (size_t j = i + 1; j < candidates.size(); j++) {
-            candidate_j = candidates[j];
-
-            // apriori-gen
-            bool similar = true;
-            size_t set_bits = 0;
-
-            assert(candidate_i.count() != 0);
-            for (size_t k = 0; set_bits < candidate_i.count() - 1; k++) {
-                if (candidate_i[k] == candidate_j[k]) {
-                    if (candidate_i[k]) {
-                        set_bits++;
-                    }
-                } else {
-                    similar = false;
-                    break;
+void Fd_mine::GenerateNextLevelCandidates(std::vector<CandidateId> const& level) {
+    // apriori-gen: candidates are joined when they differ only in their last column
+    std::vector<std::pair<dynamic_bitset<>, CandidateId>> by_prefix;
+    by_prefix.reserve(level.size());
+    for (CandidateId id : level) {
+        dynamic_bitset<> prefix = candidates_[id].attrs;
+        size_t last = prefix.find_first();
+        for (size_t next = prefix.find_next(last); next != dynamic_bitset<>::npos;
+             next = prefix.find_next(next)) {
+            last = next;
+        }
+        prefix.reset(last);
+        by_prefix.emplace_back(std::move(prefix), id);
+    }
+    std::stable_sort(by_prefix.begin(), by_prefix.end(),
+                     [](auto const& left, auto const& right) { return left.first < right.first; });
+
+    std::vector<Candidate> next_level;
+    // Candidate of this level and the column that extends it into the next level candidate
+    std::vector<std::pair<CandidateId, size_t>> generators;
+    for (auto group_begin = by_prefix.begin(); group_begin != by_prefix.end();) {
+        auto const group_end = std::find_if(
+                group_begin, by_prefix.end(),
+                [&group_begin](auto const& entry) { return entry.first != group_begin->first; });
+        for (auto i = group_begin; i != group_end; ++i) {
+            Candidate const& candidate_i = candidates_[i->second];
+            for (auto j = std::next(i); j != group_end; ++j) {
+                Candidate const& candidate_j = candidates_[j->second];
+                if (candidate_j.attrs.is_subset_of(candidate_i.closure) ||
+                    candidate_i.attrs.is_subset_of(candidate_j.closure)) {
+                    continue;
                 }
-            }
-            //
-
-            if (similar) {
-                candidate_ij = candidate_i | candidate_j;
-
-                if (!(candidate_j).is_subset_of(fd_set_[candidate_i]) &&
-                    !(candidate_i).is_subset_of(fd_set_[candidate_j])) {
-                    if (candidate_i.count() == 1) {
-                        auto candidate_i_pli = relation_->GetColumnData(candidate_i.find_first())
-                                                   .GetPositionListIndex();
-                        auto candidate_j_pli = relation_->GetColumnData(candidate_j.find_first())
-                                                   .GetPositionListIndex();
-                        plis_[candidate_ij] = candidate_i_pli->Intersect(candidate_j_pli);
-                    } else {
-                        plis_[candidate_ij] =
-                            plis_[candidate_i]->Intersect(plis_[candidate_j].get());
-                    }
 
-                    auto closure_ij = closure_[candidate_i] | closure_[candidate_j];
-                    if (relation_indices_ == (candidate_ij | closure_ij)) {
-                        key_set_.insert(candidate_ij);
-                    } else {
-                        candidate_set_.insert(candidate_ij);
-                    }
+                dynamic_bitset<> candidate_ij = candidate_i.attrs | candidate_j.attrs;
+                auto closure_ij = candidate_i.closure | candidate_j.closure;
+                if (relation_indices_ == (candidate_ij | closure_ij)) {
+                    // A key, its supersets are not needed
+                    continue;
                 }
+                Candidate next;
+                next.attrs = std::move(candidate_ij);
+                next_level.push_back(std::move(next));
+                size_t const added_column = (candidate_j.attrs - candidate_i.attrs).find_first();
+                generators.emplace_back(i->second, added_column);
             }
         }
-
-        candidate_set_.erase(candidate_i);
+        group_begin = group_end;
     }
+
+    std::vector<size_t> next_ids(next_level.size());
+    std::iota(next_ids.begin(), next_ids.end(), 0);
+    auto const intersect = [this, &next_level, &generators](size_t id) {
+        auto const [generator_id, column_index] = generators[id];
+        model::PositionListIndex const* column_pli =
+                relation_->GetColumnData(column_index).GetPositionListIndex();
+        next_level[id].pli =
+                candidates_[generator_id].pli->Probe(column_pli->CalculateAndGetProbingTable());
+    };
+    util::parallel_foreach(next_ids.begin(), next_ids.end(), threads_num_, intersect);
+
+    auto const by_attrs = [](Candidate const& left, Candidate const& right) {
+        return left.attrs < right.attrs;
+    };
+    std::sort(next_level.begin(), next_level.end(), by_attrs);
+    std::move(next_level.begin(), next_level.end(), std::back_inserter(candidates_));
 }
 
 void Fd_mine::Reconstruct() {
-    std::queue<dynamic_bitset<>> queue;
-    dynamic_bitset<> generated_lhs(relation_indices_.size());
-    dynamic_bitset<> generated_lhs_tmp(relation_indices_.size());
-
-    for (const auto &[lhs, rhs] : fd_set_) {
-        std::unordered_map<dynamic_bitset<>, bool> observed;
-
-        observed[lhs] = true;
-        auto rhs_copy = rhs;
-        queue.push(lhs);
+    std::vector<CandidateId> with_equivalents;
+    for (CandidateId id = 0; id != candidates_.size(); ++id) {
+        if (!candidates_[id].equivalents.empty()) {
+            with_equivalents.push_back(id);
+        }
+    }
 
-        for (const auto &[eq, eqset] : eq_set_) {
-            if (eq.is_subset_of(rhs_copy)) {
-                for (const auto& eq_rhs : eqset) {
-                    rhs_copy |= eq_rhs;
+    // Left-hand sides obtained by substituting equivalent column sets and their common right-hand
+    // side, for every candidate
+    std::vector<std::pair<std::vector<dynamic_bitset<>>, dynamic_bitset<>>> fds(
+            candidates_.size());
+    std::vector<CandidateId> ids(candidates_.size());
+    std::iota(ids.begin(), ids.end(), 0);
+
+    auto const reconstruct = [this, &with_equivalents, &fds](CandidateId id) {
+        auto& [lhss, rhs] = fds[id];
+        rhs = candidates_[id].closure;
+        bool rhs_changed = true;
+        while (rhs_changed) {
+            rhs_changed = false;
+            for (CandidateId eq : with_equivalents) {
+                if (!candidates_[eq].attrs.is_subset_of(rhs)) {
+                    continue;
                 }
-            }
-        }
-        bool rhs_will_not_change = false;
-
-        while (!queue.empty()) {
-            dynamic_bitset<> current_lhs = queue.front();
-            queue.pop();
-            size_t rhs_count = rhs_copy.count();
-            for (const auto &[eq, eqset] : eq_set_) {
-                if (!rhs_will_not_change && eq.is_subset_of(rhs_copy)) {
-                    for (const auto& eq_rhs : eqset) {
-                        rhs_copy |= eq_rhs;
+                for (CandidateId eq_rhs : candidates_[eq].equivalents) {
+                    if (!candidates_[eq_rhs].attrs.is_subset_of(rhs)) {
+                        rhs |= candidates_[eq_rhs].attrs;
+                        rhs_changed = true;
                     }
                 }
+            }
+        }
 
-                if (eq.is_subset_of(current_lhs)) {
-                    generated_lhs_tmp = current_lhs - eq;
-                    for (const auto& new_eq : eqset) {
-                        generated_lhs = generated_lhs_tmp;
-                        generated_lhs |= new_eq;
-
-                        if (!observed[generated_lhs]) {
-                            queue.push(generated_lhs);
-                            observed[generated_lhs] = true;
-                        }
+        std::unordered_set<dynamic_bitset<>> observed{candidates_[id].attrs};
+        lhss.push_back(candidates_[id].attrs);
+        for (size_t processed = 0; processed != lhss.size(); ++processed) {
+            for (CandidateId eq : with_equivalents) {
+                if (!candidates_[eq].attrs.is_subset_of(lhss[processed])) {
+                    continue;
+                }
+                dynamic_bitset<> const generated_lhs_tmp = lhss[processed] - candidates_[eq].attrs;
+                for (CandidateId new_eq : candidates_[eq].equivalents) {
+                    dynamic_bitset<> generated_lhs = generated_lhs_tmp | candidates_[new_eq].attrs;
+                    if (observed.insert(generated_lhs).second) {
+                        lhss.push_back(std::move(generated_lhs));
                     }
                 }
             }
-            if (rhs_count == rhs_copy.count()) {
-                rhs_will_not_change = true;
-            }
         }
-
-        for (auto &[lhs, rbool] : observed) {
-            if (final_fd_set_.count(lhs)) {
-                final_fd_set_[lhs] |= rhs_copy;
-            } else {
-                final_fd_set_[lhs] = rhs_copy;
+    };
+    util::parallel_foreach(ids.begin(), ids.end(), threads_num_, reconstruct);
+
+    for (auto const& [lhss, rhs] : fds) {
+        for (dynamic_bitset<> const& lhs : lhss) {
+            auto const [it, inserted] = final_fd_set_.try_emplace(lhs, rhs);
+            if (!inserted) {
+                it->second |= rhs;
             }
         }
     }
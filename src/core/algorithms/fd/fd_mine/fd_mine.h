@@ -1,12 +1,14 @@
 #pragma once
 
-#include <filesystem>
-#include <set>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/dynamic_bitset.hpp>
-#include <boost/unordered_map.hpp>
 
 #include "algorithms/fd/pli_based_fd_algorithm.h"
+#include "config/thread_number/type.h"
 #include "model/table/column_layout_relation_data.h"
 #include "model/table/position_list_index.h"
 #include "model/table/vertical.h"
@@ -15,28 +17,39 @@ namespace algos {
 
 class Fd_mine : public PliBasedFDAlgorithm {
 private:
+    using CandidateId = std::uint32_t;
+
+    struct Candidate {
+        boost::dynamic_bitset<> attrs;
+        // Columns outside of attrs that are functionally determined by attrs
+        boost::dynamic_bitset<> closure;
+        // Kept only while the candidates of the next level are generated
+        std::shared_ptr<model::PositionListIndex const> pli;
+        // Candidates equivalent to this one, every pair is stored on both sides once
+        std::vector<CandidateId> equivalents;
+        bool is_key = false;
+    };
+
     const RelationalSchema* schema_;
+    config::ThreadNumType threads_num_ = 1;
 
-    std::set<boost::dynamic_bitset<>> candidate_set_;
-    boost::unordered_map<boost::dynamic_bitset<>, std::unordered_set<boost::dynamic_bitset<>>>
-            eq_set_;
-    boost::unordered_map<boost::dynamic_bitset<>, boost::dynamic_bitset<>> fd_set_;
-    boost::unordered_map<boost::dynamic_bitset<>, boost::dynamic_bitset<>> final_fd_set_;
-    std::set<boost::dynamic_bitset<>> key_set_;
-    boost::unordered_map<boost::dynamic_bitset<>, boost::dynamic_bitset<>> closure_;
-    boost::unordered_map<boost::dynamic_bitset<>, std::shared_ptr<model::PositionListIndex const>>
-            plis_;
+    // Every candidate that has been processed, levels are stored one after another and each level
+    // is sorted by attrs
+    std::vector<Candidate> candidates_;
+    std::unordered_map<boost::dynamic_bitset<>, boost::dynamic_bitset<>> final_fd_set_;
     boost::dynamic_bitset<> relation_indices_;
 
-    void ComputeNonTrivialClosure(boost::dynamic_bitset<> const& xi);
-    void ObtainFDandKey(boost::dynamic_bitset<> const& xi);
-    void ObtainEqSet();
-    void PruneCandidates();
-    void GenerateNextLevelCandidates();
+    void ComputeNonTrivialClosure(Candidate& xi) const;
+    // Finds the equivalences between the candidates of the level starting at level_begin and all
+    // candidates processed so far
+    void ObtainEqSet(CandidateId level_begin);
+    std::vector<CandidateId> PruneCandidates(CandidateId level_begin) const;
+    void GenerateNextLevelCandidates(std::vector<CandidateId> const& level);
     void Reconstruct();
     void Display();
 
     void ResetStateFd() final;
+    void MakeExecuteOptsAvailable() final;
     unsigned long long ExecuteInternal() override;
 
 public:
@@ -2,8 +2,6 @@
 
 #include <chrono>
 
-#include "model/table/column_layout_relation_data.h"
-
 //#ifndef PRINT_FDS
 //#define PRINT_FDS
 //#endif
@@ -13,27 +11,14 @@ namespace algos {
 FDep::FDep() : FDAlgorithm({kDefaultPhaseName}) {}
 
 void FDep::LoadDataInternal() {
-    number_attributes_ = input_table_->GetNumberOfColumns();
+    relation_ = model::ColumnLayoutEncodedRelationData::CreateFrom(*input_table_);
+    number_attributes_ = relation_->GetNumColumns();
     if (number_attributes_ == 0) {
         throw std::runtime_error("Unable to work on an empty dataset.");
     }
     column_names_.resize(number_attributes_);
-
-    schema_ = std::make_unique<RelationalSchema>(input_table_->GetRelationName());
-
     for (size_t i = 0; i < number_attributes_; ++i) {
-        column_names_[i] = input_table_->GetColumnName(static_cast<int>(i));
-        schema_->AppendColumn(column_names_[i]);
-    }
-
-    std::vector<std::string> next_line;
-    while (input_table_->HasNextRow()) {
-        next_line = input_table_->GetNextRow();
-        if (next_line.empty()) break;
-        tuples_.emplace_back(std::vector<size_t>(number_attributes_));
-        for (size_t i = 0; i < number_attributes_; ++i) {
-            tuples_.back()[i] = std::hash<std::string>{}(next_line[i]);
-        }
+        column_names_[i] = relation_->GetSchema()->GetColumn(i)->GetName();
     }
 }
 
@@ -48,15 +33,13 @@ unsigned long long FDep::ExecuteInternal() {
 
     BuildNegativeCover();
 
-    this->tuples_.shrink_to_fit();
-
     this->pos_cover_tree_ = std::make_unique<FDTreeElement>(this->number_attributes_);
     this->pos_cover_tree_->AddMostGeneralDependencies();
 
     std::bitset<FDTreeElement::kMaxAttrNum> active_path;
     CalculatePositiveCover(*this->neg_cover_tree_, active_path);
 
-    pos_cover_tree_->FillFdCollection(*this->schema_, FdList());
+    pos_cover_tree_->FillFdCollection(*relation_->GetSchema(), FdList());
 
     auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now() - start_time);
@@ -70,21 +53,23 @@ unsigned long long FDep::ExecuteInternal() {
 
 void FDep::BuildNegativeCover() {
     this->neg_cover_tree_ = std::make_unique<FDTreeElement>(this->number_attributes_);
-    for (auto i = this->tuples_.begin(); i != this->tuples_.end(); ++i) {
-        for (auto j = i + 1; j != this->tuples_.end(); ++j)
-            AddViolatedFDs(*i, *j);
+    size_t const num_rows = relation_->GetNumRows();
+    for (size_t i = 0; i < num_rows; ++i) {
+        for (size_t j = i + 1; j < num_rows; ++j)
+            AddViolatedFDs(i, j);
     }
 
     this->neg_cover_tree_->FilterSpecializations();
 }
 
-void FDep::AddViolatedFDs(std::vector<size_t> const& t1, std::vector<size_t> const& t2) {
+void FDep::AddViolatedFDs(size_t t1, size_t t2) {
     std::bitset<FDTreeElement::kMaxAttrNum> equal_attr((2 << this->number_attributes_) - 1);
     equal_attr.reset(0);
     std::bitset<FDTreeElement::kMaxAttrNum> diff_attr;
 
+    std::vector<model::EncodedColumnData> const& columns = relation_->GetColumnData();
     for (size_t attr = 0; attr < this->number_attributes_; ++attr) {
-        diff_attr[attr + 1] = (t1[attr] != t2[attr]);
+        diff_attr[attr + 1] = (columns[attr].GetValueId(t1) != columns[attr].GetValueId(t2));
     }
 
     equal_attr &= (~diff_attr);
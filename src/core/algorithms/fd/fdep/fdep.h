@@ -5,8 +5,7 @@
 
 #include "algorithms/fd/fd_algorithm.h"
 #include "algorithms/fd/fdep/fd_tree_element.h"
-#include "model/table/relation_data.h"
-#include "model/table/relational_schema.h"
+#include "model/table/column_layout_encoded_relation_data.h"
 
 namespace algos {
 
@@ -17,7 +16,7 @@ public:
     ~FDep() override = default;
 
 private:
-    std::unique_ptr<RelationalSchema> schema_{};
+    std::unique_ptr<model::ColumnLayoutEncodedRelationData> relation_;
 
     std::vector<std::string> column_names_;
     size_t number_attributes_{};
@@ -25,8 +24,6 @@ private:
     std::unique_ptr<FDTreeElement> neg_cover_tree_{};
     std::unique_ptr<FDTreeElement> pos_cover_tree_{};
 
-    std::vector<std::vector<size_t>> tuples_;
-
     void LoadDataInternal() final;
 
     void ResetStateFd() final;
@@ -37,7 +34,7 @@ private:
 
     // Iterating over all pairs t1 and t2 of the relation
     // Adding violated FDs to negative cover tree.
-    void AddViolatedFDs(const std::vector<size_t>& t1, const std::vector<size_t>& t2);
+    void AddViolatedFDs(size_t t1, size_t t2);
 
     // Converting negative cover tree into positive cover tree
     void CalculatePositiveCover(FDTreeElement const& neg_cover_subtree,
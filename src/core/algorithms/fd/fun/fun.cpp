@@ -1,7 +1,15 @@
 #include "fun.h"
 
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <unordered_set>
+
 #include <easylogging++.h>
 
+#include "config/thread_number/option.h"
+#include "util/parallel_for.h"
+
 namespace algos {
 
 FunQuadruple FunQuadruple::Union(Column const& that) const {
@@ -20,7 +28,13 @@ bool FunQuadruple::Contains(Vertical const& that) const {
     return candidate_.Contains(that);
 }
 
-FUN::FUN() : PliBasedFDAlgorithm({kDefaultPhaseName}) {}
+FUN::FUN() : PliBasedFDAlgorithm({kDefaultPhaseName}) {
+    RegisterOption(config::ThreadNumberOpt(&threads_num_));
+}
+
+void FUN::MakeExecuteOptsAvailable() {
+    MakeOptionsAvailable({config::ThreadNumberOpt.GetName()});
+}
 
 void FUN::ResetStateFd() {
     fds_.clear();
@@ -30,123 +44,134 @@ bool FUN::IsKey(FunQuadruple const& l) const {
     return l.GetCount() == relation_->GetNumRows();
 }
 
+FUN::LevelIndex FUN::IndexLevel(Level const& level) {
+    LevelIndex index(level.size());
+    for (FunQuadruple const& l : level) {
+        index.emplace(l.GetCandidate().GetColumnIndices(), &l);
+    }
+    return index;
+}
+
 void FUN::DisplayFD(Level const& l_k_minus_1) {
     for (FunQuadruple const& l : l_k_minus_1) {
         /*  our other algorithms mine l.candidate.GetArity() == 0,
          *  while Metanome's FUN explicitly ignores
          */
+        boost::dynamic_bitset<> const& lhs = l.GetCandidate().GetColumnIndicesRef();
         for (Column const* rhs : l.GetClosure().Without(l.GetQuasiclosure()).GetColumns()) {
-            fds_.try_emplace(*rhs, std::set<Vertical>());
-            bool subset_exists_already = false;
-            for (Vertical const& lhs : fds_.at(*rhs)) {
-                if (l.Contains(lhs)) {
-                    subset_exists_already = true;
-                    break;
-                }
-            }
-            if (!subset_exists_already) {
-                fds_.at(*rhs).emplace(l.GetCandidate());
+            util::BitsetTrie& lhss = fds_[rhs->GetIndex()];
+            if (!lhss.ContainsSubsetOf(lhs)) {
+                lhss.Insert(lhs);
             }
         }
     }
 }
 
-void FUN::PurePrune(Level const& l_k_minus_1, Level& l_k) const {
-    for (auto l = l_k.begin(); l != l_k.end();) {
-        bool erased = false;
-        for (FunQuadruple const& s : l_k_minus_1) {
-            if (l->GetCount() == s.GetCount() && l->Contains(s)) {
-                l = l_k.erase(l);
-                erased = true;
-                break;
+void FUN::PurePrune(LevelIndex const& l_k_minus_1_index, Level& l_k) const {
+    auto const has_subset_with_same_count = [&l_k_minus_1_index](FunQuadruple const& l) {
+        boost::dynamic_bitset<> subset = l.GetCandidate().GetColumnIndices();
+        for (size_t i = subset.find_first(); i != boost::dynamic_bitset<>::npos;
+             i = subset.find_next(i)) {
+            subset.reset(i);
+            auto const it = l_k_minus_1_index.find(subset);
+            subset.set(i);
+            if (it != l_k_minus_1_index.end() && it->second->GetCount() == l.GetCount()) {
+                return true;
             }
         }
-        if (!erased) {
-            l++;
-        }
-    }
+        return false;
+    };
+    l_k.erase(std::remove_if(l_k.begin(), l_k.end(), has_subset_with_same_count), l_k.end());
 }
 
-void FUN::ComputeClosure(Level& l_k_minus_1, Level const& l_k) const {
-    for (FunQuadruple& l : l_k_minus_1) {
+void FUN::ComputeClosure(Level& l_k_minus_1, LevelIndex const& l_k_minus_1_index,
+                         LevelIndex const& l_k_index) const {
+    auto const compute_closure = [this, &l_k_minus_1_index, &l_k_index](FunQuadruple& l) {
         if (IsKey(l)) {
-            continue;
+            return;
         }
-        l.SetClosure(l.GetQuasiclosure());
+        Vertical closure = l.GetQuasiclosure();
         for (Column const* A : r_prime_.Without(l.GetQuasiclosure()).GetColumns()) {
-            if (FastCount(l_k_minus_1, l_k, l.Union(*A)) == l.GetCount()) {
-                l.SetClosure(l.GetClosure().Union(*A));
+            boost::dynamic_bitset<> l_with_a = l.GetCandidate().GetColumnIndices();
+            l_with_a.set(A->GetIndex());
+            if (FastCount(l_k_minus_1_index, l_k_index, std::move(l_with_a)) == l.GetCount()) {
+                closure = closure.Union(*A);
             }
         }
-    }
+        l.SetClosure(closure);
+    };
+    util::parallel_foreach(l_k_minus_1.begin(), l_k_minus_1.end(), threads_num_, compute_closure);
 }
 
-void FUN::ComputeQuasiClosure(Level const& l_k_minus_1, Level& l_k) const {
-    for (FunQuadruple& l : l_k) {
+void FUN::ComputeQuasiClosure(LevelIndex const& l_k_minus_1_index, Level& l_k) const {
+    auto const compute_quasiclosure = [this, &l_k_minus_1_index](FunQuadruple& l) {
         if (IsKey(l)) {
             l.SetClosure(r_);
         }
-        l.SetQuasiclosure(l.GetCandidate());
-        for (FunQuadruple const& s : l_k_minus_1) {
-            if (l.Contains(s)) {
-                l.SetQuasiclosure(l.GetQuasiclosure().Union(s.GetClosure()));
+        Vertical quasiclosure = l.GetCandidate();
+        boost::dynamic_bitset<> subset = l.GetCandidate().GetColumnIndices();
+        for (size_t i = subset.find_first(); i != boost::dynamic_bitset<>::npos;
+             i = subset.find_next(i)) {
+            subset.reset(i);
+            if (auto const it = l_k_minus_1_index.find(subset); it != l_k_minus_1_index.end()) {
+                quasiclosure = quasiclosure.Union(it->second->GetClosure());
             }
+            subset.set(i);
         }
-    }
+        l.SetQuasiclosure(quasiclosure);
+    };
+    util::parallel_foreach(l_k.begin(), l_k.end(), threads_num_, compute_quasiclosure);
 }
 
-unsigned long FUN::Count(Vertical const& l) const {
-    std::vector<ColumnData> const& column_data = relation_->GetColumnData();
-    size_t first_column_index = l.GetColumnIndices().find_first();
-
-    model::PositionListIndex const* pli = column_data.at(first_column_index).GetPositionListIndex();
-
-    if (l.GetColumnIndices().count() == 1) {
-        return pli->GetNumCluster();
-    }
-
-    //  workaround to avoid auto-destruction of plis
-    std::unique_ptr<model::PositionListIndex> holder;
-
-    for (size_t i = l.GetColumnIndices().find_next(first_column_index);
-         i != boost::dynamic_bitset<>::npos; i = l.GetColumnIndices().find_next(i)) {
-        pli->Intersect(column_data.at(i).GetPositionListIndex()).swap(holder);
-        pli = holder.get();
-    }
-
-    return pli->GetNumCluster();
-}
-
-unsigned long FUN::FastCount(Level const& l_k_minus_1, Level const& l_k,
-                             FunQuadruple const& l) const {
-    auto position_at_l_k = std::find(l_k.begin(), l_k.end(), l);
-    if (position_at_l_k != l_k.end()) {
-        return position_at_l_k->GetCount();
+unsigned long FUN::FastCount(LevelIndex const& l_k_minus_1_index, LevelIndex const& l_k_index,
+                             boost::dynamic_bitset<> l) const {
+    if (auto const it = l_k_index.find(l); it != l_k_index.end()) {
+        return it->second->GetCount();
     }
     unsigned long max = 0;
-    for (FunQuadruple const& l_prime : l_k_minus_1) {
-        if (l.Contains(l_prime)) {
-            max = std::max(max, l_prime.GetCount());
+    for (size_t i = l.find_first(); i != boost::dynamic_bitset<>::npos; i = l.find_next(i)) {
+        l.reset(i);
+        if (auto const it = l_k_minus_1_index.find(l); it != l_k_minus_1_index.end()) {
+            max = std::max(max, it->second->GetCount());
         }
+        l.set(i);
     }
     return max;
 }
 
-std::list<FunQuadruple> FUN::GenerateCandidate(Level const& l_k) const {
-    std::set<FunQuadruple> l_k_plus_1;
+FUN::Level FUN::GenerateCandidate(Level& l_k) const {
+    Level l_k_plus_1;
+    // Generator of every candidate and the column it was extended with
+    std::vector<std::pair<FunQuadruple const*, Column const*>> generators;
+    std::unordered_set<boost::dynamic_bitset<>> generated;
     for (FunQuadruple const& l_prime : l_k) {
         if (IsKey(l_prime)) {
             continue;
         }
         for (Column const* A : r_prime_.Without(l_prime.GetCandidate()).GetColumns()) {
             FunQuadruple l = l_prime.Union(*A);
-            if (l_k_plus_1.find(l) == l_k_plus_1.end()) {
-                l.SetCount(Count(l.GetCandidate()));
-                l_k_plus_1.emplace(l);
+            if (generated.insert(l.GetCandidate().GetColumnIndices()).second) {
+                l_k_plus_1.push_back(std::move(l));
+                generators.emplace_back(&l_prime, A);
             }
         }
     }
-    return {l_k_plus_1.begin(), l_k_plus_1.end()};
+
+    std::vector<ColumnData> const& column_data = relation_->GetColumnData();
+    std::vector<size_t> candidate_ids(l_k_plus_1.size());
+    std::iota(candidate_ids.begin(), candidate_ids.end(), 0);
+    auto const count = [&l_k_plus_1, &generators, &column_data](size_t id) {
+        auto const [generator, A] = generators[id];
+        std::shared_ptr<model::PositionListIndex const> pli = generator->GetPli()->Intersect(
+                column_data[A->GetIndex()].GetPositionListIndex());
+        l_k_plus_1[id].SetPli(std::move(pli));
+    };
+    util::parallel_foreach(candidate_ids.begin(), candidate_ids.end(), threads_num_, count);
+
+    for (FunQuadruple& l : l_k) {
+        l.ReleasePli();
+    }
+    return l_k_plus_1;
 }
 
 unsigned long long FUN::ExecuteInternal() {
@@ -156,40 +181,43 @@ unsigned long long FUN::ExecuteInternal() {
     AddProgress(progress_step);
     Vertical empty_vertical = *schema_->empty_vertical_;
 
+    fds_.assign(schema_->GetNumColumns(), util::BitsetTrie(schema_->GetNumColumns()));
     r_ = empty_vertical;
     r_prime_ = empty_vertical;
     Level l_k_minus_1{FunQuadruple(empty_vertical)};
     Level l_k;
     for (std::unique_ptr<Column> const& A : schema_->GetColumns()) {
         FunQuadruple attribute(*A);
-        attribute.SetCount(Count(attribute.GetCandidate()));
-        l_k.push_back(attribute);
+        attribute.SetPli(relation_->GetColumnData(A->GetIndex()).GetPliOwnership());
         r_ = r_.Union(*A);
         if (!IsKey(attribute)) {
             r_prime_ = r_prime_.Union(*A);
         }
         if (attribute.GetCount() == 1) {
-            fds_.emplace(*A, std::set<Vertical>{empty_vertical});
+            fds_[A->GetIndex()].Insert(empty_vertical.GetColumnIndices());
         }
+        l_k.push_back(std::move(attribute));
     }
 
     while (!l_k.empty()) {
-        ComputeClosure(l_k_minus_1, l_k);
-        ComputeQuasiClosure(l_k_minus_1, l_k);
+        LevelIndex const l_k_minus_1_index = IndexLevel(l_k_minus_1);
+        ComputeClosure(l_k_minus_1, l_k_minus_1_index, IndexLevel(l_k));
+        ComputeQuasiClosure(l_k_minus_1_index, l_k);
         DisplayFD(l_k_minus_1);
-        PurePrune(l_k_minus_1, l_k);
-        l_k_minus_1 = l_k;
-        l_k = GenerateCandidate(l_k);
+        PurePrune(l_k_minus_1_index, l_k);
+        l_k_minus_1 = std::move(l_k);
+        l_k = GenerateCandidate(l_k_minus_1);
         AddProgress(progress_step);
     }
     DisplayFD(l_k_minus_1);
 
     int total_fds = 0;
-    for (auto const& [rhs, lverticals] : fds_) {
-        for (Vertical const& lhs : lverticals) {
-            RegisterFd(lhs, rhs);
+    for (size_t rhs_index = 0; rhs_index < fds_.size(); ++rhs_index) {
+        Column const& rhs = *schema_->GetColumn(rhs_index);
+        fds_[rhs_index].ForEach([this, &rhs, &total_fds](boost::dynamic_bitset<> const& lhs) {
+            RegisterFd(Vertical(schema_, lhs), rhs);
             total_fds++;
-        }
+        });
     }
 
     SetProgress(kTotalProgressPercent);
@@ -1,8 +1,15 @@
 #pragma once
 
-#include <set>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
 
 #include "algorithms/fd/pli_based_fd_algorithm.h"
+#include "config/thread_number/type.h"
+#include "model/table/position_list_index.h"
+#include "util/bitset_trie.h"
 #include "util/custom_hashes.h"
 
 namespace algos {
@@ -13,6 +20,8 @@ private:
     unsigned long count_;
     Vertical quasiclosure_;
     Vertical closure_;
+    // Partition of the candidate, kept only while the next level is generated from it
+    std::shared_ptr<model::PositionListIndex const> pli_;
 
 public:
     explicit FunQuadruple(Vertical const& candidate)
@@ -38,6 +47,20 @@ public:
         return quasiclosure_;
     }
 
+    std::shared_ptr<model::PositionListIndex const> const& GetPli() const {
+        return pli_;
+    }
+
+    // Sets the partition of the candidate together with the count it determines
+    void SetPli(std::shared_ptr<model::PositionListIndex const> pli) {
+        count_ = pli->GetNumCluster();
+        pli_ = std::move(pli);
+    }
+
+    void ReleasePli() {
+        pli_.reset();
+    }
+
     void SetCount(unsigned long new_count) {
         count_ = new_count;
     }
@@ -84,30 +107,40 @@ private:
     Vertical r_;
     Vertical r_prime_;
 
-    using Level = std::list<FunQuadruple>;
+    using Level = std::vector<FunQuadruple>;
+    // All candidates of a level have the same arity, so the only candidates of the previous level
+    // that a candidate contains are its subsets without one column. Looking them up by their
+    // column indices replaces scanning the whole previous level.
+    using LevelIndex = std::unordered_map<boost::dynamic_bitset<>, FunQuadruple const*>;
 
     void ResetStateFd() final;
+    void MakeExecuteOptsAvailable() final;
     unsigned long long ExecuteInternal() final;
 
-    Level GenerateCandidate(Level const& l_k) const;
+    static LevelIndex IndexLevel(Level const& level);
 
-    void ComputeClosure(Level& l_k_minus_1, Level const& l_k) const;
+    // Generates the next level, counting the candidates in parallel by intersecting the partition
+    // of their first found generator with the added column. Releases the partitions of l_k.
+    Level GenerateCandidate(Level& l_k) const;
 
-    unsigned long Count(Vertical const& l) const;
+    void ComputeClosure(Level& l_k_minus_1, LevelIndex const& l_k_minus_1_index,
+                        LevelIndex const& l_k_index) const;
 
-    unsigned long FastCount(Level const& l_k_minus_1, Level const& l_k,
-                            FunQuadruple const& l) const;
+    unsigned long FastCount(LevelIndex const& l_k_minus_1_index, LevelIndex const& l_k_index,
+                            boost::dynamic_bitset<> l) const;
 
-    void ComputeQuasiClosure(Level const& l_k_minus_1, Level& l_k) const;
+    void ComputeQuasiClosure(LevelIndex const& l_k_minus_1_index, Level& l_k) const;
 
-    void PurePrune(Level const& l_k_minus_1, Level& l_k) const;
+    void PurePrune(LevelIndex const& l_k_minus_1_index, Level& l_k) const;
 
     void DisplayFD(Level const& l_k_minus_1);
 
     // Supporting entities
 private:
     RelationalSchema const* schema_;
-    std::unordered_map<Column, std::set<Vertical>> fds_;
+    config::ThreadNumType threads_num_ = 1;
+    // Minimal LHSs found so far for every RHS column
+    std::vector<util::BitsetTrie> fds_;
 
     bool IsKey(FunQuadruple const& l) const;
 };
@@ -28,9 +28,10 @@ public:
      * If the storage had no such combination, it is added to the last-access storage as well.
      *
      * @param column_set column combination
+     * @return true if the combination was not stored before
      */
-    void Add(boost::dynamic_bitset<>&& column_set);
-    void Add(boost::dynamic_bitset<> const& column_set);
+    bool Add(boost::dynamic_bitset<>&& column_set);
+    bool Add(boost::dynamic_bitset<> const& column_set);
 
     /**
      * @return Number of column sets stored in the last-access storage.
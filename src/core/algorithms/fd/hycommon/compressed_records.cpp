@@ -0,0 +1,75 @@
+#include "compressed_records.h"
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
+namespace algos::hy {
+
+CompressedRecords::CompressedRecords(Columns const& inverted_plis)
+    : num_rows_(inverted_plis.empty() ? 0 : inverted_plis.front().size()),
+      num_columns_(inverted_plis.size()) {
+    ClusterId max_cluster_id = 0;
+    for (auto const& column : inverted_plis) {
+        for (ClusterId cluster_id : column) {
+            if (!PLIUtil::IsSingletonCluster(cluster_id)) {
+                max_cluster_id = std::max(max_cluster_id, cluster_id);
+            }
+        }
+    }
+    is_narrow_ = max_cluster_id < std::numeric_limits<NarrowId>::max();
+
+    auto fill = [this, &inverted_plis](auto& ids) {
+        using Id = typename std::remove_reference_t<decltype(ids)>::value_type;
+        ids.resize(num_rows_ * num_columns_);
+        for (size_t column = 0; column < num_columns_; ++column) {
+            for (size_t row = 0; row < num_rows_; ++row) {
+                ClusterId const cluster_id = inverted_plis[column][row];
+                ids[row * num_columns_ + column] = PLIUtil::IsSingletonCluster(cluster_id)
+                                                           ? std::numeric_limits<Id>::max()
+                                                           : static_cast<Id>(cluster_id);
+            }
+        }
+    };
+    if (is_narrow_) {
+        fill(narrow_ids_);
+    } else {
+        fill(wide_ids_);
+    }
+}
+
+template <typename Id>
+boost::dynamic_bitset<> CompressedRecords::GetAgreeSet(std::vector<Id> const& ids,
+                                                       size_t first_row,
+                                                       size_t second_row) const {
+    using Block = boost::dynamic_bitset<>::block_type;
+    constexpr size_t kBitsPerBlock = boost::dynamic_bitset<>::bits_per_block;
+    constexpr Id kSingletonId = std::numeric_limits<Id>::max();
+
+    Id const* first = ids.data() + first_row * num_columns_;
+    Id const* second = ids.data() + second_row * num_columns_;
+
+    boost::dynamic_bitset<> agree_set;
+    // Branch-free comparison of a block worth of columns at a time, so that the inner loop can be
+    // vectorized
+    for (size_t begin = 0; begin < num_columns_; begin += kBitsPerBlock) {
+        size_t const block_size = std::min(kBitsPerBlock, num_columns_ - begin);
+        Block block = 0;
+        for (size_t i = 0; i < block_size; ++i) {
+            Id const value = first[begin + i];
+            Block const agrees = (value == second[begin + i]) & (value != kSingletonId);
+            block |= agrees << i;
+        }
+        agree_set.append(block);
+    }
+    agree_set.resize(num_columns_);
+    return agree_set;
+}
+
+boost::dynamic_bitset<> CompressedRecords::GetAgreeSet(size_t first_row, size_t second_row) const {
+    assert(first_row < num_rows_ && second_row < num_rows_);
+    return is_narrow_ ? GetAgreeSet(narrow_ids_, first_row, second_row)
+                      : GetAgreeSet(wide_ids_, first_row, second_row);
+}
+
+}  // namespace algos::hy
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "algorithms/fd/hycommon/types.h"
+#include "algorithms/fd/hycommon/util/pli_util.h"
+
+namespace algos::hy {
+
+// Cluster ids of all the records, stored row-major in one contiguous array. Ids are stored as
+// 16-bit values if all of them fit and as 32-bit values otherwise. The maximum value of the
+// storage type stands for the singleton cluster, it is read back as PLIUtil::kSingletonClusterId.
+class CompressedRecords {
+private:
+    using NarrowId = std::uint16_t;
+    using WideId = std::uint32_t;
+    static_assert(sizeof(ClusterId) == sizeof(WideId));
+
+    size_t num_rows_;
+    size_t num_columns_;
+    bool is_narrow_;
+    std::vector<NarrowId> narrow_ids_;
+    std::vector<WideId> wide_ids_;
+
+    template <typename Id>
+    static ClusterId ToClusterId(Id id) noexcept {
+        return id == std::numeric_limits<Id>::max() ? PLIUtil::kSingletonClusterId
+                                                    : static_cast<ClusterId>(id);
+    }
+
+    ClusterId GetAt(size_t index) const noexcept {
+        return is_narrow_ ? ToClusterId(narrow_ids_[index]) : ToClusterId(wide_ids_[index]);
+    }
+
+    template <typename Id>
+    boost::dynamic_bitset<> GetAgreeSet(std::vector<Id> const& ids, size_t first_row,
+                                        size_t second_row) const;
+
+public:
+    class RowView {
+    private:
+        CompressedRecords const* records_;
+        size_t offset_;
+
+    public:
+        RowView(CompressedRecords const* records, size_t row) noexcept
+            : records_(records), offset_(row * records->num_columns_) {}
+
+        ClusterId operator[](size_t column) const noexcept {
+            return records_->GetAt(offset_ + column);
+        }
+
+        size_t size() const noexcept {
+            return records_->num_columns_;
+        }
+    };
+
+    // Builds records from the cluster ids of every column, i.e. from inverted PLIs
+    explicit CompressedRecords(Columns const& inverted_plis);
+
+    size_t GetNumRows() const noexcept {
+        return num_rows_;
+    }
+
+    size_t GetNumColumns() const noexcept {
+        return num_columns_;
+    }
+
+    ClusterId Get(size_t row, size_t column) const noexcept {
+        return GetAt(row * num_columns_ + column);
+    }
+
+    RowView operator[](size_t row) const noexcept {
+        return RowView(this, row);
+    }
+
+    // Returns the set of columns in which both records belong to the same non-singleton cluster
+    boost::dynamic_bitset<> GetAgreeSet(size_t first_row, size_t second_row) const;
+};
+
+}  // namespace algos::hy
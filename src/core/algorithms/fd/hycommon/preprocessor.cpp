@@ -45,21 +45,6 @@ algos::hy::Columns BuildInvertedPlis(algos::hy::PLIs const& plis) {
     return inverted_plis;
 }
 
-algos::hy::Rows BuildRecordRepresentation(algos::hy::Columns const& inverted_plis) {
-    size_t const num_columns = inverted_plis.size();
-    size_t const num_rows = num_columns == 0 ? 0 : inverted_plis.begin()->size();
-
-    algos::hy::Rows pli_records(num_rows, algos::hy::Row(num_columns));
-
-    for (size_t i = 0; i < num_rows; ++i) {
-        for (size_t j = 0; j < num_columns; ++j) {
-            pli_records[i][j] = inverted_plis[j][i];
-        }
-    }
-
-    return pli_records;
-}
-
 }  // namespace
 
 namespace algos::hy {
@@ -74,7 +59,7 @@ std::tuple<PLIs, Rows, std::vector<ClusterId>> Preprocess(ColumnLayoutRelationDa
 
     const auto inverted_plis = BuildInvertedPlis(plis);
 
-    auto pli_records = BuildRecordRepresentation(inverted_plis);
+    Rows pli_records(inverted_plis);
 
     return std::make_tuple(std::move(plis), std::move(pli_records), std::move(og_mapping));
 }
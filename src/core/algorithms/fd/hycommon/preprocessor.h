@@ -4,6 +4,7 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#include "compressed_records.h"
 #include "model/table/column_layout_relation_data.h"
 #include "types.h"
 
@@ -1,6 +1,7 @@
 #include "sampler.h"
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <utility>
 
@@ -8,8 +9,9 @@
 #include <boost/asio/thread_pool.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/thread/future.hpp>
+#include <easylogging++.h>
 
-#include "algorithms/fd/hycommon/util/pli_util.h"
+#include "compressed_records.h"
 #include "efficiency.h"
 
 namespace {
@@ -26,15 +28,15 @@ public:
         : sort_keys_(sort_keys),
           comparison_column_1_(comparison_column_1),
           comparison_column_2_(comparison_column_2) {
-        assert(sort_keys_->front().size() >= 3);
+        assert(sort_keys_->GetNumColumns() >= 3);
     }
 
     bool operator()(size_t o1, size_t o2) noexcept {
-        size_t value1 = (*sort_keys_)[o1][comparison_column_1_];
-        size_t value2 = (*sort_keys_)[o2][comparison_column_1_];
+        size_t value1 = sort_keys_->Get(o1, comparison_column_1_);
+        size_t value2 = sort_keys_->Get(o2, comparison_column_1_);
         if (value1 == value2) {
-            value1 = (*sort_keys_)[o1][comparison_column_2_];
-            value2 = (*sort_keys_)[o2][comparison_column_2_];
+            value1 = sort_keys_->Get(o1, comparison_column_2_);
+            value2 = sort_keys_->Get(o2, comparison_column_2_);
         }
         return value1 > value2;
     }
@@ -74,62 +76,90 @@ public:
 namespace algos::hy {
 
 template <typename F>
-void Sampler::RunWindowImpl(Efficiency& efficiency, model::PositionListIndex const& pli,
-                            F store_match) {
+void Sampler::RunWindowImpl(Efficiency& efficiency, F store_match) const {
     efficiency.IncrementWindow();
 
-    size_t const num_attributes = agree_sets_->NumAttributes();
-    size_t const prev_num_agree_sets = agree_sets_->Count();
-
     unsigned comparisons = 0;
     unsigned const window = efficiency.GetWindow();
 
-    for (model::PLI::Cluster const& cluster : pli.GetIndex()) {
-        boost::dynamic_bitset<> equal_attrs(num_attributes);
+    for (model::PLI::Cluster const& cluster : (*plis_)[efficiency.GetAttr()]->GetIndex()) {
         for (size_t i = 0; window < cluster.size() && i < cluster.size() - window; ++i) {
             int const pivot_id = cluster[i];
             int const partner_id = cluster[i + window];
 
-            Match(equal_attrs, pivot_id, partner_id);
+            boost::dynamic_bitset<> equal_attrs =
+                    compressed_records_->GetAgreeSet(pivot_id, partner_id);
             assert(equal_attrs.any());
-            store_match(equal_attrs);
-            equal_attrs.reset();
+            store_match(std::move(equal_attrs));
 
             comparisons++;
         }
     }
 
-    size_t const num_new_violations = agree_sets_->Count() - prev_num_agree_sets;
+    efficiency.SetComparisons(comparisons);
+}
+
+Sampler::AgreeSets Sampler::RunWindowRet(Efficiency& efficiency) const {
+    AgreeSets matches;
+    RunWindowImpl(efficiency, [&matches](boost::dynamic_bitset<>&& equal_attrs) {
+        matches.push_back(std::move(equal_attrs));
+    });
+    // Neighbouring records of a cluster often agree on the same attributes, so dropping the
+    // repeats here keeps the sequential merge short
+    std::sort(matches.begin(), matches.end());
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+    return matches;
+}
 
+void Sampler::RunWindow(Efficiency& efficiency) {
+    unsigned num_new_violations = 0;
+    RunWindowImpl(efficiency, [this, &num_new_violations](boost::dynamic_bitset<>&& equal_attrs) {
+        num_new_violations += agree_sets_->Add(std::move(equal_attrs));
+    });
     efficiency.SetViolations(num_new_violations);
-    efficiency.SetComparisons(comparisons);
 }
 
-std::vector<boost::dynamic_bitset<>> Sampler::RunWindowRet(Efficiency& efficiency,
-                                                           model::PositionListIndex const& pli) {
-    std::vector<boost::dynamic_bitset<>> matched;
-    auto store_match = [&matched](boost::dynamic_bitset<> const& equal_attrs) {
-        matched.push_back(equal_attrs);
-    };
-    RunWindowImpl(efficiency, pli, store_match);
-    return matched;
+void Sampler::RunWindowsParallel(std::vector<Efficiency>& efficiencies) {
+    std::vector<boost::unique_future<AgreeSets>> futures;
+    futures.reserve(efficiencies.size());
+    for (Efficiency& efficiency : efficiencies) {
+        boost::packaged_task<AgreeSets> task(
+                [this, &efficiency]() { return RunWindowRet(efficiency); });
+        futures.push_back(task.get_future());
+        boost::asio::post(*pool_, std::move(task));
+    }
+
+    // Violations can only be counted against the shared agree sets, so they are counted here
+    // while merging. Merging the i-th buffer overlaps with the windows that are still running.
+    for (size_t i = 0; i < efficiencies.size(); ++i) {
+        unsigned num_new_violations = 0;
+        for (boost::dynamic_bitset<>& match : futures[i].get()) {
+            num_new_violations += agree_sets_->Add(std::move(match));
+        }
+        efficiencies[i].SetViolations(num_new_violations);
+    }
 }
 
-void Sampler::RunWindow(Efficiency& efficiency, model::PositionListIndex const& pli) {
-    auto store_match = [this](boost::dynamic_bitset<> const& equal_attrs) {
-        agree_sets_->Add(equal_attrs);
-    };
-    RunWindowImpl(efficiency, pli, store_match);
+void Sampler::RunWindowsAndRequeue(std::vector<Efficiency>& efficiencies) {
+    if (threads_num_ > 1) {
+        RunWindowsParallel(efficiencies);
+    } else {
+        assert(threads_num_ == 1);
+        for (Efficiency& efficiency : efficiencies) {
+            RunWindow(efficiency);
+        }
+    }
+
+    for (Efficiency const& efficiency : efficiencies) {
+        if (efficiency.CalcEfficiency() > 0) {
+            efficiency_queue_.push(efficiency);
+        }
+    }
 }
 
 void Sampler::ProcessComparisonSuggestions(IdPairs const& comparison_suggestions) {
-    size_t const num_attributes = plis_->size();
-
     for (auto [first_id, second_id] : comparison_suggestions) {
-        boost::dynamic_bitset<> equal_attrs(num_attributes);
-        Match(equal_attrs, first_id, second_id);
-
-        agree_sets_->Add(std::move(equal_attrs));
+        agree_sets_->Add(compressed_records_->GetAgreeSet(first_id, second_id));
     }
 }
 
@@ -175,80 +205,43 @@ void Sampler::SortClusters() {
     }
 }
 
-void Sampler::InitializeEfficiencyQueueParallel() {
-    using EfficiencyAndMatches = std::pair<Efficiency, std::vector<boost::dynamic_bitset<>>>;
-    std::vector<boost::unique_future<EfficiencyAndMatches>> futures;
-    for (size_t attr = 0; attr < plis_->size(); ++attr) {
-        auto run_window = [attr, this]() {
-            Efficiency efficiency(attr);
-            return std::make_pair(efficiency, RunWindowRet(efficiency, *(*plis_)[attr]));
-        };
-        boost::packaged_task<EfficiencyAndMatches> task(std::move(run_window));
-        futures.push_back(task.get_future());
-        boost::asio::post(*pool_, std::move(task));
-    }
-
-    // TODO(polyntsov): this waiting causes significant overhead on some datasets (on flight_1k
-    // it's probably the highest one). However removing this waiting fully removes overhead on
-    // these problematic datasets, it adds overhead on all other datasets :/
-    // It seems that all problematic datasets spend most of the time on the validation phase, so
-    // multithreading here may add some overhead, but I don't really understand how the explicit
-    // waiting causes it. Further investigation is needed.
-    boost::wait_for_all(futures.begin(), futures.end());
-
-    for (auto& future : futures) {
-        auto [efficiency, matches] = future.get();
-
-        for (auto& match : matches) {
-            agree_sets_->Add(std::move(match));
-        }
-
-        if (efficiency.CalcEfficiency() > 0) {
-            efficiency_queue_.push(efficiency);
-        }
-    }
-}
-
-void Sampler::InitializeEfficiencyQueueSeq() {
-    for (size_t attr = 0; attr < plis_->size(); ++attr) {
-        Efficiency efficiency(attr);
-        RunWindow(efficiency, *(*plis_)[attr]);
-
-        if (efficiency.CalcEfficiency() > 0) {
-            efficiency_queue_.push(efficiency);
-        }
-    }
-}
-
-void Sampler::InitializeEfficiencyQueueImpl() {
-    if (threads_num_ > 1) {
-        InitializeEfficiencyQueueParallel();
-    } else {
-        InitializeEfficiencyQueueSeq();
-    }
-}
-
 void Sampler::InitializeEfficiencyQueue() {
     size_t const num_attributes = plis_->size();
+    auto const start_time = std::chrono::system_clock::now();
 
     if (num_attributes >= 3) {
         SortClusters();
     }
+    auto const sorted_time = std::chrono::system_clock::now();
 
-    InitializeEfficiencyQueueImpl();
+    std::vector<Efficiency> efficiencies;
+    efficiencies.reserve(num_attributes);
+    for (size_t attr = 0; attr < num_attributes; ++attr) {
+        efficiencies.emplace_back(attr);
+    }
+    RunWindowsAndRequeue(efficiencies);
 
     if (!efficiency_queue_.empty()) {
         efficiency_threshold_ =
                 std::min(kEfficiencyThreshold, efficiency_queue_.top().CalcEfficiency() / 2);
     }
+
+    using std::chrono::duration_cast, std::chrono::milliseconds;
+    LOG(DEBUG) << "Sampler initialization: sorting clusters took "
+               << duration_cast<milliseconds>(sorted_time - start_time).count()
+               << " ms, first windows took "
+               << duration_cast<milliseconds>(std::chrono::system_clock::now() - sorted_time)
+                          .count()
+               << " ms, " << efficiency_queue_.size() << " of " << num_attributes
+               << " attributes stay in the efficiency queue";
 }
 
 ColumnCombinationList Sampler::GetAgreeSets(IdPairs const& comparison_suggestions) {
     ProcessComparisonSuggestions(comparison_suggestions);
 
     if (efficiency_queue_.empty()) {
-        if (threads_num_ > 1) {
-            assert(pool_ == nullptr);
+        // The queue is empty again whenever all attributes have run dry, so the pool may exist
+        if (threads_num_ > 1 && pool_ == nullptr) {
             pool_ = std::make_unique<boost::asio::thread_pool>(threads_num_);
         }
 
@@ -260,36 +253,24 @@ ColumnCombinationList Sampler::GetAgreeSets(IdPairs const& comparison_suggestion
                          efficiency_queue_.top().CalcEfficiency() * threshold_decrease);
     }
 
+    // The top threads_num_ most efficient attributes are run together. With a single thread
+    // this is the original progressive loop which always reruns the best attribute first.
+    std::vector<Efficiency> batch;
     while (!efficiency_queue_.empty() &&
            efficiency_queue_.top().CalcEfficiency() >= efficiency_threshold_) {
-        Efficiency best_efficiency = efficiency_queue_.top();
-        efficiency_queue_.pop();
-
-        RunWindow(best_efficiency, *(*plis_)[best_efficiency.GetAttr()]);
-
-        if (best_efficiency.CalcEfficiency() > 0) {
-            efficiency_queue_.push(best_efficiency);
-        }
+        batch.clear();
+        do {
+            batch.push_back(efficiency_queue_.top());
+            efficiency_queue_.pop();
+        } while (batch.size() < threads_num_ && !efficiency_queue_.empty() &&
+                 efficiency_queue_.top().CalcEfficiency() >= efficiency_threshold_);
+
+        RunWindowsAndRequeue(batch);
     }
 
     return agree_sets_->MoveOutNewColumnCombinations();
 }
 
-void Sampler::Match(boost::dynamic_bitset<>& attributes, size_t first_record_id,
-                    size_t second_record_id) {
-    assert(first_record_id < compressed_records_->size() &&
-           second_record_id < compressed_records_->size());
-
-    for (size_t i = 0; i < compressed_records_->front().size(); ++i) {
-        TablePos const val1 = (*compressed_records_)[first_record_id][i];
-        TablePos const val2 = (*compressed_records_)[second_record_id][i];
-        if (!PLIUtil::IsSingletonCluster(val1) && !PLIUtil::IsSingletonCluster(val2) &&
-            val1 == val2) {
-            attributes.set(i);
-        }
-    }
-}
-
 Sampler::Sampler(PLIsPtr plis, RowsPtr pli_records, config::ThreadNumType threads)
     : plis_(std::move(plis)),
       compressed_records_(std::move(pli_records)),
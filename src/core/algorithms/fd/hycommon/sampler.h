@@ -32,22 +32,25 @@ private:
     config::ThreadNumType threads_num_;
     std::unique_ptr<boost::asio::thread_pool> pool_;
 
+    using AgreeSets = std::vector<boost::dynamic_bitset<>>;
+
     void ProcessComparisonSuggestions(IdPairs const& comparison_suggestions);
     void SortClustersSeq();
     void SortClustersParallel();
     void SortClusters();
-    void InitializeEfficiencyQueueSeq();
-    void InitializeEfficiencyQueueParallel();
-    void InitializeEfficiencyQueueImpl();
     void InitializeEfficiencyQueue();
 
-    void Match(boost::dynamic_bitset<>& attributes, size_t first_record_id,
-               size_t second_record_id);
     template <typename F>
-    void RunWindowImpl(Efficiency& efficiency, model::PositionListIndex const& pli, F store_match);
-    std::vector<boost::dynamic_bitset<>> RunWindowRet(Efficiency& efficiency,
-                                                      model::PositionListIndex const& pli);
-    void RunWindow(Efficiency& efficiency, model::PositionListIndex const& pli);
+    void RunWindowImpl(Efficiency& efficiency, F store_match) const;
+    AgreeSets RunWindowRet(Efficiency& efficiency) const;
+    void RunWindow(Efficiency& efficiency);
+    /* Runs the next windows of all given attributes concurrently, each into its own buffer, then
+     * merges the buffers in order. The efficiencies are updated as if the windows were run
+     * sequentially one after another in that order.
+     */
+    void RunWindowsParallel(std::vector<Efficiency>& efficiencies);
+    /* Runs the next windows of the given attributes and requeues the ones that stay efficient */
+    void RunWindowsAndRequeue(std::vector<Efficiency>& efficiencies);
 
 public:
     Sampler(PLIsPtr plis, RowsPtr pli_records, config::ThreadNumType threads = 1);
@@ -20,11 +20,11 @@ using ClusterId = unsigned int;
 // of the relation
 using PLIs = std::vector<model::PositionListIndex*>;
 using PLIsPtr = std::shared_ptr<PLIs>;
-using Row = std::vector<TablePos>;
-// Represents a relation as a list of rows where each row is a list of row values
-using Rows = std::vector<Row>;
 // Represents a relation as a list of column where each column is a list of column values
 using Columns = std::vector<std::vector<TablePos>>;
+class CompressedRecords;
+// Represents a relation as a list of rows where each row is a list of row values
+using Rows = CompressedRecords;
 using RowsPtr = std::shared_ptr<Rows>;
 // Pair of row numbers
 using IdPairs = std::vector<std::pair<TablePos, TablePos>>;
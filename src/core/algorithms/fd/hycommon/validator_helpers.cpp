@@ -1,27 +1,9 @@
 #include "validator_helpers.h"
 
-#include "algorithms/fd/hycommon/util/pli_util.h"
-#include "algorithms/fd/hyfd/model/fd_tree_vertex.h"
 #include "ucc/hyucc/model/ucc_tree_vertex.h"
 
 namespace algos::hy {
 
-std::vector<ClusterId> BuildClustersIdentifier(Row const& compressed_record,
-                                               std::vector<ClusterId> const& agree_set) {
-    std::vector<ClusterId> sub_cluster;
-    sub_cluster.reserve(agree_set.size());
-    for (auto attr : agree_set) {
-        ClusterId const cluster_id = compressed_record[attr];
-
-        if (PLIUtil::IsSingletonCluster(cluster_id)) {
-            return {};
-        }
-
-        sub_cluster.push_back(cluster_id);
-    }
-    return sub_cluster;
-}
-
 template <typename VertexAndAgreeSet>
 std::vector<VertexAndAgreeSet> CollectCurrentChildren(
         std::vector<VertexAndAgreeSet> const& cur_level_vertices, size_t num_attributes) {
@@ -47,10 +29,7 @@ std::vector<VertexAndAgreeSet> CollectCurrentChildren(
 }
 
 using UCCLhsPair = algos::hyucc::LhsPair;
-using FDLhsPair = algos::hyfd::fd_tree::LhsPair;
 template std::vector<UCCLhsPair> CollectCurrentChildren<UCCLhsPair>(
         std::vector<UCCLhsPair> const& cur_level_vertices, size_t num_attributes);
-template std::vector<FDLhsPair> CollectCurrentChildren<FDLhsPair>(
-        std::vector<FDLhsPair> const& cur_level_vertices, size_t num_attributes);
 
 }  // namespace algos::hy
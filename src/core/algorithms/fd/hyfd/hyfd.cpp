@@ -12,13 +12,20 @@
 
 #include "algorithms/fd/hycommon/preprocessor.h"
 #include "algorithms/fd/hycommon/util/pli_util.h"
+#include "config/thread_number/option.h"
 #include "inductor.h"
 #include "sampler.h"
 #include "validator.h"
 
 namespace algos::hyfd {
 
-HyFD::HyFD() : PliBasedFDAlgorithm({}) {}
+HyFD::HyFD() : PliBasedFDAlgorithm({}) {
+    RegisterOption(config::ThreadNumberOpt(&threads_num_));
+}
+
+void HyFD::MakeExecuteOptsAvailable() {
+    MakeOptionsAvailable({config::ThreadNumberOpt.GetName()});
+}
 
 unsigned long long HyFD::ExecuteInternal() {
     using namespace hy;
@@ -29,7 +36,7 @@ unsigned long long HyFD::ExecuteInternal() {
     auto const plis_shared = std::make_shared<PLIs>(std::move(plis));
     auto const pli_records_shared = std::make_shared<Rows>(std::move(pli_records));
 
-    Sampler sampler(plis_shared, pli_records_shared);
+    Sampler sampler(plis_shared, pli_records_shared, threads_num_);
 
     auto const positive_cover_tree =
             std::make_shared<fd_tree::FDTree>(GetRelation().GetNumColumns());
@@ -8,6 +8,7 @@
 #include "algorithms/fd/hycommon/types.h"
 #include "algorithms/fd/pli_based_fd_algorithm.h"
 #include "algorithms/fd/raw_fd.h"
+#include "config/thread_number/type.h"
 #include "model/table/position_list_index.h"
 
 namespace algos::hyfd {
@@ -37,6 +38,9 @@ namespace algos::hyfd {
  */
 class HyFD : public PliBasedFDAlgorithm {
 private:
+    config::ThreadNumType threads_num_ = 1;
+
+    void MakeExecuteOptsAvailable() final;
     void ResetStateFd() final {}
     unsigned long long ExecuteInternal() override;
 
@@ -1,47 +1,149 @@
 #include "fd_tree.h"
 
-#include <memory>
+#include <algorithm>
+#include <bitset>
+#include <cassert>
 #include <vector>
 
 #include <boost/dynamic_bitset.hpp>
 
 namespace algos::hyfd::fd_tree {
 
-std::shared_ptr<FDTreeVertex> FDTree::AddFD(boost::dynamic_bitset<> const& lhs, size_t rhs) {
-    FDTreeVertex* cur_node = root_.get();
-    cur_node->SetAttribute(rhs);
+FDTree::FDTree(size_t num_attributes)
+    : num_attributes_(num_attributes),
+      num_blocks_((num_attributes + kBitsPerBlock - 1) / kBitsPerBlock) {
+    VertexId const root = AllocateVertex();
+    assert(root == kRoot);
+    for (size_t id = 0; id < num_attributes; id++) {
+        SetFd(root, id);
+    }
+}
+
+bool FDTree::Any(Block const* blocks) const noexcept {
+    return std::any_of(blocks, blocks + num_blocks_, [](Block block) { return block != 0; });
+}
+
+VertexId FDTree::AllocateVertex() {
+    if (free_vertices_.empty()) {
+        VertexId const vertex = vertices_.size();
+        vertices_.emplace_back();
+        bitset_blocks_.resize(bitset_blocks_.size() + kBitsetsPerVertex * num_blocks_);
+        return vertex;
+    }
+
+    VertexId const vertex = free_vertices_.back();
+    free_vertices_.pop_back();
+    std::fill_n(GetBlocks(vertex, kFds), kBitsetsPerVertex * num_blocks_, Block{0});
+    return vertex;
+}
+
+void FDTree::FreeSubtree(VertexId vertex) {
+    for (VertexId child : vertices_[vertex].children) {
+        FreeSubtree(child);
+    }
+    vertices_[vertex].children.clear();
+    free_vertices_.push_back(vertex);
+}
+
+size_t FDTree::GetChildIndex(VertexId vertex, size_t pos) const {
+    Block const* child_positions = GetBlocks(vertex, kChildPositions);
+    size_t const last_block = pos / kBitsPerBlock;
+    size_t index = 0;
+    for (size_t i = 0; i < last_block; ++i) {
+        index += std::bitset<kBitsPerBlock>(child_positions[i]).count();
+    }
+    Block const lesser_positions_mask = (Block{1} << (pos % kBitsPerBlock)) - 1;
+    return index + std::bitset<kBitsPerBlock>(child_positions[last_block] & lesser_positions_mask)
+                           .count();
+}
+
+VertexId FDTree::GetChildIfExists(VertexId vertex, size_t pos) const {
+    assert(pos < num_attributes_);
+    if (!Test(GetBlocks(vertex, kChildPositions), pos)) {
+        return kNoVertex;
+    }
+    return vertices_[vertex].children[GetChildIndex(vertex, pos)];
+}
+
+std::pair<VertexId, bool> FDTree::AddChild(VertexId vertex, size_t pos) {
+    if (VertexId const child = GetChildIfExists(vertex, pos); child != kNoVertex) {
+        return {child, false};
+    }
+
+    VertexId const child = AllocateVertex();
+    std::vector<VertexId>& children = vertices_[vertex].children;
+    children.insert(children.begin() + GetChildIndex(vertex, pos), child);
+    Set(GetBlocks(vertex, kChildPositions), pos);
+    return {child, true};
+}
+
+void FDTree::RemoveChild(VertexId vertex, size_t pos) {
+    std::vector<VertexId>& children = vertices_[vertex].children;
+    auto const child_it = children.begin() + GetChildIndex(vertex, pos);
+    VertexId const child = *child_it;
+    children.erase(child_it);
+    Reset(GetBlocks(vertex, kChildPositions), pos);
+    FreeSubtree(child);
+}
+
+template <typename F>
+void FDTree::ForEachChild(VertexId vertex, F&& f) const {
+    std::vector<VertexId> const& children = vertices_[vertex].children;
+    Block const* child_positions = GetBlocks(vertex, kChildPositions);
+    size_t index = 0;
+    for (size_t i = 0; index < children.size(); ++i) {
+        std::bitset<kBitsPerBlock> const block(child_positions[i]);
+        for (size_t bit = block._Find_first(); bit != kBitsPerBlock; bit = block._Find_next(bit)) {
+            f(i * kBitsPerBlock + bit, children[index++]);
+        }
+    }
+}
+
+boost::dynamic_bitset<> FDTree::GetFDs(VertexId vertex) const {
+    boost::dynamic_bitset<> fds(num_attributes_);
+    Block const* blocks = GetBlocks(vertex, kFds);
+    boost::from_block_range(blocks, blocks + num_blocks_, fds);
+    return fds;
+}
+
+void FDTree::SetFds(VertexId vertex, boost::dynamic_bitset<> const& new_fds) {
+    assert(new_fds.size() == num_attributes_);
+    boost::to_block_range(new_fds, GetBlocks(vertex, kFds));
+}
+
+VertexId FDTree::AddFD(boost::dynamic_bitset<> const& lhs, size_t rhs) {
+    VertexId cur_vertex = kRoot;
+    SetAttribute(cur_vertex, rhs);
 
     for (size_t bit = lhs.find_first(); bit != boost::dynamic_bitset<>::npos;
          bit = lhs.find_next(bit)) {
-        bool is_new = cur_node->AddChild(bit);
+        auto const [child, is_new] = AddChild(cur_vertex, bit);
 
         if (is_new && lhs.find_next(bit) == boost::dynamic_bitset<>::npos) {
-            auto added_node = cur_node->GetChildPtr(bit);
-            added_node->SetAttribute(rhs);
-            added_node->SetFd(rhs);
-            return added_node;
+            SetAttribute(child, rhs);
+            SetFd(child, rhs);
+            return child;
         }
 
-        cur_node = cur_node->GetChild(bit);
-        cur_node->SetAttribute(rhs);
+        cur_vertex = child;
+        SetAttribute(cur_vertex, rhs);
     }
-    cur_node->SetFd(rhs);
-    return nullptr;
+    SetFd(cur_vertex, rhs);
+    return kNoVertex;
 }
 
-bool FDTree::ContainsFD(boost::dynamic_bitset<> const& lhs, size_t rhs) {
-    FDTreeVertex const* cur_node = root_.get();
+bool FDTree::ContainsFD(boost::dynamic_bitset<> const& lhs, size_t rhs) const {
+    VertexId cur_vertex = kRoot;
 
     for (size_t bit = lhs.find_first(); bit != boost::dynamic_bitset<>::npos;
          bit = lhs.find_next(bit)) {
-        if (!cur_node->HasChildren() || !cur_node->ContainsChildAt(bit)) {
+        cur_vertex = GetChildIfExists(cur_vertex, bit);
+        if (cur_vertex == kNoVertex) {
             return false;
         }
-
-        cur_node = cur_node->GetChild(bit);
     }
 
-    return cur_node->IsFd(rhs);
+    return IsFd(cur_vertex, rhs);
 }
 
 std::vector<boost::dynamic_bitset<>> FDTree::GetFdAndGenerals(boost::dynamic_bitset<> const& lhs,
@@ -49,20 +151,136 @@ std::vector<boost::dynamic_bitset<>> FDTree::GetFdAndGenerals(boost::dynamic_bit
     assert(lhs.count() != 0);
 
     std::vector<boost::dynamic_bitset<>> result;
-    boost::dynamic_bitset<> const empty_lhs(GetNumAttributes());
+    boost::dynamic_bitset<> cur_lhs(num_attributes_);
     size_t const starting_bit = lhs.find_first();
 
-    root_->GetFdAndGeneralsRecursive(lhs, empty_lhs, rhs, starting_bit, result);
+    GetFdAndGeneralsRecursive(kRoot, lhs, cur_lhs, rhs, starting_bit, result);
 
     return result;
 }
 
-std::vector<LhsPair> FDTree::GetLevel(unsigned target_level) {
-    boost::dynamic_bitset<> const empty_lhs(GetNumAttributes());
+void FDTree::GetFdAndGeneralsRecursive(VertexId vertex, boost::dynamic_bitset<> const& lhs,
+                                       boost::dynamic_bitset<>& cur_lhs, size_t rhs,
+                                       size_t cur_bit,
+                                       std::vector<boost::dynamic_bitset<>>& result) const {
+    if (IsFd(vertex, rhs)) {
+        result.push_back(cur_lhs);
+    }
+
+    if (!HasChildren(vertex)) {
+        return;
+    }
+
+    for (; cur_bit != boost::dynamic_bitset<>::npos; cur_bit = lhs.find_next(cur_bit)) {
+        VertexId const child = GetChildIfExists(vertex, cur_bit);
+        if (child != kNoVertex && IsAttribute(child, rhs)) {
+            cur_lhs.set(cur_bit);
+            GetFdAndGeneralsRecursive(child, lhs, cur_lhs, rhs, lhs.find_next(cur_bit), result);
+            cur_lhs.reset(cur_bit);
+        }
+    }
+}
+
+bool FDTree::FindFdOrGeneralRecursive(VertexId vertex, boost::dynamic_bitset<> const& lhs,
+                                      size_t rhs, size_t cur_bit) const {
+    if (IsFd(vertex, rhs)) {
+        return true;
+    }
+
+    if (!HasChildren(vertex)) {
+        return false;
+    }
+
+    for (; cur_bit != boost::dynamic_bitset<>::npos; cur_bit = lhs.find_next(cur_bit)) {
+        VertexId const child = GetChildIfExists(vertex, cur_bit);
+        if (child != kNoVertex && IsAttribute(child, rhs) &&
+            FindFdOrGeneralRecursive(child, lhs, rhs, lhs.find_next(cur_bit))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FDTree::RemoveRecursive(VertexId vertex, boost::dynamic_bitset<> const& lhs, size_t rhs,
+                             size_t current_lhs_attr) {
+    if (current_lhs_attr == boost::dynamic_bitset<>::npos) {
+        RemoveFd(vertex, rhs);
+        RemoveAttribute(vertex, rhs);
+        return true;
+    }
+
+    if (VertexId const child = GetChildIfExists(vertex, current_lhs_attr); child != kNoVertex) {
+        if (!RemoveRecursive(child, lhs, rhs, lhs.find_next(current_lhs_attr))) {
+            return false;
+        }
+
+        if (!Any(GetBlocks(child, kAttributes))) {
+            RemoveChild(vertex, current_lhs_attr);
+        }
+    }
+
+    if (IsLastNodeOf(vertex, rhs)) {
+        RemoveAttribute(vertex, rhs);
+        return true;
+    }
+    return false;
+}
+
+bool FDTree::IsLastNodeOf(VertexId vertex, size_t rhs) const {
+    std::vector<VertexId> const& children = vertices_[vertex].children;
+    return std::none_of(children.cbegin(), children.cend(),
+                        [this, rhs](VertexId child) { return IsAttribute(child, rhs); });
+}
+
+std::vector<LhsPair> FDTree::GetLevel(unsigned target_level) const {
+    boost::dynamic_bitset<> lhs(num_attributes_);
 
     std::vector<LhsPair> vertices;
-    root_->GetLevelRecursive(target_level, 0, empty_lhs, vertices);
+    GetLevelRecursive(kRoot, target_level, 0, lhs, vertices);
     return vertices;
 }
 
+void FDTree::GetLevelRecursive(VertexId vertex, unsigned target_level, unsigned cur_level,
+                               boost::dynamic_bitset<>& lhs,
+                               std::vector<LhsPair>& vertices) const {
+    if (cur_level == target_level) {
+        vertices.emplace_back(vertex, lhs);
+        return;
+    }
+
+    ForEachChild(vertex, [&](size_t pos, VertexId child) {
+        lhs.set(pos);
+        GetLevelRecursive(child, target_level, cur_level + 1, lhs, vertices);
+        lhs.reset(pos);
+    });
+}
+
+std::vector<LhsPair> FDTree::CollectChildren(std::vector<LhsPair> const& level) const {
+    std::vector<LhsPair> next_level;
+    for (auto const& [vertex, lhs] : level) {
+        ForEachChild(vertex, [&next_level, &lhs = lhs](size_t pos, VertexId child) {
+            boost::dynamic_bitset<> child_lhs = lhs;
+            child_lhs.set(pos);
+            next_level.emplace_back(child, std::move(child_lhs));
+        });
+    }
+    return next_level;
+}
+
+void FDTree::FillFDs(VertexId vertex, std::vector<RawFD>& fds,
+                     boost::dynamic_bitset<>& lhs) const {
+    Block const* fd_blocks = GetBlocks(vertex, kFds);
+    for (size_t rhs = 0; rhs < num_attributes_; ++rhs) {
+        if (Test(fd_blocks, rhs)) {
+            fds.emplace_back(lhs, rhs);
+        }
+    }
+
+    ForEachChild(vertex, [this, &fds, &lhs](size_t pos, VertexId child) {
+        lhs.set(pos);
+        FillFDs(child, fds, lhs);
+        lhs.reset(pos);
+    });
+}
+
 }  // namespace algos::hyfd::fd_tree
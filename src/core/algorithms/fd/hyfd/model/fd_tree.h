@@ -1,55 +1,188 @@
 #pragma once
 
-#include <memory>
+#include <cstdint>
+#include <limits>
+#include <utility>
 #include <vector>
 
 #include <boost/dynamic_bitset.hpp>
 
 #include "algorithms/fd/raw_fd.h"
-#include "fd_tree_vertex.h"
 
 namespace algos::hyfd::fd_tree {
 
+/**
+ * Index of an FD tree vertex. Stays valid until the vertex is removed from the tree.
+ */
+using VertexId = std::uint32_t;
+
+/**
+ * Pair of FD tree vertex and the corresponding LHS.
+ */
+using LhsPair = std::pair<VertexId, boost::dynamic_bitset<>>;
+
 /**
  * FD prefix tree.
  *
- * Provides global tree manipulation and traversing methods.
+ * LHS of the FD is represented by the path to the vertex, besides the path must be built in
+ * ascending order, i.e. LHS {0, 1} can be obtained by getting child with position 0, then its
+ * child with position 1. If we go first to child 1, it will not contain child 0.
  *
- * @see FDTreeVertex
+ * RHS of the FD is represented by the fds bitset of the vertex.
+ *
+ * Vertices are stored in one array and refer to their children by index. Every vertex keeps only
+ * its existing children, ordered by position, and a bitset of their positions, so the index of a
+ * child is the number of children with lesser positions. The bitsets of all vertices share one
+ * block array.
  */
 class FDTree {
+public:
+    static constexpr VertexId kRoot = 0;
+    static constexpr VertexId kNoVertex = std::numeric_limits<VertexId>::max();
+
 private:
-    std::shared_ptr<FDTreeVertex> root_;
+    using Block = boost::dynamic_bitset<>::block_type;
 
-public:
-    explicit FDTree(size_t num_attributes) : root_(std::make_shared<FDTreeVertex>(num_attributes)) {
-        for (size_t id = 0; id < num_attributes; id++) {
-            root_->SetFd(id);
-        }
+    static constexpr size_t kBitsPerBlock = boost::dynamic_bitset<>::bits_per_block;
+
+    /**
+     * Bitsets of a vertex: its RHSs, union of RHSs of its subtree and positions of its children
+     */
+    enum VertexBitset : size_t { kFds = 0, kAttributes, kChildPositions, kBitsetsPerVertex };
+
+    struct Vertex {
+        std::vector<VertexId> children;
+    };
+
+    size_t num_attributes_;
+    size_t num_blocks_;
+
+    std::vector<Vertex> vertices_;
+    std::vector<Block> bitset_blocks_;
+    /**
+     * Ids of removed vertices to be reused
+     */
+    std::vector<VertexId> free_vertices_;
+
+    Block* GetBlocks(VertexId vertex, VertexBitset bitset) {
+        return bitset_blocks_.data() + (vertex * kBitsetsPerVertex + bitset) * num_blocks_;
+    }
+    Block const* GetBlocks(VertexId vertex, VertexBitset bitset) const {
+        return bitset_blocks_.data() + (vertex * kBitsetsPerVertex + bitset) * num_blocks_;
+    }
+
+    static bool Test(Block const* blocks, size_t pos) noexcept {
+        return (blocks[pos / kBitsPerBlock] >> (pos % kBitsPerBlock)) & 1;
+    }
+    static void Set(Block* blocks, size_t pos) noexcept {
+        blocks[pos / kBitsPerBlock] |= Block{1} << (pos % kBitsPerBlock);
+    }
+    static void Reset(Block* blocks, size_t pos) noexcept {
+        blocks[pos / kBitsPerBlock] &= ~(Block{1} << (pos % kBitsPerBlock));
     }
+    bool Any(Block const* blocks) const noexcept;
+
+    VertexId AllocateVertex();
+    void FreeSubtree(VertexId vertex);
+
+    /**
+     * Number of children with positions less than the given one
+     */
+    size_t GetChildIndex(VertexId vertex, size_t pos) const;
+
+    /**
+     * Constructs empty child vertex at the given position. Does nothing if the child already
+     * exists.
+     *
+     * @return the child and whether it was constructed
+     */
+    std::pair<VertexId, bool> AddChild(VertexId vertex, size_t pos);
+    void RemoveChild(VertexId vertex, size_t pos);
+
+    void SetAttribute(VertexId vertex, size_t pos) noexcept {
+        Set(GetBlocks(vertex, kAttributes), pos);
+    }
+    void RemoveAttribute(VertexId vertex, size_t pos) noexcept {
+        Reset(GetBlocks(vertex, kAttributes), pos);
+    }
+    bool IsAttribute(VertexId vertex, size_t pos) const noexcept {
+        return Test(GetBlocks(vertex, kAttributes), pos);
+    }
+    void SetFd(VertexId vertex, size_t pos) noexcept {
+        Set(GetBlocks(vertex, kFds), pos);
+    }
+
+    /**
+     * Calls f(position, child) for every child of the vertex in ascending order of positions
+     */
+    template <typename F>
+    void ForEachChild(VertexId vertex, F&& f) const;
+
+    void GetLevelRecursive(VertexId vertex, unsigned target_level, unsigned cur_level,
+                           boost::dynamic_bitset<>& lhs, std::vector<LhsPair>& vertices) const;
+
+    void GetFdAndGeneralsRecursive(VertexId vertex, boost::dynamic_bitset<> const& lhs,
+                                   boost::dynamic_bitset<>& cur_lhs, size_t rhs, size_t cur_bit,
+                                   std::vector<boost::dynamic_bitset<>>& result) const;
+
+    bool FindFdOrGeneralRecursive(VertexId vertex, boost::dynamic_bitset<> const& lhs, size_t rhs,
+                                  size_t cur_bit) const;
+
+    bool RemoveRecursive(VertexId vertex, boost::dynamic_bitset<> const& lhs, size_t rhs,
+                         size_t current_lhs_attr);
+
+    /**
+     * Checks whether no child of the vertex has the given RHS in its subtree
+     */
+    bool IsLastNodeOf(VertexId vertex, size_t rhs) const;
+
+    void FillFDs(VertexId vertex, std::vector<RawFD>& fds, boost::dynamic_bitset<>& lhs) const;
+
+public:
+    explicit FDTree(size_t num_attributes);
 
     [[nodiscard]] size_t GetNumAttributes() const noexcept {
-        return root_->GetNumAttributes();
+        return num_attributes_;
     }
 
-    std::shared_ptr<FDTreeVertex> GetRootPtr() noexcept {
-        return root_;
+    [[nodiscard]] boost::dynamic_bitset<> GetFDs(VertexId vertex) const;
+
+    /**
+     * Replaces stored RHS of the vertex with provided one.
+     */
+    void SetFds(VertexId vertex, boost::dynamic_bitset<> const& new_fds);
+
+    void RemoveFd(VertexId vertex, size_t pos) noexcept {
+        Reset(GetBlocks(vertex, kFds), pos);
     }
 
-    [[nodiscard]] FDTreeVertex const& GetRoot() const noexcept {
-        return *root_;
+    [[nodiscard]] bool IsFd(VertexId vertex, size_t pos) const noexcept {
+        return Test(GetBlocks(vertex, kFds), pos);
     }
 
-    std::shared_ptr<FDTreeVertex> AddFD(boost::dynamic_bitset<> const& lhs, size_t rhs);
+    [[nodiscard]] bool HasChildren(VertexId vertex) const noexcept {
+        return !vertices_[vertex].children.empty();
+    }
 
-    bool ContainsFD(boost::dynamic_bitset<> const& lhs, size_t rhs);
+    /**
+     * @return child of the vertex at the given position or kNoVertex if there is none
+     */
+    [[nodiscard]] VertexId GetChildIfExists(VertexId vertex, size_t pos) const;
 
     /**
-     * Recursively finds node representing given lhs and removes given rhs bit from it.
-     * Destroys vertices whose children became empty.
+     * Adds FD to the tree.
+     * @return vertex of the FD if it was created by this call, kNoVertex otherwise
+     */
+    VertexId AddFD(boost::dynamic_bitset<> const& lhs, size_t rhs);
+
+    bool ContainsFD(boost::dynamic_bitset<> const& lhs, size_t rhs) const;
+
+    /**
+     * Recursively finds vertex representing given lhs and removes given rhs bit from it.
+     * Destroys vertices whose subtrees have no RHSs left.
      */
     void Remove(boost::dynamic_bitset<> const& lhs, size_t rhs) {
-        root_->RemoveRecursive(lhs, rhs, lhs.find_first());
+        RemoveRecursive(kRoot, lhs, rhs, lhs.find_first());
     }
 
     /**
@@ -62,22 +195,27 @@ public:
      * Checks if any FD has at least given lhs and rhs.
      */
     [[nodiscard]] bool FindFdOrGeneral(boost::dynamic_bitset<> const& lhs, size_t rhs) const {
-        return root_->FindFdOrGeneralRecursive(lhs, rhs, lhs.find_first());
+        return FindFdOrGeneralRecursive(kRoot, lhs, rhs, lhs.find_first());
     }
 
     /**
-     * Gets nodes representing FDs with LHS of given arity.
+     * Gets vertices representing FDs with LHS of given arity.
      * @param target_level arity of returned FDs LHSs
      */
-    std::vector<LhsPair> GetLevel(unsigned target_level);
+    [[nodiscard]] std::vector<LhsPair> GetLevel(unsigned target_level) const;
+
+    /**
+     * Gets children of the given vertices, i.e. the next level of the tree traversal.
+     */
+    [[nodiscard]] std::vector<LhsPair> CollectChildren(std::vector<LhsPair> const& level) const;
 
     /**
      * @return vector of all FDs
      */
     [[nodiscard]] std::vector<RawFD> FillFDs() const {
         std::vector<RawFD> result;
-        boost::dynamic_bitset<> lhs_for_traverse(GetRoot().GetNumAttributes());
-        GetRoot().FillFDs(result, lhs_for_traverse);
+        boost::dynamic_bitset<> lhs_for_traverse(num_attributes_);
+        FillFDs(kRoot, result, lhs_for_traverse);
         return result;
     }
 };
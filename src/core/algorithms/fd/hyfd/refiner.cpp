@@ -0,0 +1,99 @@
+#include "refiner.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "algorithms/fd/hycommon/util/pli_util.h"
+
+namespace algos::hyfd {
+
+size_t Refiner::PrepareTable(size_t num_records) {
+    size_t capacity = 2;
+    while (capacity < 2 * num_records) {
+        capacity *= 2;
+    }
+    if (table_.size() < capacity) {
+        table_.assign(capacity, Slot{0, 0});
+    }
+
+    if (++generation_ == 0) {
+        std::fill(table_.begin(), table_.end(), Slot{0, 0});
+        generation_ = 1;
+    }
+    return capacity - 1;
+}
+
+boost::dynamic_bitset<> Refiner::Refine(hy::IdPairs& comparison_suggestions,
+                                        model::PLI const& first_pli,
+                                        hy::Rows const& compressed_records,
+                                        boost::dynamic_bitset<> const& lhs,
+                                        boost::dynamic_bitset<> const& rhs) {
+    constexpr std::uint64_t kHashMultiplier = 0x9E3779B97F4A7C15;
+    using hy::PLIUtil;
+
+    lhs_columns_.clear();
+    for (size_t attr = lhs.find_first(); attr != boost::dynamic_bitset<>::npos;
+         attr = lhs.find_next(attr)) {
+        lhs_columns_.push_back(attr);
+    }
+
+    auto const have_equal_lhs = [this, &compressed_records](RecordId first, RecordId second) {
+        return std::all_of(lhs_columns_.begin(), lhs_columns_.end(), [&](size_t column) {
+            return compressed_records.Get(first, column) == compressed_records.Get(second, column);
+        });
+    };
+
+    boost::dynamic_bitset<> valid_rhss = rhs;
+    auto const validate_rhss = [&valid_rhss, &compressed_records, &comparison_suggestions](
+                                       RecordId group_record, RecordId record) {
+        for (size_t column = valid_rhss.find_first(); column != boost::dynamic_bitset<>::npos;
+             column = valid_rhss.find_next(column)) {
+            hy::ClusterId const value = compressed_records.Get(record, column);
+            if (PLIUtil::IsSingletonCluster(value) ||
+                value != compressed_records.Get(group_record, column)) {
+                comparison_suggestions.emplace_back(record, group_record);
+                valid_rhss.reset(column);
+            }
+        }
+    };
+
+    for (model::PLI::Cluster const& cluster : first_pli.GetIndex()) {
+        if (valid_rhss.none()) {
+            break;
+        }
+
+        size_t const slot_mask = PrepareTable(cluster.size());
+        for (RecordId record : cluster) {
+            std::uint64_t hash = 0;
+            bool is_in_singleton = false;
+            for (size_t column : lhs_columns_) {
+                hy::ClusterId const cluster_id = compressed_records.Get(record, column);
+                if (PLIUtil::IsSingletonCluster(cluster_id)) {
+                    is_in_singleton = true;
+                    break;
+                }
+                hash = (hash ^ cluster_id) * kHashMultiplier;
+            }
+            if (is_in_singleton) {
+                continue;
+            }
+
+            for (size_t slot_index = (hash ^ (hash >> 32)) & slot_mask;;
+                 slot_index = (slot_index + 1) & slot_mask) {
+                Slot& slot = table_[slot_index];
+                if (slot.generation != generation_) {
+                    slot = Slot{generation_, record};
+                    break;
+                }
+                if (have_equal_lhs(slot.record, record)) {
+                    validate_rhss(slot.record, record);
+                    break;
+                }
+            }
+        }
+    }
+
+    return valid_rhss;
+}
+
+}  // namespace algos::hyfd
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "algorithms/fd/hycommon/compressed_records.h"
+#include "algorithms/fd/hycommon/types.h"
+#include "model/table/position_list_index.h"
+
+namespace algos::hyfd {
+
+// Finds valid RHSs of an FD candidate by refining the clusters of one of its LHS columns with the
+// rest of the LHS. Records of a cluster are grouped by their LHS cluster ids in an open-addressing
+// table that is reused for every cluster and every call. Keys are not copied: the table stores
+// the first record of each group, and both the LHS and the RHS values are compared against it.
+class Refiner {
+private:
+    using RecordId = model::PLI::Cluster::value_type;
+
+    struct Slot {
+        unsigned generation;
+        RecordId record;
+    };
+
+    std::vector<Slot> table_;
+    // Slots of the previous generations are empty, so the table is cleared by a single increment
+    unsigned generation_ = 0;
+    std::vector<size_t> lhs_columns_;
+
+    // Starts a new generation with at least twice as many slots as records, returns the slot mask
+    size_t PrepareTable(size_t num_records);
+
+public:
+    // Returns the RHSs from rhs that are functionally determined by lhs together with the column
+    // of first_pli, which lhs must not contain. Every pair of records that violates an RHS is
+    // added to comparison_suggestions.
+    boost::dynamic_bitset<> Refine(hy::IdPairs& comparison_suggestions,
+                                   model::PLI const& first_pli, hy::Rows const& compressed_records,
+                                   boost::dynamic_bitset<> const& lhs,
+                                   boost::dynamic_bitset<> const& rhs);
+};
+
+}  // namespace algos::hyfd
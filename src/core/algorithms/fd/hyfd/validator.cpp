@@ -15,98 +15,6 @@
 
 namespace {
 
-std::unordered_set<size_t> AsSet(boost::dynamic_bitset<> const& bitset) {
-    std::unordered_set<size_t> valid_rhss(bitset.count());
-    for (size_t attr = bitset.find_first(); attr != boost::dynamic_bitset<>::npos;
-         attr = bitset.find_next(attr)) {
-        valid_rhss.insert(attr);
-    }
-    return valid_rhss;
-}
-
-std::pair<std::vector<size_t>, std::vector<size_t>> BuildRhsMappings(
-        boost::dynamic_bitset<> const& rhs, algos::hy::Rows const& compressed_records) {
-    std::vector<size_t> rhs_column_ids;
-    rhs_column_ids.reserve(rhs.count());
-    std::vector<size_t> rhs_ranks(compressed_records[0].size());
-
-    for (size_t attr = rhs.find_first(); attr != boost::dynamic_bitset<>::npos;
-         attr = rhs.find_next(attr)) {
-        rhs_ranks[attr] = rhs_column_ids.size();
-        rhs_column_ids.push_back(attr);
-    }
-
-    return std::make_pair(std::move(rhs_column_ids), std::move(rhs_ranks));
-}
-
-using LhsRow = std::vector<size_t>;
-using RhsRowId = std::pair<std::vector<size_t>, size_t>;
-
-void ValidateRhss(RhsRowId const& rhs_record, algos::hy::Rows const& compressed_records, size_t row,
-                  std::vector<size_t> const& rhs_ranks, std::unordered_set<size_t>& valid_rhs_ids,
-                  algos::hy::IdPairs& comparison_suggestions) {
-    for (auto it = valid_rhs_ids.begin(); it != valid_rhs_ids.end();) {
-        size_t const rhs_column = *it;
-        size_t const value = compressed_records[row][rhs_column];
-
-        if (algos::hy::PLIUtil::IsSingletonCluster(value) ||
-            value != rhs_record.first[rhs_ranks[rhs_column]]) {
-            comparison_suggestions.emplace_back(row, rhs_record.second);
-            it = valid_rhs_ids.erase(it);
-            if (valid_rhs_ids.empty()) {
-                return;
-            }
-        } else {
-            ++it;
-        }
-    }
-}
-
-RhsRowId BuildRhsRowId(algos::hy::Rows const& compressed_records,
-                       boost::dynamic_bitset<> const& rhs,
-                       std::vector<size_t> const& rhs_column_ids, size_t row) {
-    std::vector<size_t> rhs_sub_cluster(rhs.count());
-    for (size_t i = 0; i < rhs.count(); ++i) {
-        rhs_sub_cluster[i] = compressed_records[row][rhs_column_ids[i]];
-    }
-
-    return std::make_pair(std::move(rhs_sub_cluster), row);
-}
-
-boost::dynamic_bitset<> Refine(algos::hy::IdPairs& comparison_suggestions,
-                               algos::hy::PLIs const& plis,
-                               algos::hy::Rows const& compressed_records,
-                               boost::dynamic_bitset<> const& lhs,
-                               boost::dynamic_bitset<> const& rhs, size_t firstAttr) {
-    auto valid_rhs_ids = AsSet(rhs);
-    auto const lhs_column_ids = util::BitsetToIndices<algos::hy::ClusterId>(lhs);
-    auto const [rhs_column_ids, rhs_ranks] = BuildRhsMappings(rhs, compressed_records);
-
-    for (auto const& cluster : plis[firstAttr]->GetIndex()) {
-        auto lhs_rhs_map = algos::hy::MakeClusterIdentifierToTMap<RhsRowId>(cluster.size());
-
-        for (size_t row : cluster) {
-            auto lhs_row =
-                    algos::hy::BuildClustersIdentifier(compressed_records[row], lhs_column_ids);
-            if (lhs_row.empty()) {
-                continue;
-            }
-
-            auto const iter = lhs_rhs_map.find(lhs_row);
-
-            if (iter != lhs_rhs_map.end()) {
-                ValidateRhss(iter->second, compressed_records, row, rhs_ranks, valid_rhs_ids,
-                             comparison_suggestions);
-            } else {
-                RhsRowId rhs_row_id = BuildRhsRowId(compressed_records, rhs, rhs_column_ids, row);
-
-                lhs_rhs_map.emplace(std::move(lhs_row), std::move(rhs_row_id));
-            }
-        }
-    }
-    return util::IndicesToBitset(valid_rhs_ids, rhs.size());
-}
-
 size_t AddExtendedCandidatesFromInvalid(std::vector<algos::hyfd::LhsPair>& next_level,
                                         algos::hyfd::fd_tree::FDTree& fds_tree,
                                         std::vector<RawFD> const& invalid_fds,
@@ -114,10 +22,13 @@ size_t AddExtendedCandidatesFromInvalid(std::vector<algos::hyfd::LhsPair>& next_
     size_t candidates = 0;
     for (auto const& [lhs, rhs] : invalid_fds) {
         for (size_t attr = 0; attr < num_attributes; ++attr) {
-            if (lhs.test(attr) || rhs == attr || fds_tree.FindFdOrGeneral(lhs, attr) ||
-                (fds_tree.GetRoot().HasChildren() &&
-                 fds_tree.GetRoot().ContainsChildAt(attr) &&
-                 fds_tree.GetRoot().GetChild(attr)->IsFd(rhs))) {
+            if (lhs.test(attr) || rhs == attr || fds_tree.FindFdOrGeneral(lhs, attr)) {
+                continue;
+            }
+
+            using algos::hyfd::fd_tree::FDTree;
+            if (auto const root_child = fds_tree.GetChildIfExists(FDTree::kRoot, attr);
+                root_child != FDTree::kNoVertex && fds_tree.IsFd(root_child, rhs)) {
                 continue;
             }
 
@@ -128,11 +39,11 @@ size_t AddExtendedCandidatesFromInvalid(std::vector<algos::hyfd::LhsPair>& next_
                 continue;
             }
 
-            auto child = fds_tree.AddFD(lhs_ext, rhs);
-            if (child == nullptr) {
+            auto const child = fds_tree.AddFD(lhs_ext, rhs);
+            if (child == algos::hyfd::fd_tree::FDTree::kNoVertex) {
                 continue;
             }
-            next_level.emplace_back(std::move(child), std::move(lhs_ext));
+            next_level.emplace_back(child, std::move(lhs_ext));
             candidates++;
         }
     }
@@ -148,7 +59,7 @@ Validator::FDValidations Validator::ProcessZeroLevel(LhsPair const& lhsPair) {
 
     auto vertex = lhsPair.first;
     auto const lhs = lhsPair.second;
-    auto const rhs = vertex->GetFDs();
+    auto const rhs = fds_->GetFDs(vertex);
     size_t const rhs_count = rhs.count();
 
     result.set_count_validations(rhs_count);
@@ -157,7 +68,7 @@ Validator::FDValidations Validator::ProcessZeroLevel(LhsPair const& lhsPair) {
     for (size_t attr = rhs.find_first(); attr != boost::dynamic_bitset<>::npos;
          attr = rhs.find_next(attr)) {
         if (!(*plis_)[attr]->IsConstant()) {
-            vertex->RemoveFd(attr);
+            fds_->RemoveFd(vertex, attr);
             result.invalid_instances().emplace_back(lhs, attr);
         }
     }
@@ -168,7 +79,7 @@ Validator::FDValidations Validator::ProcessZeroLevel(LhsPair const& lhsPair) {
 Validator::FDValidations Validator::ProcessFirstLevel(LhsPair const& lhs_pair) {
     auto vertex = lhs_pair.first;
     auto const lhs = lhs_pair.second;
-    auto const rhs = vertex->GetFDs();
+    auto const rhs = fds_->GetFDs(vertex);
     size_t const rhs_count = rhs.count();
 
     size_t const lhs_attr = lhs.find_first();
@@ -188,7 +99,7 @@ Validator::FDValidations Validator::ProcessFirstLevel(LhsPair const& lhs_pair) {
                 std::any_of(cluster.cbegin(), cluster.cend(), [this, attr, cluster_id](int id) {
                     return (*compressed_records_)[id][attr] != cluster_id;
                 })) {
-                vertex->RemoveFd(attr);
+                fds_->RemoveFd(vertex, attr);
                 result.invalid_instances().emplace_back(lhs, attr);
                 break;
             }
@@ -200,7 +111,7 @@ Validator::FDValidations Validator::ProcessFirstLevel(LhsPair const& lhs_pair) {
 Validator::FDValidations Validator::ProcessHigherLevel(LhsPair const& lhs_pair) {
     auto vertex = lhs_pair.first;
     auto lhs = lhs_pair.second;
-    auto rhs = vertex->GetFDs();
+    auto rhs = fds_->GetFDs(vertex);
     size_t const rhs_count = rhs.count();
 
     if (rhs_count == 0) {
@@ -214,12 +125,13 @@ Validator::FDValidations Validator::ProcessHigherLevel(LhsPair const& lhs_pair)
     size_t const first_attr = lhs.find_first();
 
     lhs.reset(first_attr);
-    boost::dynamic_bitset<> const valid_rhss = Refine(result.comparison_suggestions(), *plis_,
-                                                      *compressed_records_, lhs, rhs, first_attr);
+    boost::dynamic_bitset<> const valid_rhss =
+            refiner_.Refine(result.comparison_suggestions(), *(*plis_)[first_attr],
+                            *compressed_records_, lhs, rhs);
     lhs.set(first_attr);
 
     rhs &= ~valid_rhss;
-    vertex->SetFds(valid_rhss);
+    fds_->SetFds(vertex, valid_rhss);
 
     for (size_t attr = rhs.find_first(); attr != boost::dynamic_bitset<>::npos;
          attr = rhs.find_next(attr)) {
@@ -257,7 +169,7 @@ algos::hy::IdPairs Validator::ValidateAndExtendCandidates() {
     if (current_level_number_ != 0) {
         cur_level_vertices = fds_->GetLevel(current_level_number_);
     } else {
-        cur_level_vertices.emplace_back(fds_->GetRootPtr(),
+        cur_level_vertices.emplace_back(fd_tree::FDTree::kRoot,
                                         boost::dynamic_bitset<>(num_attributes));
     }
 
@@ -273,8 +185,7 @@ algos::hy::IdPairs Validator::ValidateAndExtendCandidates() {
             break;
         }
 
-        std::vector<LhsPair> next_level =
-                algos::hy::CollectCurrentChildren(cur_level_vertices, num_attributes);
+        std::vector<LhsPair> next_level = fds_->CollectChildren(cur_level_vertices);
         size_t candidates = AddExtendedCandidatesFromInvalid(
                 next_level, *fds_, result.invalid_instances(), num_attributes);
         algos::hy::LogLevel(cur_level_vertices, result, candidates, current_level_number_, "FD");
@@ -6,6 +6,7 @@
 
 #include "algorithms/fd/hycommon/primitive_validations.h"
 #include "algorithms/fd/hyfd/model/fd_tree.h"
+#include "algorithms/fd/hyfd/refiner.h"
 #include "algorithms/fd/raw_fd.h"
 #include "model/table/position_list_index.h"
 #include "types.h"
@@ -25,6 +26,8 @@ private:
 
     unsigned current_level_number_ = 0;
 
+    Refiner refiner_;
+
     FDValidations ProcessZeroLevel(LhsPair const& lhsPair);
     FDValidations ProcessFirstLevel(LhsPair const& lhs_pair);
     FDValidations ProcessHigherLevel(LhsPair const& lhs_pair);
@@ -23,6 +23,7 @@ struct Parameters {
 
     // Traversal settings
     config::ThreadNumType parallelism = 0;
+    // several workers may discover one search space, the default means no limit
     config::ThreadNumType max_threads_per_search_space = -1;
     bool is_defer_failed_launch_pads = true;
     std::string launch_pad_order = "error";
@@ -38,7 +39,6 @@ struct Parameters {
 
     // Cache settings
     double caching_probability = 0.5;
-    unsigned int nary_intersection_size = 4;
 
     // Miscellaneous settings
     bool is_check_estimates = false;
@@ -7,19 +7,21 @@
 // TODO: extra careful with const& -> shared_ptr conversions via make_shared-smart pointer may
 // delete the object - pass empty deleter [](*) {}
 
-void SearchSpace::Discover() {
+void SearchSpace::Discover(model::VerticalMap<VerticalInfo>* local_visitees) {
     LOG(TRACE) << "Discovering in: " << static_cast<std::string>(*strategy_);
+    std::unique_ptr<model::VerticalMap<VerticalInfo>> own_local_visitees;
     while (true) {  // на второй итерации дропается
         auto now = std::chrono::system_clock::now();
-        std::optional<DependencyCandidate> launch_pad = PollLaunchPad();
+        std::optional<DependencyCandidate> launch_pad = PollLaunchPad(local_visitees);
         if (!launch_pad.has_value()) break;
 
-        if (local_visitees_ == nullptr) {
-            local_visitees_ =
+        if (local_visitees == nullptr) {
+            own_local_visitees =
                     std::make_unique<model::VerticalMap<VerticalInfo>>(context_->GetSchema());
+            local_visitees = own_local_visitees.get();
         }
 
-        bool is_dependency_found = Ascend(*launch_pad);
+        bool is_dependency_found = Ascend(*launch_pad, local_visitees);
         polling_launch_pads_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
                                         std::chrono::system_clock::now() - now)
                                         .count();
@@ -27,10 +29,23 @@ void SearchSpace::Discover() {
     }
 }
 
-std::optional<DependencyCandidate> SearchSpace::PollLaunchPad() {
+std::optional<DependencyCandidate> SearchSpace::PollLaunchPad(
+        model::VerticalMap<VerticalInfo> const* local_visitees) {
+    std::unique_lock lock(launch_pads_mutex_);
     while (true) {
         if (launch_pads_.empty()) {
-            if (deferred_launch_pads_.empty()) return std::optional<DependencyCandidate>();
+            if (deferred_launch_pads_.empty()) {
+                if (num_polled_launch_pads_ == 0) {
+                    launch_pads_cv_.notify_all();
+                    return std::optional<DependencyCandidate>();
+                }
+                // Launch pads held by other workers come back and may be escaped into new ones
+                launch_pads_cv_.wait(lock, [this] {
+                    return !launch_pads_.empty() || !deferred_launch_pads_.empty() ||
+                           num_polled_launch_pads_ == 0;
+                });
+                continue;
+            }
 
             launch_pads_.insert(deferred_launch_pads_.begin(), deferred_launch_pads_.end());
             deferred_launch_pads_.clear();
@@ -42,8 +57,8 @@ std::optional<DependencyCandidate> SearchSpace::PollLaunchPad() {
         launch_pad_index_->Remove(launch_pad.vertical_);
 
         if (IsImpliedByMinDep(launch_pad.vertical_, global_visitees_.get()) ||
-            (local_visitees_ != nullptr &&
-             IsImpliedByMinDep(launch_pad.vertical_, local_visitees_.get()))) {
+            (local_visitees != nullptr &&
+             IsImpliedByMinDep(launch_pad.vertical_, local_visitees))) {
             launch_pad_index_->Remove(launch_pad.vertical_);
             LOG(TRACE) << "* Removing subset-pruned launch pad {" << launch_pad.vertical_.ToString()
                        << '}';
@@ -51,8 +66,8 @@ std::optional<DependencyCandidate> SearchSpace::PollLaunchPad() {
         }
 
         auto superset_entries = global_visitees_->GetSupersetEntries(launch_pad.vertical_);
-        if (local_visitees_ != nullptr) {
-            auto local_superset_entries = local_visitees_->GetSupersetEntries(launch_pad.vertical_);
+        if (local_visitees != nullptr) {
+            auto local_superset_entries = local_visitees->GetSupersetEntries(launch_pad.vertical_);
             auto end_iterator =
                     std::remove_if(local_superset_entries.begin(), local_superset_entries.end(),
                                    [](auto& entry) { return !entry.second->IsPruningSubsets(); });
@@ -60,7 +75,10 @@ std::optional<DependencyCandidate> SearchSpace::PollLaunchPad() {
             std::for_each(local_superset_entries.begin(), end_iterator,
                           [&superset_entries](auto& entry) { superset_entries.push_back(entry); });
         }
-        if (superset_entries.empty()) return launch_pad;
+        if (superset_entries.empty()) {
+            ++num_polled_launch_pads_;
+            return launch_pad;
+        }
         LOG(TRACE) << boost::format{"* Escaping launch_pad %1% from: %2%"} %
                               launch_pad.vertical_.ToString() % "[UNIMPLEMENTED]";
         std::vector<Vertical> superset_verticals;
@@ -69,20 +87,21 @@ std::optional<DependencyCandidate> SearchSpace::PollLaunchPad() {
             superset_verticals.push_back(entry.first);
         }
 
-        EscapeLaunchPad(launch_pad.vertical_, std::move(superset_verticals));
+        EscapeLaunchPad(launch_pad.vertical_, std::move(superset_verticals), local_visitees);
     }
 }
 
 // this move looks legit IMO
 void SearchSpace::EscapeLaunchPad(Vertical const& launch_pad,
-                                  std::vector<Vertical> pruning_supersets) {
+                                  std::vector<Vertical> pruning_supersets,
+                                  model::VerticalMap<VerticalInfo> const* local_visitees) {
     std::transform(pruning_supersets.begin(), pruning_supersets.end(), pruning_supersets.begin(),
                    [this](auto& superset) {
                        return superset.Invert().Without(strategy_->GetIrrelevantColumns());
                    });
 
     std::function<bool(Vertical const&)> pruning_function =
-            [this, &launch_pad](auto const& hitting_set_candidate) -> bool {
+            [this, &launch_pad, local_visitees](auto const& hitting_set_candidate) -> bool {
         if (scope_ != nullptr &&
             scope_->GetAnySupersetEntry(hitting_set_candidate).second == nullptr) {
             return true;
@@ -90,8 +109,8 @@ void SearchSpace::EscapeLaunchPad(Vertical const& launch_pad,
 
         auto launch_pad_candidate = launch_pad.Union(hitting_set_candidate);
 
-        if ((local_visitees_ == nullptr &&
-             IsImpliedByMinDep(launch_pad_candidate, local_visitees_.get())) ||
+        if ((local_visitees != nullptr &&
+             IsImpliedByMinDep(launch_pad_candidate, local_visitees)) ||
             IsImpliedByMinDep(launch_pad_candidate, global_visitees_.get())) {
             return true;
         }
@@ -141,11 +160,13 @@ void SearchSpace::EscapeLaunchPad(Vertical const& launch_pad,
 }
 
 void SearchSpace::AddLaunchPad(const DependencyCandidate& launch_pad) {
+    std::scoped_lock lock(launch_pads_mutex_);
     launch_pads_.insert(launch_pad);
     launch_pad_index_->Put(launch_pad.vertical_, std::make_unique<DependencyCandidate>(launch_pad));
 }
 
 void SearchSpace::ReturnLaunchPad(DependencyCandidate const& launch_pad, bool is_defer) {
+    std::scoped_lock lock(launch_pads_mutex_);
     if (is_defer && context_->GetParameters().is_defer_failed_launch_pads) {
         deferred_launch_pads_.push_back(launch_pad);
         LOG(TRACE) << boost::format{"Deferred seed %1%"} % launch_pad.vertical_.ToString();
@@ -153,9 +174,12 @@ void SearchSpace::ReturnLaunchPad(DependencyCandidate const& launch_pad, bool is
         launch_pads_.insert(launch_pad);
     }
     launch_pad_index_->Put(launch_pad.vertical_, std::make_unique<DependencyCandidate>(launch_pad));
+    --num_polled_launch_pads_;
+    launch_pads_cv_.notify_all();
 }
 
-bool SearchSpace::Ascend(DependencyCandidate const& launch_pad) {
+bool SearchSpace::Ascend(DependencyCandidate const& launch_pad,
+                         model::VerticalMap<VerticalInfo>* local_visitees) {
     auto now = std::chrono::system_clock::now();
 
     LOG(DEBUG) << boost::format{"===== Ascending from %1% ======"} %
@@ -181,8 +205,8 @@ bool SearchSpace::Ascend(DependencyCandidate const& launch_pad) {
             error = traversal_candidate.error_.Get();
 
             bool can_be_dependency = *error <= strategy_->max_dependency_error_;
-            local_visitees_->Put(traversal_candidate.vertical_,
-                                 std::make_unique<VerticalInfo>(can_be_dependency, false, *error));
+            local_visitees->Put(traversal_candidate.vertical_,
+                                std::make_unique<VerticalInfo>(can_be_dependency, false, *error));
             if (can_be_dependency) break;
         } else {
             if (traversal_candidate.error_.GetMin() > strategy_->max_dependency_error_) {
@@ -196,7 +220,7 @@ bool SearchSpace::Ascend(DependencyCandidate const& launch_pad) {
                                 : strategy_->CalculateError(traversal_candidate.vertical_);
                 // double errorDiff = *error - traversal_candidate.error_.GetMean();
 
-                local_visitees_->Put(
+                local_visitees->Put(
                         traversal_candidate.vertical_,
                         std::make_unique<VerticalInfo>(error <= strategy_->max_dependency_error_,
                                                        false, *error));
@@ -271,7 +295,7 @@ bool SearchSpace::Ascend(DependencyCandidate const& launch_pad) {
         LOG(TRACE)
                 << boost::format{"  Key peak in climbing phase e(%1%)=%2% -> Need to minimize."} %
                            traversal_candidate.vertical_.ToString() % *error;
-        TrickleDown(traversal_candidate.vertical_, *error);
+        TrickleDown(traversal_candidate.vertical_, *error, local_visitees);
 
         if (recursion_depth_ == 0) {
             assert(scope_ == nullptr);
@@ -290,8 +314,8 @@ bool SearchSpace::Ascend(DependencyCandidate const& launch_pad) {
             LOG(DEBUG) << boost::format{"[---] %1% is maximum non-dependency (err=%2%)."} %
                                   traversal_candidate.vertical_.ToString() % *error;
         } else {
-            local_visitees_->Put(traversal_candidate.vertical_,
-                                 std::make_unique<VerticalInfo>(VerticalInfo::ForNonDependency()));
+            local_visitees->Put(traversal_candidate.vertical_,
+                                std::make_unique<VerticalInfo>(VerticalInfo::ForNonDependency()));
             LOG(DEBUG) << boost::format{"      %1% is local-maximum non-dependency (err=%2%)."} %
                                   traversal_candidate.vertical_.ToString() % *error;
         }
@@ -305,7 +329,8 @@ void SearchSpace::CheckEstimate([[maybe_unused]] DependencyStrategy* strategy,
             << "Stepped into method 'checkEstimate' - not implemented yet being a debug method\n";
 }
 
-void SearchSpace::TrickleDown(Vertical const& main_peak, double main_peak_error) {
+void SearchSpace::TrickleDown(Vertical const& main_peak, double main_peak_error,
+                              model::VerticalMap<VerticalInfo>* local_visitees) {
     LOG(DEBUG) << boost::format{"====== Trickling down from %1% ======"} % main_peak.ToString();
 
     std::unordered_set<Vertical> maximal_non_deps;
@@ -350,7 +375,7 @@ void SearchSpace::TrickleDown(Vertical const& main_peak, double main_peak_error)
                         alleged_non_deps.insert(escaped_peak_vertical);
                         continue;
                     }
-                    if (IsKnownNonDependency(escaped_peak_vertical, local_visitees_.get()) ||
+                    if (IsKnownNonDependency(escaped_peak_vertical, local_visitees) ||
                         IsKnownNonDependency(escaped_peak_vertical, global_visitees_.get())) {
                         continue;
                     }
@@ -362,7 +387,8 @@ void SearchSpace::TrickleDown(Vertical const& main_peak, double main_peak_error)
         }
         auto alleged_min_dep =
                 TrickleDownFrom(std::move(peak), strategy_.get(), alleged_min_deps.get(),
-                                alleged_non_deps, global_visitees_.get(), sample_boost_);
+                                alleged_non_deps, local_visitees, global_visitees_.get(),
+                                sample_boost_);
         if (!alleged_min_dep.has_value()) {
             std::pop_heap(peaks.begin(), peaks.end(), peaks_comparator);
             peaks.pop_back();
@@ -374,13 +400,10 @@ void SearchSpace::TrickleDown(Vertical const& main_peak, double main_peak_error)
 
     int num_uncertain_min_deps = 0;
     for (auto& [alleged_min_dep, info] : alleged_min_deps->EntrySet()) {
-        if (info->is_extremal_ && !global_visitees_->ContainsKey(alleged_min_dep)) {
-            LOG(DEBUG) << boost::format{"[%1%] Minimum dependency: %2% (error=%3%)"} %
-                                  recursion_depth_ % alleged_min_dep.ToString() % info->error_;
+        if (info->is_extremal_) {
             // TODO: Костыль -- info в нескольких местах должен храниться. ХЗ, кому он принадлежит,
             // пока копирую
-            global_visitees_->Put(alleged_min_dep, std::make_unique<VerticalInfo>(*info));
-            strategy_->RegisterDependency(alleged_min_dep, info->error_, *context_);
+            RegisterMinimalDependency(alleged_min_dep, *info);
         }
         if (!info->is_extremal_) {
             num_uncertain_min_deps++;
@@ -425,7 +448,7 @@ void SearchSpace::TrickleDown(Vertical const& main_peak, double main_peak_error)
         if (alleged_max_non_dep.GetArity() == 0) continue;
 
         if (maximal_non_deps.find(alleged_max_non_dep) != maximal_non_deps.end() ||
-            IsKnownNonDependency(alleged_max_non_dep, local_visitees_.get()) ||
+            IsKnownNonDependency(alleged_max_non_dep, local_visitees) ||
             IsKnownNonDependency(alleged_max_non_dep, global_visitees_.get())) {
             continue;
         }
@@ -441,8 +464,8 @@ void SearchSpace::TrickleDown(Vertical const& main_peak, double main_peak_error)
                               alleged_max_non_dep.ToString() % is_non_dep % error;
         if (is_non_dep) {
             maximal_non_deps.insert(alleged_max_non_dep);
-            local_visitees_->Put(alleged_max_non_dep,
-                                 std::make_unique<VerticalInfo>(VerticalInfo::ForNonDependency()));
+            local_visitees->Put(alleged_max_non_dep,
+                                std::make_unique<VerticalInfo>(VerticalInfo::ForNonDependency()));
         } else {
             peaks.emplace_back(alleged_max_non_dep, model::ConfidenceInterval(error), true);
             std::push_heap(peaks.begin(), peaks.end(), peaks_comparator);
@@ -454,14 +477,11 @@ void SearchSpace::TrickleDown(Vertical const& main_peak, double main_peak_error)
 
     if (peaks.empty()) {
         for (auto& [alleged_min_dep, info] : alleged_min_deps->EntrySet()) {
-            if (!info->is_extremal_ && !global_visitees_->ContainsKey(alleged_min_dep)) {
-                LOG(DEBUG) << boost::format{"[%1%] Minimum dependency: %2% (error=%3%)"} %
-                                      recursion_depth_ % alleged_min_dep.ToString() % info->error_;
+            if (!info->is_extremal_) {
                 // TODO: тут надо сделать non-const - костыльный mutable; опять Info в двух местах
                 // хранится
                 info->is_extremal_ = true;
-                global_visitees_->Put(alleged_min_dep, std::make_unique<VerticalInfo>(*info));
-                strategy_->RegisterDependency(alleged_min_dep, info->error_, *context_);
+                RegisterMinimalDependency(alleged_min_dep, *info);
             }
         }
         trickling_down_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
@@ -481,7 +501,7 @@ void SearchSpace::TrickleDown(Vertical const& main_peak, double main_peak_error)
         auto scope_verticals = new_scope->KeySet();
         // TODO: что делать с strategy, globalVisitees?
         auto nested_search_space = std::make_unique<SearchSpace>(
-                -1, strategy_->CreateClone(), std::move(new_scope), std::move(global_visitees_),
+                -1, strategy_->CreateClone(), std::move(new_scope), global_visitees_,
                 context_->GetSchema(), launch_pads_.key_comp(), recursion_depth_ + 1,
                 sample_boost_ * context_->GetParameters().sample_booster);
         nested_search_space->SetContext(context_);
@@ -506,25 +526,19 @@ void SearchSpace::TrickleDown(Vertical const& main_peak, double main_peak_error)
         trickling_down_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
                                    std::chrono::system_clock::now() - now)
                                    .count();
-        nested_search_space->MoveInLocalVisitees(std::move(local_visitees_));
-        nested_search_space->Discover();
+        nested_search_space->Discover(local_visitees);
         trickling_down_part_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
                                         std::chrono::system_clock::now() - prev)
                                         .count();
-        global_visitees_ = nested_search_space->MoveOutGlobalVisitees();
-        local_visitees_ = nested_search_space->MoveOutLocalVisitees();
 
         for (auto& [alleged_min_dep, info] : alleged_min_deps->EntrySet()) {
             if (!IsImpliedByMinDep(alleged_min_dep, global_visitees_.get())) {
-                LOG(DEBUG) << boost::
-                                              format{"[%1%] Minimum dependency: %2% (error=%3%) "
-                                                     "(was right after all)"} %
-                                      recursion_depth_ % alleged_min_dep.ToString() % info->error_;
+                LOG(DEBUG) << boost::format{"[%1%] %2% was right after all"} % recursion_depth_ %
+                                      alleged_min_dep.ToString();
                 // TODO: тут надо сделать non-const - костыльный mutable; опять Info в двух местах
                 // хранится
                 info->is_extremal_ = true;
-                global_visitees_->Put(alleged_min_dep, std::make_unique<VerticalInfo>(*info));
-                strategy_->RegisterDependency(alleged_min_dep, info->error_, *context_);
+                RegisterMinimalDependency(alleged_min_dep, *info);
             }
         }
     }
@@ -534,6 +548,7 @@ std::optional<Vertical> SearchSpace::TrickleDownFrom(
         DependencyCandidate min_dep_candidate, DependencyStrategy* strategy,
         model::VerticalMap<VerticalInfo>* alleged_min_deps,
         std::unordered_set<Vertical>& alleged_non_deps,
+        model::VerticalMap<VerticalInfo>* local_visitees,
         model::VerticalMap<VerticalInfo>* global_visitees, double boost_factor) {
     auto now = std::chrono::system_clock::now();
     if (min_dep_candidate.error_.GetMin() > strategy->max_dependency_error_) {
@@ -549,7 +564,7 @@ std::optional<Vertical> SearchSpace::TrickleDownFrom(
                     return DependencyCandidate::MinErrorComparator(candidate1, candidate2);
                 });
         for (auto& parent_vertical : min_dep_candidate.vertical_.GetParents()) {
-            if (IsKnownNonDependency(parent_vertical, local_visitees_.get()) ||
+            if (IsKnownNonDependency(parent_vertical, local_visitees) ||
                 IsKnownNonDependency(parent_vertical, global_visitees))
                 continue;
             if (alleged_non_deps.count(parent_vertical) != 0) {
@@ -568,7 +583,7 @@ std::optional<Vertical> SearchSpace::TrickleDownFrom(
             if (parent_candidate.error_.GetMin() > strategy->min_non_dependency_error_) {
                 do {
                     if (parent_candidate.IsExact()) {
-                        local_visitees_->Put(
+                        local_visitees->Put(
                                 parent_candidate.vertical_,
                                 std::make_unique<VerticalInfo>(VerticalInfo::ForNonDependency()));
                     } else {
@@ -589,7 +604,8 @@ std::optional<Vertical> SearchSpace::TrickleDownFrom(
 
             auto alleged_min_dep =
                     TrickleDownFrom(std::move(parent_candidate), strategy, alleged_min_deps,
-                                    alleged_non_deps, global_visitees, boost_factor);
+                                    alleged_non_deps, local_visitees, global_visitees,
+                                    boost_factor);
 
             now = std::chrono::system_clock::now();
 
@@ -629,8 +645,8 @@ std::optional<Vertical> SearchSpace::TrickleDownFrom(
     } else {
         LOG(TRACE) << boost::format{"* Guessed incorrect %1%-ary minimum dependency candidate."} %
                               min_dep_candidate.vertical_.GetArity();
-        local_visitees_->Put(min_dep_candidate.vertical_,
-                             std::make_unique<VerticalInfo>(VerticalInfo::ForNonDependency()));
+        local_visitees->Put(min_dep_candidate.vertical_,
+                            std::make_unique<VerticalInfo>(VerticalInfo::ForNonDependency()));
 
         if (strategy->ShouldResample(min_dep_candidate.vertical_, boost_factor)) {
             context_->CreateFocusedSample(min_dep_candidate.vertical_, boost_factor);
@@ -658,6 +674,16 @@ void SearchSpace::RequireMinimalDependency(DependencyStrategy* strategy,
     }
 }
 
+void SearchSpace::RegisterMinimalDependency(Vertical const& min_dependency,
+                                            VerticalInfo const& info) {
+    if (!global_visitees_->PutIfAbsent(min_dependency, std::make_unique<VerticalInfo>(info))) {
+        return;
+    }
+    LOG(DEBUG) << boost::format{"[%1%] Minimum dependency: %2% (error=%3%)"} % recursion_depth_ %
+                          min_dependency.ToString() % info.error_;
+    strategy_->RegisterDependency(min_dependency, info.error_, *context_);
+}
+
 std::vector<Vertical> SearchSpace::GetSubsetDeps(Vertical const& vertical,
                                                  model::VerticalMap<VerticalInfo>* vertical_infos) {
     auto subset_entries = vertical_infos->GetSubsetEntries(vertical);
@@ -674,7 +700,7 @@ std::vector<Vertical> SearchSpace::GetSubsetDeps(Vertical const& vertical,
 }
 
 bool SearchSpace::IsImpliedByMinDep(Vertical const& vertical,
-                                    model::VerticalMap<VerticalInfo>* vertical_infos) {
+                                    model::VerticalMap<VerticalInfo> const* vertical_infos) {
     // TODO: function<bool(Vertical, ...)> --> function<bool(Vertical&, ...)>
     return vertical_infos
                    ->GetAnySubsetEntry(vertical,
@@ -685,7 +711,7 @@ bool SearchSpace::IsImpliedByMinDep(Vertical const& vertical,
 }
 
 bool SearchSpace::IsKnownNonDependency(Vertical const& vertical,
-                                       model::VerticalMap<VerticalInfo>* vertical_infos) {
+                                       model::VerticalMap<VerticalInfo> const* vertical_infos) {
     return vertical_infos
                    ->GetAnySupersetEntry(vertical, []([[maybe_unused]] auto vertical,
                                                       auto info) { return !info->is_dependency_; })
@@ -703,10 +729,15 @@ void SearchSpace::PrintStats() const {
 }
 
 void SearchSpace::EnsureInitialized() {
-    strategy_->EnsureInitialized(this);
-    std::string initialized_launch_pads;
-    for (auto const& pad : launch_pads_) {
-        initialized_launch_pads += std::string(pad) + " ";
-    }
-    LOG(TRACE) << "Initialized with launch pads: " + initialized_launch_pads;
+    std::call_once(initialization_flag_, [this] {
+        strategy_->EnsureInitialized(this);
+        std::string initialized_launch_pads;
+        {
+            std::scoped_lock lock(launch_pads_mutex_);
+            for (auto const& pad : launch_pads_) {
+                initialized_launch_pads += std::string(pad) + " ";
+            }
+        }
+        LOG(TRACE) << "Initialized with launch pads: " + initialized_launch_pads;
+    });
 }
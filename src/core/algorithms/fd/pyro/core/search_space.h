@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <utility>
 
@@ -19,73 +22,78 @@ private:
             std::function<bool(DependencyCandidate const&, DependencyCandidate const&)>;
     ProfilingContext* context_;
     std::unique_ptr<DependencyStrategy> strategy_;
-    std::unique_ptr<model::VerticalMap<VerticalInfo>> local_visitees_ = nullptr;
-    std::unique_ptr<model::VerticalMap<VerticalInfo>> global_visitees_;
+    // shared by all workers of the search space and by its nested search spaces
+    std::shared_ptr<model::VerticalMap<VerticalInfo>> global_visitees_;
+    // guards launch_pads_, launch_pad_index_, deferred_launch_pads_ and num_polled_launch_pads_
+    std::mutex launch_pads_mutex_;
+    // notified when a launch pad is returned and when the search space is exhausted
+    std::condition_variable launch_pads_cv_;
+    std::once_flag initialization_flag_;
     std::set<DependencyCandidate, DependencyCandidateComp> launch_pads_;
     std::unique_ptr<model::VerticalMap<DependencyCandidate>> launch_pad_index_;
     std::list<DependencyCandidate> deferred_launch_pads_;
+    // Launch pads taken by the workers and not returned yet. Each of them comes back, so the
+    // search space is exhausted only when the queue is empty and this is zero
+    unsigned num_polled_launch_pads_ = 0;
     std::unique_ptr<model::VerticalMap<Vertical>> scope_;
     double sample_boost_;
     int recursion_depth_;
     bool is_ascend_randomly_ = false;
 
-    int num_nested_ = 0;
+    std::atomic<int> num_nested_ = 0;
 
-    // void Discover(std::unique_ptr<VerticalMap<VerticalInfo>> localVisitees);
-    std::optional<DependencyCandidate> PollLaunchPad();
+    // Local visitees are owned by a single worker, so several workers may discover
+    // the same search space concurrently
+    void Discover(model::VerticalMap<VerticalInfo>* local_visitees);
+    std::optional<DependencyCandidate> PollLaunchPad(
+            model::VerticalMap<VerticalInfo> const* local_visitees);
     void EscapeLaunchPad(Vertical const& hitting_set_candidate,
-                         std::vector<Vertical> pruning_supersets);
+                         std::vector<Vertical> pruning_supersets,
+                         model::VerticalMap<VerticalInfo> const* local_visitees);
     void ReturnLaunchPad(DependencyCandidate const& launch_pad, bool is_defer);
 
-    bool Ascend(DependencyCandidate const& launch_pad);
+    bool Ascend(DependencyCandidate const& launch_pad,
+                model::VerticalMap<VerticalInfo>* local_visitees);
     void CheckEstimate(DependencyStrategy* strategy,
                        DependencyCandidate const& traversal_candidate);
-    void TrickleDown(Vertical const& main_peak, double main_peak_error);
+    void TrickleDown(Vertical const& main_peak, double main_peak_error,
+                     model::VerticalMap<VerticalInfo>* local_visitees);
     std::optional<Vertical> TrickleDownFrom(DependencyCandidate min_dep_candidate,
                                             DependencyStrategy* strategy,
                                             model::VerticalMap<VerticalInfo>* alleged_min_deps,
                                             std::unordered_set<Vertical>& alleged_non_deps,
+                                            model::VerticalMap<VerticalInfo>* local_visitees,
                                             model::VerticalMap<VerticalInfo>* global_visitees,
                                             double boost_factor);
-
-    // CAREFUL: resets globalVisitees_, therefore SearchSpace could become invalidated
-    std::unique_ptr<model::VerticalMap<VerticalInfo>> MoveOutGlobalVisitees() {
-        return std::move(global_visitees_);
-    }
-    // CAREFUL: resets localVisitees_, therefore SearchSpace could become invalidated
-    std::unique_ptr<model::VerticalMap<VerticalInfo>> MoveOutLocalVisitees() {
-        return std::move(local_visitees_);
-    }
-    void MoveInLocalVisitees(std::unique_ptr<model::VerticalMap<VerticalInfo>> local_visitees) {
-        local_visitees_ = std::move(local_visitees);
-    }
+    // Registers the dependency unless another worker has already put it into global visitees
+    void RegisterMinimalDependency(Vertical const& min_dependency, VerticalInfo const& info);
 
     static void RequireMinimalDependency(DependencyStrategy* strategy,
                                          Vertical const& min_dependency);
     static std::vector<Vertical> GetSubsetDeps(Vertical const& vertical,
                                                model::VerticalMap<VerticalInfo>* vertical_infos);
     static bool IsImpliedByMinDep(Vertical const& vertical,
-                                  model::VerticalMap<VerticalInfo>* vertical_infos);
+                                  model::VerticalMap<VerticalInfo> const* vertical_infos);
     static bool IsKnownNonDependency(Vertical const& vertical,
-                                     model::VerticalMap<VerticalInfo>* vertical_infos);
+                                     model::VerticalMap<VerticalInfo> const* vertical_infos);
     static std::string FormatArityHistogram() = delete;
     static std::string FormatArityHistogram(model::VerticalMap<int*>) = delete;
 
 public:
-    unsigned long long nanos_smart_constructing_ = 0;
-    unsigned long long polling_launch_pads_ = 0;
-    unsigned long long ascending_ = 0;
-    unsigned long long trickling_down_ = 0;
-    unsigned long long trickling_down_part_ = 0;
-    unsigned long long trickling_down_from_ = 0;
-    unsigned long long returning_launch_pad_ = 0;
+    std::atomic<unsigned long long> nanos_smart_constructing_ = 0;
+    std::atomic<unsigned long long> polling_launch_pads_ = 0;
+    std::atomic<unsigned long long> ascending_ = 0;
+    std::atomic<unsigned long long> trickling_down_ = 0;
+    std::atomic<unsigned long long> trickling_down_part_ = 0;
+    std::atomic<unsigned long long> trickling_down_from_ = 0;
+    std::atomic<unsigned long long> returning_launch_pad_ = 0;
 
     bool is_initialized_ = false;
     int id_;
 
     SearchSpace(int id, std::unique_ptr<DependencyStrategy> strategy,
                 std::unique_ptr<model::VerticalMap<Vertical>> scope,
-                std::unique_ptr<model::VerticalMap<VerticalInfo>> global_visitees,
+                std::shared_ptr<model::VerticalMap<VerticalInfo>> global_visitees,
                 RelationalSchema const* schema,
                 DependencyCandidateComp const& dependency_candidate_comparator, int recursion_depth,
                 double sample_boost)
@@ -102,11 +110,14 @@ public:
                 RelationalSchema const* schema,
                 DependencyCandidateComp const& dependency_candidate_comparator)
         : SearchSpace(id, std::move(strategy), nullptr,
-                      std::make_unique<model::VerticalMap<VerticalInfo>>(schema), schema,
+                      std::make_shared<model::BlockingVerticalMap<VerticalInfo>>(schema), schema,
                       dependency_candidate_comparator, 0, 1) {}
 
+    // Both may be called concurrently by several workers. Discover returns only when the search
+    // space is exhausted, a worker that finds the queue empty waits for the launch pads held by
+    // the others
     void EnsureInitialized();
-    void Discover();
+    void Discover() { Discover(nullptr); }
     void AddLaunchPad(DependencyCandidate const& launch_pad);
     void SetContext(ProfilingContext* context) {
         context_ = context;
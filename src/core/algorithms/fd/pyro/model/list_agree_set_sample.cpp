@@ -1,5 +1,7 @@
 #include "list_agree_set_sample.h"
 
+#include <bitset>
+
 #include <easylogging++.h>
 
 namespace model {
@@ -11,129 +13,98 @@ std::unique_ptr<ListAgreeSetSample> ListAgreeSetSample::CreateFocusedFor(
             relation, restriction_vertical, restriction_p_li, sample_size, random);
 }
 
-std::unique_ptr<std::vector<unsigned long long>> ListAgreeSetSample::BitSetToLongLongVector(
-        boost::dynamic_bitset<> const& bitset) {
-    auto result = std::make_unique<std::vector<unsigned long long>>(
-        std::vector<unsigned long long>((bitset.size() + 63) / 64, 0));
-    for (size_t i = 0; i < bitset.size(); i++) {
-        //idea is: long long ~ 64 bits. shift i-th bit in the bitset i mod 64 times and set the corresponding bit
-        (*result)[i / 64] |= bitset[i] << i % 64;
-    }
-    return result;
-}
-
 ListAgreeSetSample::ListAgreeSetSample(
     ColumnLayoutRelationData const* relation, Vertical const& focus, unsigned int sample_size,
     unsigned long long population_size,
     std::unordered_map<boost::dynamic_bitset<>, int> const& agree_set_counters)
-    : AgreeSetSample(relation, focus, sample_size, population_size) {
-    for (auto& el : agree_set_counters) {
-        agree_set_counters_.emplace_back(Entry(BitSetToLongLongVector(el.first), el.second));
+    : AgreeSetSample(relation, focus, sample_size, population_size),
+      num_words_((agree_set_counters.size() + kWordBits - 1) / kWordBits),
+      agree_set_matrix_(relation->GetNumColumns() * num_words_, 0) {
+    size_t agree_set_index = 0;
+    for (auto const& [agree_set, count] : agree_set_counters) {
+        size_t const word_index = agree_set_index / kWordBits;
+        Word const bit = Word{1} << agree_set_index % kWordBits;
+        for (size_t column_index = agree_set.find_first();
+             column_index != boost::dynamic_bitset<>::npos;
+             column_index = agree_set.find_next(column_index)) {
+            agree_set_matrix_[column_index * num_words_ + word_index] |= bit;
+        }
+        auto const unsigned_count = static_cast<unsigned int>(count);
+        for (size_t plane = 0; (unsigned_count >> plane) != 0; ++plane) {
+            if (count_planes_.size() <= plane * num_words_) {
+                count_planes_.resize((plane + 1) * num_words_, 0);
+            }
+            if ((unsigned_count >> plane) & 1) {
+                count_planes_[plane * num_words_ + word_index] |= bit;
+            }
+        }
+        ++agree_set_index;
     }
 }
 
-unsigned long long ListAgreeSetSample::GetNumAgreeSupersets(Vertical const& agreement) const {
-    unsigned long long count = 0;
-    std::vector<unsigned long long> min_agree_set =
-        *BitSetToLongLongVector(agreement.GetColumnIndices());
+std::vector<ListAgreeSetSample::Word> ListAgreeSetSample::SelectAgreeSets(
+        Vertical const& agreement) const {
+    std::vector<Word> selection(num_words_, ~Word{0});
+    boost::dynamic_bitset<> const& columns = agreement.GetColumnIndices();
+    boost::dynamic_bitset<> const& focus_columns = focus_.GetColumnIndices();
+    for (size_t column_index = columns.find_first(); column_index != boost::dynamic_bitset<>::npos;
+         column_index = columns.find_next(column_index)) {
+        // every sampled agree set contains the focus
+        if (focus_columns[column_index]) continue;
+        Word const* row = agree_set_matrix_.data() + column_index * num_words_;
+        for (size_t i = 0; i < num_words_; ++i) {
+            selection[i] &= row[i];
+        }
+    }
+    return selection;
+}
 
-    for (const auto& agree_set_counter : agree_set_counters_) {
-        std::vector<unsigned long long> agree_set = *agree_set_counter.agree_set;
-        unsigned int i = 0;
-        unsigned int min_fields = std::min(agree_set.size(), min_agree_set.size());
-        while (i < min_fields) {
-            if ((agree_set[i] & min_agree_set[i]) != min_agree_set[i]) goto Entries;
-            i++;
+void ListAgreeSetSample::ExcludeAgreeSets(Vertical const& disagreement,
+                                          std::vector<Word>& selection) const {
+    boost::dynamic_bitset<> const& columns = disagreement.GetColumnIndices();
+    for (size_t column_index = columns.find_first(); column_index != boost::dynamic_bitset<>::npos;
+         column_index = columns.find_next(column_index)) {
+        Word const* row = agree_set_matrix_.data() + column_index * num_words_;
+        for (size_t i = 0; i < num_words_; ++i) {
+            selection[i] &= ~row[i];
         }
-        while (i < min_agree_set.size()) {
-            if (min_agree_set[i] != 0) goto Entries;
-            i++;
+    }
+}
+
+unsigned long long ListAgreeSetSample::CountAgreeSets(std::vector<Word> const& selection) const {
+    unsigned long long count = 0;
+    size_t const num_planes = num_words_ == 0 ? 0 : count_planes_.size() / num_words_;
+    for (size_t plane = 0; plane < num_planes; ++plane) {
+        Word const* counts = count_planes_.data() + plane * num_words_;
+        unsigned long long plane_count = 0;
+        for (size_t i = 0; i < num_words_; ++i) {
+            plane_count += std::bitset<kWordBits>(selection[i] & counts[i]).count();
         }
-        count += agree_set_counter.count;
-    Entries:
-        continue;
+        count += plane_count << plane;
     }
     return count;
 }
 
+unsigned long long ListAgreeSetSample::GetNumAgreeSupersets(Vertical const& agreement) const {
+    return CountAgreeSets(SelectAgreeSets(agreement));
+}
+
 unsigned long long ListAgreeSetSample::GetNumAgreeSupersets(Vertical const& agreement,
                                                             Vertical const& disagreement) const {
-    unsigned long long count = 0;
-    std::vector<unsigned long long> min_agree_set =
-        *BitSetToLongLongVector(agreement.GetColumnIndices());
-    std::vector<unsigned long long> min_disagree_set =
-        *BitSetToLongLongVector(disagreement.GetColumnIndices());
-    //std::cout << "-----------------------------------\n";
-    for (const auto& agree_set_counter : agree_set_counters_) {
-        /*for (auto const& el : *agree_set_counter.agreeSet_)
-            std::cout << el << ' ';
-        std::cout << agree_set_counter.count_ << "\n";*/
-        std::vector<unsigned long long> agree_set = *agree_set_counter.agree_set;
-        //check the agreement
-        unsigned int i = 0;
-        unsigned int min_fields = std::min(agree_set.size(), min_agree_set.size());
-        while (i < min_fields) {
-            if ((agree_set[i] & min_agree_set[i]) != min_agree_set[i]) goto Entries;
-            i++;
-        }
-        while (i < min_agree_set.size()) {
-            if (min_agree_set[i] != 0) goto Entries;
-            i++;
-        }
-        //check the disagreement
-        i = 0;
-        min_fields = std::min(agree_set.size(), min_disagree_set.size());
-        while (i < min_fields) {
-            if ((agree_set[i] & min_disagree_set[i]) != 0) goto Entries;
-            i++;
-        }
-
-        count += agree_set_counter.count;
-    Entries:
-        continue;
-    }
+    std::vector<Word> selection = SelectAgreeSets(agreement);
+    ExcludeAgreeSets(disagreement, selection);
+    unsigned long long count = CountAgreeSets(selection);
     LOG(DEBUG) << boost::format{"AgreeSetSample for %1% against %2% returned %3% "} %
                       agreement.ToString() % disagreement.ToString() % count;
-    //std::cout << '\n';
-    //_numQueries
-    //_nanoQueries
     return count;
 }
 
 std::unique_ptr<std::vector<unsigned long long>> ListAgreeSetSample::GetNumAgreeSupersetsExt(
     Vertical const& agreement, Vertical const& disagreement) const {
-    unsigned long long count = 0, count_agreements = 0;
-    std::vector<unsigned long long> min_agree_set =
-        *BitSetToLongLongVector(agreement.GetColumnIndices());
-    std::vector<unsigned long long> min_disagree_set =
-        *BitSetToLongLongVector(disagreement.GetColumnIndices());
-
-    for (const auto& agree_set_counter : agree_set_counters_) {
-        std::vector<unsigned long long> agree_set = *agree_set_counter.agree_set;
-        //check the agreement
-        unsigned int i = 0;
-        unsigned int min_fields = std::min(agree_set.size(), min_agree_set.size());
-        while (i < min_fields) {
-            if ((agree_set[i] & min_agree_set[i]) != min_agree_set[i]) goto Entries;
-            i++;
-        }
-        while (i < min_agree_set.size()) {
-            if (min_agree_set[i] != 0) goto Entries;
-            i++;
-        }
-        count_agreements += agree_set_counter.count;
-        //check the disagreement
-        i = 0;
-        min_fields = std::min(agree_set.size(), min_disagree_set.size());
-        while (i < min_fields) {
-            if ((agree_set[i] & min_disagree_set[i]) != 0) goto Entries;
-            i++;
-        }
-
-        count += agree_set_counter.count;
-    Entries:
-        continue;
-    }
+    std::vector<Word> selection = SelectAgreeSets(agreement);
+    unsigned long long count_agreements = CountAgreeSets(selection);
+    ExcludeAgreeSets(disagreement, selection);
+    unsigned long long count = CountAgreeSets(selection);
     return std::make_unique<std::vector<unsigned long long>>(
             std::vector<unsigned long long>{count_agreements, count});
 }
@@ -10,20 +10,23 @@ namespace model {
 // TODO: Java long ~ C++ long long => consider replacing ints with longlongs
 class ListAgreeSetSample : public AgreeSetSample {
 private:
-    struct Entry {
-        unsigned int count;
-        std::shared_ptr<std::vector<unsigned long long>> agree_set;
-
-        Entry(std::shared_ptr<std::vector<unsigned long long>> agree_set, unsigned int count)
-            : count(count), agree_set(std::move(agree_set)) {}
-    };
-
-    std::vector<Entry> agree_set_counters_;
+    using Word = unsigned long long;
+    static constexpr size_t kWordBits = 64;
+
+    // Distinct sampled agree sets are stored column-major: the i-th bit of the c-th row (a row is
+    // num_words_ words long) tells whether the i-th agree set contains the c-th column, so the
+    // agree sets matching a query are found by AND-ing the rows of its columns
+    size_t num_words_;
+    std::vector<Word> agree_set_matrix_;
+    // Multiplicities of the agree sets, bit-sliced: the i-th bit of the b-th row is the b-th bit
+    // of the i-th agree set's count
+    std::vector<Word> count_planes_;
+
+    std::vector<Word> SelectAgreeSets(Vertical const& agreement) const;
+    void ExcludeAgreeSets(Vertical const& disagreement, std::vector<Word>& selection) const;
+    unsigned long long CountAgreeSets(std::vector<Word> const& selection) const;
 
 public:
-    static std::unique_ptr<std::vector<unsigned long long>> BitSetToLongLongVector(
-        boost::dynamic_bitset<> const& bitset);
-
     static std::unique_ptr<ListAgreeSetSample> CreateFocusedFor(
         ColumnLayoutRelationData const* relation, Vertical const& restriction_vertical,
         PositionListIndex const* restriction_p_li, unsigned int sample_size, CustomRandom& random);
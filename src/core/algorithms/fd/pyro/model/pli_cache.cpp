@@ -124,9 +124,12 @@ std::variant<PositionListIndex*, std::unique_ptr<PositionListIndex>> PLICache::G
             column_pli->IncFreq();
         }
     }
-    // sort operands by ascending order
-    std::sort(operands.begin(), operands.end(),
-              [](auto& el1, auto& el2) { return el1.pli_->GetSize() < el2.pli_->GetSize(); });
+    // sort operands by ascending size, the ones with more clusters split finer and go first on ties
+    std::sort(operands.begin(), operands.end(), [](auto& el1, auto& el2) {
+        return el1.pli_->GetSize() < el2.pli_->GetSize() ||
+               (el1.pli_->GetSize() == el2.pli_->GetSize() &&
+                el1.pli_->GetNumCluster() > el2.pli_->GetNumCluster());
+    });
     // TODO: Profiling context stuff
 
     LOG(DEBUG) << boost::format{"Intersecting %1%."} % "[UNIMPLEMENTED]";
@@ -139,10 +142,12 @@ std::variant<PositionListIndex*, std::unique_ptr<PositionListIndex>> PLICache::G
     //  поэтому приходится через variant разбирать. Проверить, насколько много платим за обёртку.
     // Intersect and cache
     std::variant<PositionListIndex*, std::unique_ptr<PositionListIndex>> variant_intersection_pli;
-    if (operands.size() >= profiling_context->GetParameters().nary_intersection_size) {
-        PositionListIndexRank base_pli_rank = operands[0];
-        auto intersection_pli = base_pli_rank.pli_->ProbeAll(
-                vertical.Without(*base_pli_rank.vertical_), *relation_data_);
+    if (IsNaryProbeCheaper(operands)) {
+        std::vector<PositionListIndex const*> probed_plis;
+        for (size_t i = 1; i < operands.size(); i++) {
+            probed_plis.push_back(operands[i].pli_.get());
+        }
+        auto intersection_pli = operands[0].pli_->ProbeAll(probed_plis);
         variant_intersection_pli =
                 CachingProcess(vertical, std::move(intersection_pli), profiling_context);
     } else {
@@ -171,6 +176,27 @@ std::variant<PositionListIndex*, std::unique_ptr<PositionListIndex>> PLICache::G
     return variant_intersection_pli;
 }
 
+bool PLICache::IsNaryProbeCheaper(std::vector<PositionListIndexRank> const& operands) const {
+    // Rough per-tuple costs of looking a tuple up in a probing table and of putting it into a
+    // new cluster. Probing tables of the operands are needed by both methods, so they are ignored.
+    constexpr double kLookupCost = 1;
+    constexpr double kClusteringCost = 4;
+    double const num_rows = relation_data_->GetNumRows();
+
+    // pairwise intersections only handle the tuples left by the previous ones, an n-ary probe
+    // looks every tuple of the smallest operand up in all the other operands at once
+    double pairwise_cost = 0;
+    double intersection_size = operands.front().pli_->GetSize();
+    for (size_t i = 1; i < operands.size(); i++) {
+        pairwise_cost += intersection_size * (kLookupCost + kClusteringCost);
+        // assuming independence, this is the share of tuples that are not singletons in operand
+        intersection_size *= operands[i].pli_->GetSize() / num_rows;
+    }
+    double const nary_cost = operands.front().pli_->GetSize() *
+                             ((operands.size() - 1) * kLookupCost + kClusteringCost);
+    return nary_cost < pairwise_cost;
+}
+
 size_t PLICache::Size() const {
     return index_->GetSize();
 }
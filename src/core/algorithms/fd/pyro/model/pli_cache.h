@@ -44,6 +44,9 @@ private:
     double median_gini_;
     double median_inverted_entropy_;
 
+    // Estimates whether one n-ary probe is cheaper than a chain of pairwise intersections
+    // for the operands sorted by size
+    bool IsNaryProbeCheaper(std::vector<PositionListIndexRank> const& operands) const;
     std::variant<PositionListIndex*, std::unique_ptr<PositionListIndex>> CachingProcess(
             Vertical const& vertical, std::unique_ptr<PositionListIndex> pli,
             ProfilingContext* profiling_context);
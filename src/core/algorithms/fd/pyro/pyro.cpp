@@ -16,8 +16,6 @@
 
 namespace algos {
 
-std::mutex searchSpacesMutex;
-
 Pyro::Pyro() : PliBasedFDAlgorithm({kDefaultPhaseName}) {
     RegisterOptions();
     ucc_consumer_ = [this](auto const& key) { this->DiscoverUcc(key); };
@@ -99,43 +97,61 @@ unsigned long long Pyro::ExecuteInternal() {
     unsigned long long total_trickle = 0;
     double progress_step = 100.0 / search_spaces_.size();
 
-    const auto work_on_search_space = [this, &progress_step](
-        std::list<std::unique_ptr<SearchSpace>>& search_spaces,
-        ProfilingContext* profiling_context, int id) {
-        unsigned long long millis = 0;
+    struct SearchSpaceWorkload {
+        SearchSpace* search_space;
+        config::ThreadNumType num_workers = 0;
+        // cleared when Discover() returns: the queue of the search space is empty and none of
+        // its workers holds a launch pad, so no one joins after that
+        bool has_launch_pads = true;
+    };
+    std::vector<SearchSpaceWorkload> workloads;
+    for (auto& search_space : search_spaces_) {
+        search_space->SetContext(profiling_context.get());
+        workloads.push_back({search_space.get()});
+    }
+    std::mutex workloads_mutex;
+
+    // Each worker joins the search space with the fewest workers, so that narrow tables with
+    // few search spaces still keep all threads busy
+    auto const work_on_search_spaces = [this, &progress_step, &workloads, &workloads_mutex](
+                                               int id) {
         while (true) {
-            auto thread_start_time = std::chrono::system_clock::now();
-            std::unique_ptr<SearchSpace> polled_space;
+            SearchSpaceWorkload* workload = nullptr;
             {
-                std::scoped_lock<std::mutex> lock(searchSpacesMutex);
-                if (search_spaces.empty()) {
+                std::scoped_lock lock(workloads_mutex);
+                for (auto& candidate : workloads) {
+                    if (!candidate.has_launch_pads ||
+                        candidate.num_workers >= parameters_.max_threads_per_search_space) {
+                        continue;
+                    }
+                    if (workload == nullptr || candidate.num_workers < workload->num_workers) {
+                        workload = &candidate;
+                    }
+                }
+                if (workload == nullptr) {
                     break;
                 }
-                polled_space = std::move(search_spaces.front());
-                search_spaces.pop_front();
+                ++workload->num_workers;
+            }
+            LOG(TRACE) << "Thread" << id << " got SearchSpace " << workload->search_space->id_;
+            workload->search_space->EnsureInitialized();
+            workload->search_space->Discover();
+
+            std::scoped_lock lock(workloads_mutex);
+            workload->has_launch_pads = false;
+            if (--workload->num_workers == 0) {
+                AddProgress(progress_step);
             }
-            LOG(TRACE) << "Thread" << id << " got SearchSpace";
-            polled_space->SetContext(profiling_context);
-            polled_space->EnsureInitialized();
-            polled_space->Discover();
-            AddProgress(progress_step);
-
-            millis += std::chrono::duration_cast<std::chrono::milliseconds>(
-                          std::chrono::system_clock::now() - thread_start_time)
-                          .count();
         }
-        //cout << "Thread" << id << " stopped working, ELAPSED TIME: " << millis << "ms.\n";
     };
 
     std::vector<std::thread> threads;
     for (int i = 0; i < parameters_.parallelism; i++) {
-        //std::thread();
-        threads.emplace_back(work_on_search_space, std::ref(search_spaces_),
-                             profiling_context.get(), i);
+        threads.emplace_back(work_on_search_spaces, i);
     }
 
-    for (int i = 0; i < parameters_.parallelism; i++) {
-        threads[i].join();
+    for (auto& thread : threads) {
+        thread.join();
     }
 
     SetProgress(100);
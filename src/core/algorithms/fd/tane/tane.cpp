@@ -300,7 +300,7 @@ unsigned long long Tane::ExecuteInternal() {
 
     LOG(INFO) << "Time: " << apriori_millis_ << " milliseconds";
     LOG(INFO) << "Intersection time: " << model::PositionListIndex::micros_ / 1000 << "ms";
-    LOG(INFO) << "Total intersections: " << model::PositionListIndex::intersection_count_
+    LOG(INFO) << "Total intersections: " << model::PositionListIndex::intersection_count_.load()
               << std::endl;
     LOG(INFO) << "Total FD count: " << count_of_fd_;
     LOG(INFO) << "Total UCC count: " << count_of_ucc_;
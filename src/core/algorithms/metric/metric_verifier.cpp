@@ -1,9 +1,16 @@
 #include "algorithms/metric/metric_verifier.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cmath>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -16,6 +23,11 @@
 #include "config/names_and_descriptions.h"
 #include "config/option_using.h"
 #include "config/tabular_data/input_table/option.h"
+#include "config/thread_number/option.h"
+#include "util/bk_tree.h"
+#include "util/levenshtein_distance.h"
+#include "util/parallel_for.h"
+#include "util/vp_tree.h"
 
 namespace algos::metric {
 
@@ -113,6 +125,7 @@ void MetricVerifier::RegisterOptions() {
                           kDDistFromNullIsInfinity, false});
     RegisterOption(Option{&parameter_, kParameter, kDParameter}.SetValueCheck(check_parameter));
     RegisterOption(Option{&q_, kQGramLength, kDQGramLength, 2u}.SetValueCheck(q_check));
+    RegisterOption(config::ThreadNumberOpt(&threads_num_));
     RegisterOption(config::RhsIndicesOpt(&rhs_indices_, get_schema_columns, check_rhs)
                            .SetConditionalOpts({{need_algo_and_q, {kMetricAlgorithm, kQGramLength}},
                                                 {need_algo_only, {kMetricAlgorithm}}}));
@@ -122,8 +135,8 @@ void MetricVerifier::RegisterOptions() {
 
 void MetricVerifier::MakeExecuteOptsAvailable() {
     using namespace config::names;
-    MakeOptionsAvailable(
-            {kDistFromNullIsInfinity, kParameter, kMetric, config::LhsIndicesOpt.GetName()});
+    MakeOptionsAvailable({kDistFromNullIsInfinity, kParameter, kMetric,
+                          config::LhsIndicesOpt.GetName(), config::ThreadNumberOpt.GetName()});
 }
 
 void MetricVerifier::LoadDataInternal() {
@@ -229,15 +242,97 @@ void MetricVerifier::VerifyMetricFD() {
         pli = pli->Intersect(relation_->GetColumnData(lhs_indices_[i]).GetPositionListIndex());
     }
 
-    metric_fd_holds_ = true;
+    std::deque<model::PLI::Cluster> const& clusters = pli->GetIndex();
     auto cluster_func = GetClusterFunction();
-    for (auto const& cluster : pli->GetIndex()) {
-        if (!cluster_func(cluster)) {
-            metric_fd_holds_ = false;
+
+    // Clusters are handed out one by one, the largest first when there are several threads, so
+    // that a few huge clusters do not leave the other threads idle at the end
+    std::vector<size_t> order(clusters.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (threads_num_ > 1) {
+        std::stable_sort(order.begin(), order.end(), [&clusters](size_t a, size_t b) {
+            return clusters[a].size() > clusters[b].size();
+        });
+    }
+
+    constexpr size_t kNoCluster = std::numeric_limits<size_t>::max();
+    struct WorkerResult {
+        // Lowest index of a cluster the metric FD does not hold on
+        size_t violating_cluster = kNoCluster;
+        // Highlights of the clusters the metric FD does not hold on, with the cluster indices
+        std::vector<std::pair<size_t, std::vector<Highlight>>> highlights;
+        // Lowest index of a cluster whose check has thrown, with the exception
+        size_t error_cluster = kNoCluster;
+        std::exception_ptr error;
+    };
+    // No more workers than clusters, so a tiny table does not start a thread per core
+    size_t const num_workers = std::min<size_t>(threads_num_, clusters.size());
+    std::vector<WorkerResult> results(num_workers);
+    std::atomic<size_t> next_cluster = 0;
+    // Lowest index of a cluster that ends a sequential check: the first one that throws or, for
+    // approx, the first one the metric FD does not hold on. The clusters after it are skipped, the
+    // ones before it are all checked, so the outcome does not depend on the scheduling
+    std::atomic<size_t> last_cluster = kNoCluster;
+    auto lower_last_cluster = [&last_cluster](size_t cluster) {
+        size_t current = last_cluster;
+        while (cluster < current && !last_cluster.compare_exchange_weak(current, cluster)) {
+        }
+    };
+
+    auto verify = [&](unsigned worker) {
+        WorkerResult& result = results[worker];
+        for (size_t i = next_cluster++; i < order.size(); i = next_cluster++) {
+            size_t const cluster = order[i];
+            if (cluster > last_cluster) {
+                continue;
+            }
+            std::vector<Highlight> cluster_highlights;
+            try {
+                if (cluster_func(clusters[cluster], cluster_highlights)) {
+                    continue;
+                }
+            } catch (...) {
+                if (cluster < result.error_cluster) {
+                    result.error_cluster = cluster;
+                    result.error = std::current_exception();
+                }
+                lower_last_cluster(cluster);
+                continue;
+            }
+            result.violating_cluster = std::min(result.violating_cluster, cluster);
             if (algo_ == +MetricAlgo::approx) {
-                break;
+                lower_last_cluster(cluster);
+                continue;
             }
+            result.highlights.emplace_back(cluster, std::move(cluster_highlights));
+        }
+    };
+    std::vector<unsigned> workers(num_workers);
+    std::iota(workers.begin(), workers.end(), 0);
+    util::parallel_foreach(workers.begin(), workers.end(), threads_num_, verify);
+
+    WorkerResult const* failed = nullptr;
+    size_t violating_cluster = kNoCluster;
+    std::vector<std::pair<size_t, std::vector<Highlight>>> highlights;
+    for (WorkerResult& result : results) {
+        if (result.error && (failed == nullptr || result.error_cluster < failed->error_cluster)) {
+            failed = &result;
         }
+        violating_cluster = std::min(violating_cluster, result.violating_cluster);
+        std::move(result.highlights.begin(), result.highlights.end(),
+                  std::back_inserter(highlights));
+    }
+    // Without approx every cluster is checked, so any error is reached sequentially
+    if (failed != nullptr &&
+        (algo_ != +MetricAlgo::approx || failed->error_cluster < violating_cluster)) {
+        std::rethrow_exception(failed->error);
+    }
+
+    metric_fd_holds_ = violating_cluster == kNoCluster;
+    std::sort(highlights.begin(), highlights.end(),
+              [](auto const& a, auto const& b) { return a.first < b.first; });
+    for (auto& cluster_highlights : highlights) {
+        highlight_calculator_->AddClusterHighlights(std::move(cluster_highlights.second));
     }
 }
 
@@ -260,46 +355,37 @@ ClusterFunction MetricVerifier::GetClusterFunctionForOneDimension() {
     assert(col.GetTypeId() == +model::TypeId::kString);
     auto const& type = static_cast<model::StringType const&>(col.GetType());
 
-    std::function<ClusterFunction(DistanceFunction<std::byte const*>)> verify_func;
-    if (algo_ == +MetricAlgo::brute) {
-        verify_func = [this](auto dist_func) {
-            return CalculateClusterFunction<IndexedOneDimensionalPoint>(
-                    [this](auto const& cluster) {
-                        return points_calculator_->CalculateIndexedPoints(cluster);
-                    },
-                    [this, dist_func](auto const& points) {
-                        return this->BruteVerifyCluster(points, dist_func);
-                    },
-                    [this, dist_func](auto const& points,
-                                      std::vector<Highlight>&& cluster_highlights) {
-                        return highlight_calculator_->CalculateHighlightsForStrings(
-                                points, std::move(cluster_highlights), dist_func);
-                    });
-        };
+    DistanceFunction<std::byte const*> dist_func;
+    CompareFunction<IndexedOneDimensionalPoint> compare_func;
+    if (metric_ == +Metric::levenshtein) {
+        dist_func = [&type](std::byte const* l, std::byte const* r) { return type.Dist(l, r); };
+        compare_func = [this](auto const& points) { return LevenshteinVerifyCluster(points); };
     } else {
-        verify_func = [this](auto const& dist_func) {
-            return CalculateApproxClusterFunction<std::byte const*>(
-                    [this](auto const& cluster) {
-                        return points_calculator_->CalculatePoints(cluster);
-                    },
-                    dist_func);
-        };
+        CalculateQGramVectors(col);
+        dist_func = GetCosineDistFunction();
+        compare_func = [this](auto const& points) { return CosineVerifyCluster(points); };
     }
 
-    if (metric_ == +Metric::levenshtein) {
-        return verify_func(
-                [&type](std::byte const* l, std::byte const* r) { return type.Dist(l, r); });
+    if (algo_ == +MetricAlgo::brute) {
+        return CalculateClusterFunction<IndexedOneDimensionalPoint>(
+                [this](auto const& cluster) {
+                    return points_calculator_->CalculateIndexedPoints(cluster);
+                },
+                compare_func,
+                [this, dist_func](auto const& points, std::vector<Highlight>&& cluster_highlights) {
+                    return highlight_calculator_->CalculateHighlightsForStrings(
+                            points, std::move(cluster_highlights), dist_func);
+                });
     }
-
-    return [this, &type, verify_func](model::PLI::Cluster const& cluster) {
-        std::unordered_map<std::string, util::QGramVector> q_gram_map;
-        return verify_func(GetCosineDistFunction(type, q_gram_map))(cluster);
-    };
+    return CalculateApproxClusterFunction<std::byte const*>(
+            [this](auto const& cluster) { return points_calculator_->CalculatePoints(cluster); },
+            dist_func);
 }
 
 ClusterFunction MetricVerifier::GetClusterFunctionForSeveralDimensions() {
     if (algo_ == +MetricAlgo::calipers) {
-        return [this](model::PLI::Cluster const& cluster) {
+        return [this](model::PLI::Cluster const& cluster,
+                      std::vector<Highlight>& cluster_highlights) {
             auto result = points_calculator_->CalculateMultidimensionalPointsForCalipers(cluster);
             if (!CheckMFDFailIfHasNulls(result.has_nulls) &&
                 CalipersCompareNumericValues(result.points)) {
@@ -308,7 +394,7 @@ ClusterFunction MetricVerifier::GetClusterFunctionForSeveralDimensions() {
 
             auto result_indexed =
                     points_calculator_->CalculateMultidimensionalIndexedPoints(cluster);
-            highlight_calculator_->CalculateMultidimensionalHighlights(
+            cluster_highlights = highlight_calculator_->CalculateMultidimensionalHighlights(
                     result_indexed.points, std::move(result_indexed.cluster_highlights));
             return false;
         };
@@ -341,20 +427,32 @@ ClusterFunction MetricVerifier::GetClusterFunction() {
     return GetClusterFunctionForSeveralDimensions();
 }
 
-DistanceFunction<std::byte const*> MetricVerifier::GetCosineDistFunction(
-        model::StringType const& type,
-        std::unordered_map<std::string, util::QGramVector>& q_gram_map) const {
-    return [this, &type, &q_gram_map](std::byte const* a, std::byte const* b) -> long double {
-        std::string str1 = type.ValueToString(a);
-        std::string str2 = type.ValueToString(b);
-        if (str1.length() < q_ || str2.length() < q_) {
-            throw std::runtime_error(
-                    "q-gram length should not exceed the minimum string length "
-                    "in the dataset.");
+void MetricVerifier::CalculateQGramVectors(model::TypedColumnData const& col) {
+    q_gram_vectors_.clear();
+    for (size_t i = 0; i < col.GetNumRows(); ++i) {
+        if (col.IsNullOrEmpty(i)) {
+            continue;
         }
-        util::QGramVector const& v1 = q_gram_map.try_emplace(str1, str1, q_).first->second;
-        util::QGramVector const& v2 = q_gram_map.try_emplace(str2, str2, q_).first->second;
-        return v1.CosineDistance(v2);
+        std::string const& value = model::Type::GetValue<model::String>(col.GetData()[i]);
+        if (value.length() >= q_) {
+            q_gram_vectors_.try_emplace(value, value, q_);
+        }
+    }
+}
+
+util::QGramVector const& MetricVerifier::GetQGramVector(std::byte const* value) const {
+    std::string const& string = model::Type::GetValue<model::String>(value);
+    if (string.length() < q_) {
+        throw std::runtime_error(
+                "q-gram length should not exceed the minimum string length "
+                "in the dataset.");
+    }
+    return q_gram_vectors_.at(string);
+}
+
+DistanceFunction<std::byte const*> MetricVerifier::GetCosineDistFunction() const {
+    return [this](std::byte const* a, std::byte const* b) -> long double {
+        return GetQGramVector(a).CosineDistance(GetQGramVector(b));
     };
 }
 
@@ -362,12 +460,13 @@ template <typename T>
 ClusterFunction MetricVerifier::CalculateClusterFunction(
         IndexedPointsFunction<T> points_func, CompareFunction<T> compare_func,
         HighlightFunction<T> highlight_func) const {
-    return [this, points_func, compare_func, highlight_func](model::PLI::Cluster const& cluster) {
+    return [this, points_func, compare_func, highlight_func](
+                   model::PLI::Cluster const& cluster, std::vector<Highlight>& cluster_highlights) {
         auto result = points_func(cluster);
         if (!CheckMFDFailIfHasNulls(result.has_nulls) && compare_func(result.points)) {
             return true;
         }
-        highlight_func(result.points, std::move(result.cluster_highlights));
+        cluster_highlights = highlight_func(result.points, std::move(result.cluster_highlights));
         return false;
     };
 }
@@ -375,7 +474,9 @@ ClusterFunction MetricVerifier::CalculateClusterFunction(
 template <typename T>
 ClusterFunction MetricVerifier::CalculateApproxClusterFunction(
         PointsFunction<T> points_func, DistanceFunction<T> dist_func) const {
-    return [points_func, dist_func, this](model::PLI::Cluster const& cluster) {
+    return [points_func, dist_func, this](
+                   model::PLI::Cluster const& cluster,
+                   [[maybe_unused]] std::vector<Highlight>& cluster_highlights) {
         auto result = points_func(cluster);
         return !CheckMFDFailIfHasNulls(result.has_nulls) &&
                ApproxVerifyCluster(result.points, dist_func);
@@ -430,6 +531,53 @@ bool MetricVerifier::BruteVerifyCluster(std::vector<IndexedPoint<T>> const& poin
     return true;
 }
 
+bool MetricVerifier::LevenshteinVerifyCluster(
+        std::vector<IndexedOneDimensionalPoint> const& points) const {
+    // Levenshtein distances are whole numbers
+    unsigned const radius =
+            parameter_ < std::numeric_limits<unsigned>::max()
+                    ? static_cast<unsigned>(std::floor(parameter_))
+                    : std::numeric_limits<unsigned>::max();
+    util::BKTree<std::string_view> tree(util::LevenshteinDistance);
+    for (auto const& point : points) {
+        std::string_view value = model::Type::GetValue<model::String>(point.point);
+        if (tree.HasFartherThan(value, radius)) {
+            return false;
+        }
+        tree.Insert(value);
+    }
+    return true;
+}
+
+bool MetricVerifier::CosineVerifyCluster(
+        std::vector<IndexedOneDimensionalPoint> const& points) const {
+    if (points.size() < 2) {
+        return true;
+    }
+    std::vector<util::QGramVector const*> vectors;
+    vectors.reserve(points.size());
+    for (auto const& point : points) {
+        vectors.push_back(&GetQGramVector(point.point));
+    }
+    std::sort(vectors.begin(), vectors.end());
+    vectors.erase(std::unique(vectors.begin(), vectors.end()), vectors.end());
+
+    // Cosine distance does not satisfy the triangle inequality, the angle between the q-gram
+    // vectors does and grows with it. The angle of a vector with itself is not rounded. Rounded
+    // angles only prune the pairs, so the radius is lowered by a slack well above their error and
+    // every farther pair is checked by the same distance as in the brute force verification.
+    static constexpr long double kAngleSlack = 1e-6;
+    auto angle = [](util::QGramVector const* a, util::QGramVector const* b) {
+        return a == b ? 0 : std::acos(std::clamp(a->CosineSimilarity(*b), -1.0L, 1.0L));
+    };
+    auto violates = [this](util::QGramVector const* a, util::QGramVector const* b) {
+        return a->CosineDistance(*b) > parameter_;
+    };
+    long double const radius = std::acos(std::clamp(1 - parameter_, -1.0L, 1.0L)) - kAngleSlack;
+    return !util::VPTree<util::QGramVector const*>(std::move(vectors), angle)
+                    .HasPairFartherThan(radius, violates);
+}
+
 bool MetricVerifier::CalipersCompareNumericValues(std::vector<util::Point>& points) const {
     auto pairs = util::GetAntipodalPairs(util::CalculateConvexHull(points));
     return std::all_of(pairs.cbegin(), pairs.cend(), [this](auto const& pair) {
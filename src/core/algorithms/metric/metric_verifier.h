@@ -6,6 +6,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -18,6 +19,7 @@
 #include "config/equal_nulls/type.h"
 #include "config/indices/type.h"
 #include "config/tabular_data/input_table_type.h"
+#include "config/thread_number/type.h"
 #include "model/table/column_layout_relation_data.h"
 #include "model/table/column_layout_typed_relation_data.h"
 #include "util/convex_hull.h"
@@ -37,6 +39,7 @@ private:
     unsigned int q_;
     bool dist_from_null_is_infinity_;
     config::EqNullsType is_null_equal_null_;
+    config::ThreadNumType threads_num_ = 1;
 
     bool metric_fd_holds_ = false;
 
@@ -44,10 +47,12 @@ private:
     std::shared_ptr<ColumnLayoutRelationData> relation_;  // temporarily parsing twice
     std::unique_ptr<PointsCalculator> points_calculator_;
     std::unique_ptr<HighlightCalculator> highlight_calculator_;
+    // Q-gram vectors of the distinct RHS values that are not shorter than q
+    std::unordered_map<std::string_view, util::QGramVector> q_gram_vectors_;
 
-    DistanceFunction<std::byte const*> GetCosineDistFunction(
-            model::StringType const& type,
-            std::unordered_map<std::string, util::QGramVector>& q_gram_map) const;
+    void CalculateQGramVectors(model::TypedColumnData const& col);
+    util::QGramVector const& GetQGramVector(std::byte const* value) const;
+    DistanceFunction<std::byte const*> GetCosineDistFunction() const;
 
     bool CheckMFDFailIfHasNulls(bool has_nulls) const {
         return dist_from_null_is_infinity_ && has_nulls;
@@ -63,6 +68,10 @@ private:
                             DistanceFunction<T> const& dist_func) const;
 
     bool CalipersCompareNumericValues(std::vector<util::Point>& points) const;
+    // Exact checks of string clusters through metric indexes, they give the same result as
+    // BruteVerifyCluster without comparing every pair of values
+    bool LevenshteinVerifyCluster(std::vector<IndexedOneDimensionalPoint> const& points) const;
+    bool CosineVerifyCluster(std::vector<IndexedOneDimensionalPoint> const& points) const;
 
     template <typename T>
     ClusterFunction CalculateClusterFunction(IndexedPointsFunction<T> points_func,
@@ -42,7 +42,7 @@ private:
                                        model::PLI::Cluster const& cluster) const;
     bool ValuesAreClose(std::byte const* l, std::byte const* r, model::Type const& type) const {
         assert(type.IsMetrizable());
-        return static_cast<model::IMetrizableType const&>(type).Dist(l, r) < radius_;
+        return static_cast<model::IMetrizableType const&>(type).IsDistLess(l, r, radius_);
     }
     explicit TypoMiner(std::unique_ptr<FDAlgorithm> precise_algo,
                        std::unique_ptr<FDAlgorithm> approx_algo);
@@ -0,0 +1,86 @@
+#include "uniqueness_checker.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "algorithms/fd/hycommon/util/pli_util.h"
+
+namespace algos::hyucc {
+
+size_t UniquenessChecker::PrepareTable(size_t num_records) {
+    size_t capacity = 2;
+    while (capacity < 2 * num_records) {
+        capacity *= 2;
+    }
+    if (table_.size() < capacity) {
+        table_.assign(capacity, Slot{0, 0});
+    }
+
+    if (++generation_ == 0) {
+        std::fill(table_.begin(), table_.end(), Slot{0, 0});
+        generation_ = 1;
+    }
+    return capacity - 1;
+}
+
+bool UniquenessChecker::IsUnique(hy::IdPairs& comparison_suggestions,
+                                 model::PLI const& pivot_pli, size_t first_cluster,
+                                 size_t last_cluster, hy::Rows const& compressed_records,
+                                 model::RawUCC const& ucc,
+                                 std::function<bool()> const& should_stop) {
+    constexpr std::uint64_t kHashMultiplier = 0x9E3779B97F4A7C15;
+    using hy::PLIUtil;
+
+    columns_.clear();
+    for (size_t attr = ucc.find_first(); attr != model::RawUCC::npos; attr = ucc.find_next(attr)) {
+        columns_.push_back(attr);
+    }
+
+    auto const have_equal_ids = [this, &compressed_records](RecordId first, RecordId second) {
+        return std::all_of(columns_.begin(), columns_.end(), [&](size_t column) {
+            return compressed_records.Get(first, column) == compressed_records.Get(second, column);
+        });
+    };
+
+    auto const& clusters = pivot_pli.GetIndex();
+    for (size_t cluster_index = first_cluster; cluster_index != last_cluster; ++cluster_index) {
+        if (should_stop && should_stop()) {
+            return true;
+        }
+
+        model::PLI::Cluster const& cluster = clusters[cluster_index];
+        size_t const slot_mask = PrepareTable(cluster.size());
+        for (RecordId record : cluster) {
+            std::uint64_t hash = 0;
+            bool is_in_singleton = false;
+            for (size_t column : columns_) {
+                hy::ClusterId const cluster_id = compressed_records.Get(record, column);
+                if (PLIUtil::IsSingletonCluster(cluster_id)) {
+                    is_in_singleton = true;
+                    break;
+                }
+                hash = (hash ^ cluster_id) * kHashMultiplier;
+            }
+            if (is_in_singleton) {
+                continue;
+            }
+
+            for (size_t slot_index = (hash ^ (hash >> 32)) & slot_mask;;
+                 slot_index = (slot_index + 1) & slot_mask) {
+                Slot& slot = table_[slot_index];
+                if (slot.generation != generation_) {
+                    slot = Slot{generation_, record};
+                    break;
+                }
+                if (have_equal_ids(slot.record, record)) {
+                    comparison_suggestions.emplace_back(record, slot.record);
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+}  // namespace algos::hyucc
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "algorithms/fd/hycommon/compressed_records.h"
+#include "algorithms/fd/hycommon/types.h"
+#include "algorithms/ucc/raw_ucc.h"
+#include "model/table/position_list_index.h"
+
+namespace algos::hyucc {
+
+// Checks whether a column combination is unique within the clusters of one of its columns. Records
+// of a cluster are grouped by their cluster ids in the other columns in an open-addressing table
+// that is reused for every cluster and every call. Keys are not copied: the table stores the first
+// record of each group and the cluster ids are compared in the compressed records directly.
+// A checker must not be shared between threads.
+class UniquenessChecker {
+private:
+    using RecordId = model::PLI::Cluster::value_type;
+
+    struct Slot {
+        unsigned generation;
+        RecordId record;
+    };
+
+    std::vector<Slot> table_;
+    // Slots of the previous generations are empty, so the table is cleared by a single increment
+    unsigned generation_ = 0;
+    std::vector<size_t> columns_;
+
+    // Starts a new generation with at least twice as many slots as records, returns the slot mask
+    size_t PrepareTable(size_t num_records);
+
+public:
+    // Checks the clusters with indices in [first_cluster, last_cluster) of pivot_pli, whose column
+    // ucc must not contain. On the first pair of records that agree on all columns of ucc the pair
+    // is added to comparison_suggestions and false is returned. should_stop is polled before every
+    // cluster, once it returns true the rest of the clusters is skipped.
+    bool IsUnique(hy::IdPairs& comparison_suggestions, model::PLI const& pivot_pli,
+                  size_t first_cluster, size_t last_cluster, hy::Rows const& compressed_records,
+                  model::RawUCC const& ucc, std::function<bool()> const& should_stop = {});
+};
+
+}  // namespace algos::hyucc
@@ -1,5 +1,7 @@
 #include "validator.h"
 
+#include <algorithm>
+#include <atomic>
 #include <future>
 
 #include <boost/asio/post.hpp>
@@ -44,38 +46,67 @@ size_t AddExtendedCandidatesFromInvalid(std::vector<algos::hyucc::LhsPair>& next
     return candidates;
 }
 
+// Runs f(worker) for every worker in [0, num_workers) on the pool and waits for all of them
+template <typename F>
+void RunWorkers(boost::asio::thread_pool& pool, size_t num_workers, F const& f) {
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_workers);
+    for (size_t worker = 0; worker < num_workers; ++worker) {
+        std::packaged_task<void()> task([&f, worker]() { f(worker); });
+        futures.push_back(task.get_future());
+        boost::asio::post(pool, std::move(task));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
 }  // namespace
 
 namespace algos::hyucc {
 
 using model::RawUCC;
 
-bool Validator::IsUnique(model::PLI const& pivot_pli, RawUCC const& ucc,
-                         hy::IdPairs& comparison_suggestions) {
-    std::vector<hy::ClusterId> indices = util::BitsetToIndices<hy::ClusterId>(ucc);
-    for (model::PLI::Cluster const& cluster : pivot_pli.GetIndex()) {
-        auto cluster_to_record =
-                hy::MakeClusterIdentifierToTMap<model::PLI::Cluster::value_type>(cluster.size());
-        for (auto const record_id : cluster) {
-            std::vector<hy::ClusterId> cluster_id =
-                    hy::BuildClustersIdentifier((*compressed_records_)[record_id], indices);
-            if (cluster_id.empty()) {
-                continue;
-            }
+bool Validator::IsUniqueParallel(model::PLI const& pivot_pli, RawUCC const& ucc,
+                                 hy::IdPairs& comparison_suggestions,
+                                 boost::asio::thread_pool& pool) {
+    size_t const num_clusters = pivot_pli.GetIndex().size();
+    size_t const num_ranges = std::min<size_t>(threads_num_, num_clusters);
+    if (num_ranges <= 1) {
+        return checkers_.front().IsUnique(comparison_suggestions, pivot_pli, 0, num_clusters,
+                                          *compressed_records_, ucc);
+    }
 
-            auto const [it, inserted] =
-                    cluster_to_record.try_emplace(std::move(cluster_id), record_id);
-            if (!inserted) {
-                comparison_suggestions.emplace_back(record_id, it->second);
-                return false;
-            }
+    std::atomic<size_t> first_violating_range = num_ranges;
+    std::vector<hy::IdPairs> range_suggestions(num_ranges);
+    auto const check_range = [&](size_t range) {
+        auto const should_stop = [&first_violating_range, range]() {
+            return first_violating_range.load(std::memory_order_relaxed) < range;
+        };
+        bool const is_unique = checkers_[range].IsUnique(
+                range_suggestions[range], pivot_pli, range * num_clusters / num_ranges,
+                (range + 1) * num_clusters / num_ranges, *compressed_records_, ucc, should_stop);
+        if (is_unique) {
+            return;
         }
-    }
+        size_t current = first_violating_range.load(std::memory_order_relaxed);
+        while (range < current && !first_violating_range.compare_exchange_weak(current, range)) {
+        }
+    };
+    RunWorkers(pool, num_ranges, check_range);
 
-    return true;
+    if (first_violating_range == num_ranges) {
+        return true;
+    }
+    hy::IdPairs const& suggestions = range_suggestions[first_violating_range];
+    comparison_suggestions.insert(comparison_suggestions.end(), suggestions.begin(),
+                                  suggestions.end());
+    return false;
 }
 
-Validator::UCCValidations Validator::GetValidations(LhsPair const& vertex_and_ucc) {
+Validator::UCCValidations Validator::GetValidations(LhsPair const& vertex_and_ucc,
+                                                    UniquenessChecker& checker,
+                                                    boost::asio::thread_pool* split_pool) {
     auto [vertex, ucc] = vertex_and_ucc;
     UCCValidations validations;
     validations.set_count_validations(1);
@@ -91,7 +122,13 @@ Validator::UCCValidations Validator::GetValidations(LhsPair const& vertex_and_uc
         // It's guaranteed that the first cluster has the fewest records because of sorting
         // in the Sampler
         model::PLI const* pivot_pli = (*plis_)[ucc_attr];
-        is_unique = IsUnique(*pivot_pli, ucc, validations.comparison_suggestions());
+        if (split_pool != nullptr) {
+            is_unique = IsUniqueParallel(*pivot_pli, ucc, validations.comparison_suggestions(),
+                                         *split_pool);
+        } else {
+            is_unique = checker.IsUnique(validations.comparison_suggestions(), *pivot_pli, 0,
+                                         pivot_pli->GetIndex().size(), *compressed_records_, ucc);
+        }
         ucc.set(ucc_attr);
     }
 
@@ -110,35 +147,42 @@ Validator::UCCValidations Validator::ValidateAndExtendSeq(
         if (!vertex_and_ucc.first->IsUCC()) {
             continue;
         }
-        result.Add(GetValidations(vertex_and_ucc));
+        result.Add(GetValidations(vertex_and_ucc, checkers_.front()));
     }
     return result;
 }
 
 Validator::UCCValidations Validator::ValidateAndExtendParallel(
         std::vector<LhsPair> const& current_level) {
-    UCCValidations result;
-    boost::asio::thread_pool pool(threads_num_);
-    std::vector<std::future<UCCValidations>> validation_futures;
-
+    std::vector<LhsPair const*> candidates;
     for (auto const& vertex_and_ucc : current_level) {
-        if (!vertex_and_ucc.first->IsUCC()) {
-            continue;
+        if (vertex_and_ucc.first->IsUCC()) {
+            candidates.push_back(&vertex_and_ucc);
         }
-
-        std::packaged_task<UCCValidations()> task(
-                [this, &vertex_and_ucc]() { return GetValidations(vertex_and_ucc); });
-        validation_futures.push_back(task.get_future());
-        boost::asio::post(pool, std::move(task));
     }
 
+    boost::asio::thread_pool pool(threads_num_);
+    std::vector<UCCValidations> validations(candidates.size());
+    if (current_level_number_ > 1 && candidates.size() < threads_num_) {
+        // Too few candidates to keep every thread busy, so each check is split instead
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            validations[i] = GetValidations(*candidates[i], checkers_.front(), &pool);
+        }
+    } else {
+        std::atomic<size_t> next_candidate = 0;
+        auto const validate = [this, &candidates, &validations, &next_candidate](size_t worker) {
+            for (size_t i = next_candidate++; i < candidates.size(); i = next_candidate++) {
+                validations[i] = GetValidations(*candidates[i], checkers_[worker]);
+            }
+        };
+        RunWorkers(pool, std::min<size_t>(threads_num_, candidates.size()), validate);
+    }
     pool.join();
 
-    for (auto& future : validation_futures) {
-        assert(future.valid());
-        result.Add(future.get());
+    UCCValidations result;
+    for (UCCValidations const& candidate_validations : validations) {
+        result.Add(candidate_validations);
     }
-
     return result;
 }
 
@@ -4,7 +4,10 @@
 #include <utility>
 #include <vector>
 
+#include <boost/asio/thread_pool.hpp>
+
 #include "algorithms/ucc/hyucc/model/ucc_tree.h"
+#include "algorithms/ucc/hyucc/uniqueness_checker.h"
 #include "algorithms/ucc/raw_ucc.h"
 #include "config/thread_number/type.h"
 #include "fd/hycommon/primitive_validations.h"
@@ -22,21 +25,29 @@ private:
     hy::RowsPtr compressed_records_;
     unsigned current_level_number_ = 1;
     config::ThreadNumType threads_num_ = 1;
-
-    bool IsUnique(model::PLI const& pivot_pli, model::RawUCC const& ucc,
-                  hy::IdPairs& comparison_suggestions);
-    UCCValidations GetValidations(LhsPair const& vertex_and_ucc);
+    // One checker per thread, so that their tables are reused from level to level
+    std::vector<UniquenessChecker> checkers_;
+
+    // Splits the clusters of pivot_pli into contiguous ranges checked by different threads. Reports
+    // the same suggestion as a sequential check would: a thread stops as soon as a range preceding
+    // its own has a violation.
+    bool IsUniqueParallel(model::PLI const& pivot_pli, model::RawUCC const& ucc,
+                          hy::IdPairs& comparison_suggestions, boost::asio::thread_pool& pool);
+    // If split_pool is not null, the check is split between its threads
+    UCCValidations GetValidations(LhsPair const& vertex_and_ucc, UniquenessChecker& checker,
+                                  boost::asio::thread_pool* split_pool = nullptr);
     UCCValidations ValidateAndExtendSeq(std::vector<LhsPair> const& current_level);
     UCCValidations ValidateAndExtendParallel(std::vector<LhsPair> const& current_level);
     UCCValidations ValidateAndExtend(std::vector<LhsPair> const& current_level);
 
 public:
     Validator(UCCTree* tree, hy::PLIsPtr plis, hy::RowsPtr compressed_records,
-              config::ThreadNumType threads_num) noexcept
+              config::ThreadNumType threads_num)
         : tree_(tree),
           plis_(std::move(plis)),
           compressed_records_(std::move(compressed_records)),
-          threads_num_(threads_num) {}
+          threads_num_(threads_num),
+          checkers_(threads_num) {}
 
     hy::IdPairs ValidateAndExtendCandidates();
 };
@@ -3,6 +3,7 @@
 #include <sstream>
 #include <string>
 
+#include "algorithms/association_rules/ar_algorithm_enums.h"
 #include "algorithms/cfd/enums.h"
 #include "algorithms/metric/enums.h"
 #include "util/enum_to_available_values.h"
@@ -27,6 +28,9 @@ constexpr auto kDInputFormat = "format of the input dataset for AR mining\n[sing
 constexpr auto kDTIdColumnIndex = "index of the column where a TID is stored";
 constexpr auto kDItemColumnIndex = "index of the column where an item name is stored";
 constexpr auto kDFirstColumnTId = "indicates that the first column contains the transaction IDs";
+const std::string _kDSupportCounting = "method of counting the support of candidate itemsets\n" +
+                                       util::EnumToAvailableValues<algos::SupportCounting>();
+const auto kDSupportCounting = _kDSupportCounting.c_str();
 const std::string _kDMetric =
         "metric to use\n" + util::EnumToAvailableValues<algos::metric::Metric>();
 const auto kDMetric = _kDMetric.c_str();
@@ -18,6 +18,7 @@ constexpr auto kInputFormat = "input_format";
 constexpr auto kTIdColumnIndex = "tid_column_index";
 constexpr auto kItemColumnIndex = "item_column_index";
 constexpr auto kFirstColumnTId = "has_tid";
+constexpr auto kSupportCounting = "support_counting";
 constexpr auto kMetric = "metric";
 constexpr auto kLhsIndices = "lhs_indices";
 constexpr auto kRhsIndices = "rhs_indices";
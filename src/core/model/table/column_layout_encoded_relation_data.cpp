@@ -0,0 +1,53 @@
+#include "column_layout_encoded_relation_data.h"
+
+#include <string>
+#include <unordered_map>
+
+#include <easylogging++.h>
+
+namespace model {
+
+std::unique_ptr<ColumnLayoutEncodedRelationData> ColumnLayoutEncodedRelationData::CreateFrom(
+        IDatasetStream& data_stream) {
+    using ValueId = EncodedColumnData::ValueId;
+
+    auto schema = std::make_unique<RelationalSchema>(data_stream.GetRelationName());
+    size_t const num_columns = data_stream.GetNumberOfColumns();
+
+    std::vector<std::unordered_map<std::string, ValueId>> value_dictionaries(num_columns);
+    std::vector<std::vector<ValueId>> column_value_ids(num_columns);
+    std::vector<std::string> row;
+
+    while (data_stream.HasNextRow()) {
+        row = data_stream.GetNextRow();
+
+        if (row.size() != num_columns) {
+            LOG(WARNING) << "Unexpected number of columns for a row, skipping (expected "
+                         << num_columns << ", got " << row.size() << ")";
+            continue;
+        }
+
+        for (size_t index = 0; index < row.size(); ++index) {
+            auto& value_dictionary = value_dictionaries[index];
+            ValueId const next_value_id = value_dictionary.size();
+            auto [location, is_new_value] =
+                    value_dictionary.try_emplace(std::move(row[index]), next_value_id);
+            column_value_ids[index].push_back(location->second);
+        }
+    }
+
+    std::vector<EncodedColumnData> column_data;
+    for (size_t i = 0; i < num_columns; ++i) {
+        Column column(schema.get(), data_stream.GetColumnName(i), i);
+        schema->AppendColumn(std::move(column));
+        column_data.emplace_back(schema->GetColumn(i), std::move(column_value_ids[i]),
+                                 value_dictionaries[i].size());
+    }
+
+    schema->Init();
+
+    return std::make_unique<ColumnLayoutEncodedRelationData>(std::move(schema),
+                                                             std::move(column_data));
+}
+
+}  // namespace model
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "encoded_column_data.h"
+#include "idataset_stream.h"
+#include "relation_data.h"
+
+namespace model {
+
+using EncodedRelationData = AbstractRelationData<EncodedColumnData>;
+
+/* Dictionary-encoded relation stored column-major. Values are compared as strings, so empty
+ * values are equal to each other, just like any other value. */
+class ColumnLayoutEncodedRelationData final : public EncodedRelationData {
+public:
+    using EncodedRelationData::AbstractRelationData;
+
+    size_t GetNumRows() const final {
+        if (column_data_.empty()) {
+            return 0;
+        } else {
+            return column_data_.front().GetNumRows();
+        }
+    }
+
+    static std::unique_ptr<ColumnLayoutEncodedRelationData> CreateFrom(
+            model::IDatasetStream& data_stream);
+};
+
+}  // namespace model
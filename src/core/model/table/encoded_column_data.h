@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "abstract_column_data.h"
+#include "column.h"
+
+namespace model {
+
+/* Column with every value replaced by a dense id: equal values get equal ids and the ids of
+ * a column are 0, 1, ..., GetNumValues() - 1. Unlike hashes, the ids never conflate distinct
+ * values, and 32-bit ids keep comparisons narrow. */
+class EncodedColumnData final : public AbstractColumnData {
+public:
+    using ValueId = std::uint32_t;
+
+private:
+    std::vector<ValueId> value_ids_;
+    ValueId num_values_;
+
+public:
+    EncodedColumnData(Column const* column, std::vector<ValueId> value_ids,
+                      ValueId num_values) noexcept
+        : AbstractColumnData(column), value_ids_(std::move(value_ids)), num_values_(num_values) {}
+
+    std::vector<ValueId> const& GetValueIds() const noexcept {
+        return value_ids_;
+    }
+    ValueId GetValueId(size_t tuple_index) const noexcept {
+        return value_ids_[tuple_index];
+    }
+    ValueId GetNumValues() const noexcept {
+        return num_values_;
+    }
+    size_t GetNumRows() const noexcept {
+        return value_ids_.size();
+    }
+
+    std::string ToString() const final {
+        return "Encoded data for " + column_->ToString();
+    }
+};
+
+}  // namespace model
@@ -9,7 +9,6 @@
 #include <chrono>
 #include <cmath>
 #include <deque>
-#include <map>
 #include <memory>
 #include <utility>
 
@@ -23,7 +22,7 @@ namespace model {
 
 const int PositionListIndex::singleton_value_id_ = 0;
 unsigned long long PositionListIndex::micros_ = 0;
-int PositionListIndex::intersection_count_ = 0;
+std::atomic<int> PositionListIndex::intersection_count_ = 0;
 
 PositionListIndex::PositionListIndex(std::deque<std::vector<int>> index,
                                      std::vector<int> null_cluster, unsigned int size,
@@ -166,6 +165,8 @@ std::unique_ptr<PositionListIndex> PositionListIndex::Probe(std::shared_ptr<cons
     std::vector<int> null_cluster;
 
     std::unordered_map<int, std::vector<int>> partial_index;
+    // Probes may run on several threads, so the shared counter is updated once per call
+    int intersection_count = 0;
 
     for (auto& positions : index_) {
         for (int position : positions) {
@@ -180,7 +181,7 @@ std::unique_ptr<PositionListIndex> PositionListIndex::Probe(std::shared_ptr<cons
             int probing_table_value_id = (*probing_table)[position];
             if (probing_table_value_id == singleton_value_id_)
                 continue;
-            intersection_count_++;
+            intersection_count++;
             partial_index[probing_table_value_id].push_back(position);
         }
 
@@ -196,6 +197,7 @@ std::unique_ptr<PositionListIndex> PositionListIndex::Probe(std::shared_ptr<cons
         }
         partial_index.clear();
     }
+    intersection_count_ += intersection_count;
 
     double new_entropy = log(relation_size_) - new_key_gap / relation_size_;
     SortClusters(new_index);
@@ -209,58 +211,126 @@ std::unique_ptr<PositionListIndex> PositionListIndex::Probe(std::shared_ptr<cons
 std::unique_ptr<PositionListIndex> PositionListIndex::ProbeAll(
     Vertical const& probing_columns, ColumnLayoutRelationData& relation_data) {
     assert(this->relation_size_ == relation_data.GetNumRows());
-    std::deque<std::vector<int>> new_index;
-    unsigned int new_size = 0;
-    double new_key_gap = 0.0;
-    unsigned long long new_nep = 0;
-
-    std::map<std::vector<int>, std::vector<int>> partial_index;
-    std::vector<int> null_cluster;
-    std::vector<int> probe;
-
-    for (auto& cluster : this->index_) {
-        for (int position : cluster) {
-            if (!TakeProbe(position, relation_data, probing_columns, probe)) {
-                probe.clear();
-                continue;
-            }
+    std::vector<PositionListIndex const*> operands;
+    for (auto const* column : probing_columns.GetColumns()) {
+        operands.push_back(relation_data.GetColumnData(column->GetIndex()).GetPositionListIndex());
+    }
+    return ProbeAll(operands);
+}
 
-            partial_index[probe].push_back(position);
-            probe.clear();
+std::unique_ptr<PositionListIndex> PositionListIndex::ProbeAll(
+        std::vector<PositionListIndex const*> const& operands) const {
+    // probing tables computed for the operands that do not cache one
+    std::vector<std::shared_ptr<const std::vector<int>>> computed_probing_tables;
+    // probe keys are split into several 64-bit chunks when the operands do not fit into one
+    std::vector<std::vector<ProbeKeyPart>> key_chunks(1);
+    unsigned int used_bits = 0;
+    for (PositionListIndex const* operand : operands) {
+        assert(this->relation_size_ == operand->relation_size_);
+        std::vector<int> const* probing_table = operand->GetCachedProbingTable();
+        if (probing_table == nullptr) {
+            computed_probing_tables.push_back(operand->CalculateAndGetProbingTable());
+            probing_table = computed_probing_tables.back().get();
         }
-
-        for (auto& iter : partial_index) {
-            auto& new_cluster = iter.second;
-            if (new_cluster.size() == 1) continue;
-
-            new_size += new_cluster.size();
-            new_key_gap += new_cluster.size() * log(new_cluster.size());
-            new_nep += CalculateNep(new_cluster.size());
-
-            new_index.emplace_back(std::move(new_cluster));
+        // probing table values are cluster ids from 1 to the number of non-singleton clusters
+        unsigned int width = 1;
+        while ((operand->GetNumNonSingletonCluster() >> width) != 0) ++width;
+        if (used_bits + width > 64) {
+            key_chunks.emplace_back();
+            used_bits = 0;
         }
-        partial_index.clear();
+        key_chunks.back().push_back({probing_table, used_bits});
+        used_bits += width;
     }
 
+    std::deque<Cluster> new_index = RefineClusters(index_, key_chunks.front());
+    for (size_t i = 1; i < key_chunks.size(); ++i) {
+        new_index = RefineClusters(new_index, key_chunks[i]);
+    }
+
+    unsigned int new_size = 0;
+    double new_key_gap = 0.0;
+    unsigned long long new_nep = 0;
+    for (Cluster const& cluster : new_index) {
+        new_size += cluster.size();
+        new_key_gap += cluster.size() * log(cluster.size());
+        new_nep += CalculateNep(cluster.size());
+    }
     double new_entropy = log(this->relation_size_) - new_key_gap / this->relation_size_;
 
     SortClusters(new_index);
 
-    return std::make_unique<PositionListIndex>(std::move(new_index), std::move(null_cluster),
-                                               new_size, new_entropy, new_nep, this->relation_size_,
+    return std::make_unique<PositionListIndex>(std::move(new_index), Cluster(), new_size,
+                                               new_entropy, new_nep, this->relation_size_,
                                                this->relation_size_);
 }
 
-bool PositionListIndex::TakeProbe(int position, ColumnLayoutRelationData& relation_data,
-                                  Vertical const& probing_columns, std::vector<int>& probe) {
-    boost::dynamic_bitset<> probing_indices = probing_columns.GetColumnIndices();
-    for (unsigned long index = probing_indices.find_first(); index < probing_indices.size();
-         index = probing_indices.find_next(index)) {
-        int value = relation_data.GetColumnData(index).GetProbingTableValue(position);
-        if (value == PositionListIndex::singleton_value_id_) return false;
-        probe.push_back(value);
+std::deque<PositionListIndex::Cluster> PositionListIndex::RefineClusters(
+        std::deque<Cluster> const& clusters, std::vector<ProbeKeyPart> const& key_parts) {
+    constexpr int kNoGroup = -1;
+    std::deque<Cluster> refined_clusters;
+    // open addressing hash table from probe keys to groups, reused by all clusters
+    std::vector<unsigned long long> slot_keys;
+    std::vector<int> slot_groups;
+    std::vector<int> position_groups;
+    std::vector<unsigned int> group_sizes;
+    std::vector<int> group_clusters;
+
+    for (Cluster const& cluster : clusters) {
+        size_t capacity = 1;
+        while (capacity < 2 * cluster.size()) capacity <<= 1;
+        size_t const slot_mask = capacity - 1;
+        slot_keys.resize(capacity);
+        slot_groups.assign(capacity, kNoGroup);
+        position_groups.resize(cluster.size());
+        group_sizes.clear();
+
+        for (size_t i = 0; i < cluster.size(); ++i) {
+            int const position = cluster[i];
+            unsigned long long key = 0;
+            bool is_singleton = false;
+            for (ProbeKeyPart const& part : key_parts) {
+                int const value = (*part.probing_table)[position];
+                if (value == singleton_value_id_) {
+                    is_singleton = true;
+                    break;
+                }
+                key |= static_cast<unsigned long long>(value) << part.shift;
+            }
+            if (is_singleton) {
+                position_groups[i] = kNoGroup;
+                continue;
+            }
+
+            unsigned long long hash = key * 0x9E3779B97F4A7C15ULL;
+            size_t slot = (hash ^ (hash >> 32)) & slot_mask;
+            while (slot_groups[slot] != kNoGroup && slot_keys[slot] != key) {
+                slot = (slot + 1) & slot_mask;
+            }
+            if (slot_groups[slot] == kNoGroup) {
+                slot_groups[slot] = group_sizes.size();
+                slot_keys[slot] = key;
+                group_sizes.push_back(0);
+            }
+            position_groups[i] = slot_groups[slot];
+            ++group_sizes[slot_groups[slot]];
+        }
+
+        group_clusters.assign(group_sizes.size(), kNoGroup);
+        for (size_t group = 0; group < group_sizes.size(); ++group) {
+            if (group_sizes[group] < 2) continue;
+            group_clusters[group] = refined_clusters.size();
+            refined_clusters.emplace_back().reserve(group_sizes[group]);
+        }
+        for (size_t i = 0; i < cluster.size(); ++i) {
+            if (position_groups[i] == kNoGroup) continue;
+            int const refined_cluster = group_clusters[position_groups[i]];
+            if (refined_cluster != kNoGroup) {
+                refined_clusters[refined_cluster].push_back(cluster[i]);
+            }
+        }
     }
-    return true;
+    return refined_clusters;
 }
 
 std::string PositionListIndex::ToString() const {
@@ -4,6 +4,7 @@
 //
 
 #pragma once
+#include <atomic>
 #include <deque>
 #include <memory>
 #include <unordered_map>
@@ -31,17 +32,24 @@ private:
     unsigned int relation_size_;
     unsigned int original_relation_size_;
     std::shared_ptr<const std::vector<int>> probing_table_cache_;
-    unsigned int freq_ = 0;
+    std::atomic<unsigned int> freq_ = 0;
 
     static unsigned long long CalculateNep(unsigned int num_elements) {
         return static_cast<unsigned long long>(num_elements) * (num_elements - 1) / 2;
     }
     static void SortClusters(std::deque<Cluster>& clusters);
-    static bool TakeProbe(int position, ColumnLayoutRelationData& relation_data,
-                          Vertical const& probing_columns, std::vector<int>& probe);
+    // A probing table whose values are shifted into their own bits of a packed probe key
+    struct ProbeKeyPart {
+        std::vector<int> const* probing_table;
+        unsigned int shift;
+    };
+    // Splits every cluster into the groups of positions that have equal packed probe keys,
+    // dropping the positions that are singletons in some probing table
+    static std::deque<Cluster> RefineClusters(std::deque<Cluster> const& clusters,
+                                              std::vector<ProbeKeyPart> const& key_parts);
 
 public:
-    static int intersection_count_;
+    static std::atomic<int> intersection_count_;
     static unsigned long long micros_;
     static const int singleton_value_id_;
 
@@ -125,7 +133,7 @@ public:
     }
 
     void IncFreq() {
-        freq_++;
+        freq_.fetch_add(1, std::memory_order_relaxed);
     }
 
     std::unique_ptr<PositionListIndex> Intersect(PositionListIndex const* that) const;
@@ -133,6 +141,9 @@ public:
             std::shared_ptr<const std::vector<int>> probing_table) const;
     std::unique_ptr<PositionListIndex> ProbeAll(Vertical const& probing_columns,
                                                 ColumnLayoutRelationData& relation_data);
+    // Intersects this PLI with all the given ones in a single pass over its clusters
+    std::unique_ptr<PositionListIndex> ProbeAll(
+            std::vector<PositionListIndex const*> const& operands) const;
     std::string ToString() const;
 };
 
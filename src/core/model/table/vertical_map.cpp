@@ -494,6 +494,13 @@ std::shared_ptr<Value> VerticalMap<Value>::Put(Vertical const& key, std::shared_
     return old_value;
 }
 
+template <class Value>
+bool VerticalMap<Value>::PutIfAbsent(Vertical const& key, std::shared_ptr<Value> value) {
+    if (set_trie_.Get(key.GetColumnIndices(), 0) != nullptr) return false;
+    VerticalMap<Value>::Put(key, std::move(value));
+    return true;
+}
+
 template <class Value>
 std::shared_ptr<Value const> VerticalMap<Value>::Get(Vertical const& key) const {
     return set_trie_.Get(key.GetColumnIndices(), 0);
@@ -559,6 +566,12 @@ std::shared_ptr<V> BlockingVerticalMap<V>::Put(const Vertical& key, std::shared_
     return VerticalMap<V>::Put(key, value);
 }
 
+template <class V>
+bool BlockingVerticalMap<V>::PutIfAbsent(const Vertical& key, std::shared_ptr<V> value) {
+    std::scoped_lock write_lock(read_write_mutex_);
+    return VerticalMap<V>::PutIfAbsent(key, value);
+}
+
 template <class V>
 std::shared_ptr<V> BlockingVerticalMap<V>::Remove(const Vertical& key) {
     std::scoped_lock write_lock(read_write_mutex_);
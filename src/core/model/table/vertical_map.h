@@ -106,6 +106,8 @@ public:
     virtual std::shared_ptr<Value const> Get(Bitset const& key) const;
     virtual bool ContainsKey(Vertical const& key) const { return Get(key) != nullptr; }
     virtual std::shared_ptr<Value> Put(Vertical const& key, std::shared_ptr<Value> value);
+    // Puts the value only if there is no entry with the given key, returns whether it was put
+    virtual bool PutIfAbsent(Vertical const& key, std::shared_ptr<Value> value);
     virtual std::shared_ptr<Value> Remove(Vertical const& key);
     virtual std::shared_ptr<Value> Remove(Bitset const& key);
 
@@ -169,6 +171,7 @@ public:
     virtual std::shared_ptr<V const> Get(Bitset const& key) const override;
     virtual bool ContainsKey(Vertical const& key) const override;
     virtual std::shared_ptr<V> Put(Vertical const& key, std::shared_ptr<V> value) override;
+    virtual bool PutIfAbsent(Vertical const& key, std::shared_ptr<V> value) override;
     virtual std::shared_ptr<V> Remove(Vertical const& key) override;
     virtual std::shared_ptr<V> Remove(Bitset const& key) override;
 
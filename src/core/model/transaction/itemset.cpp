@@ -1,11 +0,0 @@
-#include "itemset.h"
-
-#include <algorithm>
-
-namespace model {
-
-void Itemset::Sort() {
-    std::sort(indices_.begin(), indices_.end());
-}
-
-} // namespace model
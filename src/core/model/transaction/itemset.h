@@ -1,19 +1,22 @@
 #pragma once
 
-#include <vector>
+#include <cstddef>
 
 namespace model {
 
+// Ids of the items of a transaction in ascending order, a view into TransactionalData
 class Itemset {
 private:
-    std::vector<unsigned> indices_;
+    unsigned const* begin_;
+    unsigned const* end_;
 
 public:
-    std::vector<unsigned> const& GetItemsIDs() const noexcept { return indices_; }
-    void AddItemId(unsigned item_id) { indices_.push_back(item_id); }
-    void Sort();
+    Itemset(unsigned const* begin, unsigned const* end) noexcept : begin_(begin), end_(end) {}
 
-    // TODO(alexandrsmirn) реализовать конструктор от одного айдишника
+    unsigned const* begin() const noexcept { return begin_; }
+    unsigned const* end() const noexcept { return end_; }
+    size_t size() const noexcept { return end_ - begin_; }
+    bool empty() const noexcept { return begin_ == end_; }
 };
 
 } // namespace model
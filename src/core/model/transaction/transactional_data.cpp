@@ -1,18 +1,60 @@
 #include "transactional_data.h"
 
+#include <algorithm>
 #include <cassert>
+#include <numeric>
 #include <stdexcept>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace model {
 
+namespace {
+
+// Sorts the items of every transaction and reorders the transactions by their tids
+void SortTransactions(std::vector<size_t>& tids, std::vector<size_t>& offsets,
+                      std::vector<unsigned>& items) {
+    for (size_t index = 0; index != tids.size(); ++index) {
+        std::sort(items.begin() + offsets[index], items.begin() + offsets[index + 1]);
+    }
+    if (std::is_sorted(tids.begin(), tids.end())) {
+        return;
+    }
+
+    std::vector<size_t> order(tids.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&tids](size_t left, size_t right) { return tids[left] < tids[right]; });
+    std::vector<size_t> sorted_tids;
+    sorted_tids.reserve(tids.size());
+    std::vector<size_t> sorted_offsets{0};
+    sorted_offsets.reserve(offsets.size());
+    std::vector<unsigned> sorted_items;
+    sorted_items.reserve(items.size());
+    for (size_t index : order) {
+        sorted_tids.push_back(tids[index]);
+        sorted_items.insert(sorted_items.end(), items.begin() + offsets[index],
+                            items.begin() + offsets[index + 1]);
+        sorted_offsets.push_back(sorted_items.size());
+    }
+    tids = std::move(sorted_tids);
+    offsets = std::move(sorted_offsets);
+    items = std::move(sorted_items);
+}
+
+}  // namespace
+
 std::unique_ptr<TransactionalData> TransactionalData::CreateFromSingular(
         IDatasetStream& data_stream,
         size_t tid_col_index,
         size_t item_col_index) {
     std::vector<std::string> item_universe;
     std::unordered_map<std::string, size_t> item_universe_set;
-    std::unordered_map<size_t, Itemset> transactions;
+    // Index of every transaction in the order of the first appearance of its tid
+    std::unordered_map<size_t, size_t> tid_indices;
+    std::vector<size_t> tids;
+    // Pairs of a transaction index and an item id, in the order of the rows
+    std::vector<std::pair<size_t, unsigned>> occurrences;
     size_t latest_item_id = 0;
 
     assert(data_stream.GetNumberOfColumns() > std::max(tid_col_index, item_col_index));
@@ -37,23 +79,38 @@ std::unique_ptr<TransactionalData> TransactionalData::CreateFromSingular(
             item_id = item_iter->second;
         }
 
-        transactions[tid].AddItemId(item_id);
+        auto const [tid_iter, is_new_tid] = tid_indices.try_emplace(tid, tids.size());
+        if (is_new_tid) {
+            tids.push_back(tid);
+        }
+        occurrences.emplace_back(tid_iter->second, item_id);
     }
 
-    // sort items in each transaction
-    for (auto& [tid, items] : transactions) {
-        items.Sort();
+    // group the items by transaction with a counting sort
+    std::vector<size_t> offsets(tids.size() + 1, 0);
+    for (auto const& [index, item_id] : occurrences) {
+        ++offsets[index + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<size_t> next_positions(offsets.begin(), std::prev(offsets.end()));
+    std::vector<unsigned> items(occurrences.size());
+    for (auto const& [index, item_id] : occurrences) {
+        items[next_positions[index]++] = item_id;
     }
 
-    return std::unique_ptr<TransactionalData>(new TransactionalData(std::move(item_universe),
-                                                                    std::move(transactions)));
+    SortTransactions(tids, offsets, items);
+    return std::unique_ptr<TransactionalData>(new TransactionalData(
+            std::move(item_universe), std::move(tids), std::move(offsets), std::move(items)));
 }
 
 std::unique_ptr<TransactionalData> TransactionalData::CreateFromTabular(IDatasetStream& data_stream,
                                                                         bool has_tid) {
     std::vector<std::string> item_universe;
     std::unordered_map<std::string, size_t> item_universe_set;
-    std::unordered_map<size_t, Itemset> transactions;
+    std::unordered_set<size_t> seen_tids;
+    std::vector<size_t> tids;
+    std::vector<size_t> offsets{0};
+    std::vector<unsigned> items;
     size_t latest_item_id = 0;
     size_t tid = 0;
 
@@ -69,7 +126,6 @@ std::unique_ptr<TransactionalData> TransactionalData::CreateFromTabular(IDataset
             row_iter++;
         }
 
-        Itemset items;
         for (; row_iter != row.end(); ++row_iter) {
             std::string& item_name = *row_iter;
             if (item_name.empty()) {
@@ -87,18 +143,24 @@ std::unique_ptr<TransactionalData> TransactionalData::CreateFromTabular(IDataset
                 // if this item already exists in the universe, set the old item id
                 item_id = item_iter->second;
             }
-            items.AddItemId(item_id);
+            items.push_back(item_id);
         }
 
-        items.Sort();
-        transactions.emplace(tid, std::move(items));
+        // only the first of the transactions with the same tid is kept
+        if (has_tid && !seen_tids.insert(tid).second) {
+            items.resize(offsets.back());
+            continue;
+        }
+        tids.push_back(tid);
+        offsets.push_back(items.size());
         if (!has_tid) {
             ++tid;
         }
     }
 
-    return std::unique_ptr<TransactionalData>(new TransactionalData(std::move(item_universe),
-                                                                    std::move(transactions)));
+    SortTransactions(tids, offsets, items);
+    return std::unique_ptr<TransactionalData>(new TransactionalData(
+            std::move(item_universe), std::move(tids), std::move(offsets), std::move(items)));
 }
 
 }  // namespace model
@@ -2,7 +2,6 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "itemset.h"
@@ -14,11 +13,18 @@ namespace model {
 class TransactionalData {
 private:
     std::vector<std::string> item_universe_;
-    std::unordered_map<size_t, Itemset> transactions_;
-
-    TransactionalData(std::vector<std::string> item_universe,
-                      std::unordered_map<size_t, Itemset> transactions)
-        : item_universe_(std::move(item_universe)), transactions_(std::move(transactions)) {}
+    // Transactions in ascending order of their tids. Items of all transactions are stored one
+    // after another, the items of the i-th transaction are [offsets_[i], offsets_[i + 1]).
+    std::vector<size_t> tids_;
+    std::vector<size_t> offsets_;
+    std::vector<unsigned> items_;
+
+    TransactionalData(std::vector<std::string> item_universe, std::vector<size_t> tids,
+                      std::vector<size_t> offsets, std::vector<unsigned> items)
+        : item_universe_(std::move(item_universe)),
+          tids_(std::move(tids)),
+          offsets_(std::move(offsets)),
+          items_(std::move(items)) {}
 
 public:
     TransactionalData() = delete;
@@ -30,12 +36,13 @@ public:
     TransactionalData& operator=(TransactionalData&& other) = default;
 
     std::vector<std::string> const& GetItemUniverse() const noexcept { return item_universe_; }
-    std::unordered_map<size_t, Itemset> const& GetTransactions() const noexcept {
-        return transactions_;
+    std::vector<size_t> const& GetTIds() const noexcept { return tids_; }
+    Itemset GetTransaction(size_t index) const noexcept {
+        return {items_.data() + offsets_[index], items_.data() + offsets_[index + 1]};
     }
 
     size_t GetUniverseSize() const noexcept { return item_universe_.size(); }
-    size_t GetNumTransactions() const noexcept { return transactions_.size(); }
+    size_t GetNumTransactions() const noexcept { return tids_.size(); }
 
     static std::unique_ptr<TransactionalData> CreateFromSingular(IDatasetStream& data_stream,
                                                                  size_t tid_col_index = 0,
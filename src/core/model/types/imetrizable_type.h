@@ -9,6 +9,12 @@ public:
     using Type::Type;
 
     virtual double Dist(std::byte const* l, std::byte const* r) const = 0;
+
+    /* Checks whether the distance between l and r is less than bound, types with a cheaper way to
+     * answer this than computing the whole distance override it */
+    virtual bool IsDistLess(std::byte const* l, std::byte const* r, double bound) const {
+        return Dist(l, r) < bound;
+    }
 };
 
 }  // namespace model
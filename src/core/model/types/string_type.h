@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cmath>
+#include <limits>
+
 #include "imetrizable_type.h"
 #include "type.h"
 #include "util/levenshtein_distance.h"
@@ -86,6 +89,20 @@ public:
         return util::LevenshteinDistance(GetValue<String>(l), GetValue<String>(r));
     }
 
+    /* Stops computing Levenshtein distance as soon as it cannot be less than bound */
+    bool IsDistLess(std::byte const* l, std::byte const* r, double bound) const override {
+        if (bound <= 0) {
+            return false;
+        }
+        // Distance is whole, so it is less than bound iff it is less than the rounded up bound
+        double const whole_bound = std::ceil(bound);
+        if (whole_bound > std::numeric_limits<unsigned>::max()) {
+            return true;
+        }
+        return util::LevenshteinDistanceIsLess(GetValue<String>(l), GetValue<String>(r),
+                                               static_cast<unsigned>(whole_bound));
+    }
+
     static void Destruct(std::byte const* v) {
         reinterpret_cast<String const*>(v)->~String();
     }
@@ -0,0 +1,222 @@
+#include "bitset_trie.h"
+
+#include <cassert>
+
+namespace util {
+
+BitsetTrie::NodeIndex BitsetTrie::FindChild(NodeIndex parent, NodeIndex bit) const {
+    NodeIndex child = nodes_[parent].first_child;
+    while (child != kNoNode && nodes_[child].bit < bit) {
+        child = nodes_[child].next_sibling;
+    }
+    return child != kNoNode && nodes_[child].bit == bit ? child : kNoNode;
+}
+
+BitsetTrie::NodeIndex BitsetTrie::FindOrCreateChild(NodeIndex parent, NodeIndex bit) {
+    NodeIndex prev = kNoNode;
+    NodeIndex child = nodes_[parent].first_child;
+    while (child != kNoNode && nodes_[child].bit < bit) {
+        prev = child;
+        child = nodes_[child].next_sibling;
+    }
+    if (child != kNoNode && nodes_[child].bit == bit) {
+        return child;
+    }
+
+    assert(nodes_.size() < kNoNode);
+    NodeIndex const created = static_cast<NodeIndex>(nodes_.size());
+    nodes_.emplace_back(bit);
+    nodes_[created].next_sibling = child;
+    if (prev == kNoNode) {
+        nodes_[parent].first_child = created;
+    } else {
+        nodes_[prev].next_sibling = created;
+    }
+    return created;
+}
+
+bool BitsetTrie::Insert(Bitset const& set) {
+    assert(set.size() == dimension_);
+    NodeIndex node = kRoot;
+    for (size_t bit = set.find_first(); bit != Bitset::npos; bit = set.find_next(bit)) {
+        node = FindOrCreateChild(node, static_cast<NodeIndex>(bit));
+    }
+    if (nodes_[node].terminal) {
+        return false;
+    }
+    nodes_[node].terminal = true;
+
+    // The path exists now, so the second walk does not modify the structure
+    node = kRoot;
+    ++nodes_[node].sets_in_subtree;
+    for (size_t bit = set.find_first(); bit != Bitset::npos; bit = set.find_next(bit)) {
+        node = FindChild(node, static_cast<NodeIndex>(bit));
+        ++nodes_[node].sets_in_subtree;
+    }
+    return true;
+}
+
+bool BitsetTrie::Erase(Bitset const& set) {
+    if (!Contains(set)) {
+        return false;
+    }
+    NodeIndex node = kRoot;
+    --nodes_[node].sets_in_subtree;
+    for (size_t bit = set.find_first(); bit != Bitset::npos; bit = set.find_next(bit)) {
+        node = FindChild(node, static_cast<NodeIndex>(bit));
+        --nodes_[node].sets_in_subtree;
+    }
+    nodes_[node].terminal = false;
+    return true;
+}
+
+bool BitsetTrie::Contains(Bitset const& set) const {
+    NodeIndex node = kRoot;
+    for (size_t bit = set.find_first(); bit != Bitset::npos; bit = set.find_next(bit)) {
+        node = FindChild(node, static_cast<NodeIndex>(bit));
+        if (node == kNoNode || nodes_[node].sets_in_subtree == 0) {
+            return false;
+        }
+    }
+    return nodes_[node].terminal;
+}
+
+bool BitsetTrie::ContainsSubsetOf(NodeIndex node, Bitset const& set) const {
+    if (nodes_[node].terminal) {
+        return true;
+    }
+    for (NodeIndex child = nodes_[node].first_child; child != kNoNode;
+         child = nodes_[child].next_sibling) {
+        Node const& child_node = nodes_[child];
+        if (child_node.bit >= set.size()) {
+            break;
+        }
+        if (child_node.sets_in_subtree != 0 && set.test(child_node.bit) &&
+            ContainsSubsetOf(child, set)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BitsetTrie::ContainsSubsetOf(Bitset const& set) const {
+    return !IsEmpty() && ContainsSubsetOf(kRoot, set);
+}
+
+bool BitsetTrie::ContainsSupersetOf(NodeIndex node, Bitset const& set, size_t next_bit) const {
+    if (next_bit == Bitset::npos) {
+        return nodes_[node].sets_in_subtree != 0;
+    }
+    for (NodeIndex child = nodes_[node].first_child; child != kNoNode;
+         child = nodes_[child].next_sibling) {
+        Node const& child_node = nodes_[child];
+        if (child_node.bit > next_bit) {
+            break;
+        }
+        if (child_node.sets_in_subtree == 0) {
+            continue;
+        }
+        size_t const child_next_bit =
+                child_node.bit == next_bit ? set.find_next(next_bit) : next_bit;
+        if (ContainsSupersetOf(child, set, child_next_bit)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BitsetTrie::ContainsSupersetOf(Bitset const& set) const {
+    return ContainsSupersetOf(kRoot, set, set.find_first());
+}
+
+BitsetTrie::NodeIndex BitsetTrie::EraseSubsetsOf(NodeIndex node, Bitset const& set) {
+    NodeIndex erased = 0;
+    if (nodes_[node].terminal) {
+        nodes_[node].terminal = false;
+        erased = 1;
+    }
+    for (NodeIndex child = nodes_[node].first_child; child != kNoNode;
+         child = nodes_[child].next_sibling) {
+        if (nodes_[child].bit >= set.size()) {
+            break;
+        }
+        if (nodes_[child].sets_in_subtree != 0 && set.test(nodes_[child].bit)) {
+            erased += EraseSubsetsOf(child, set);
+        }
+    }
+    nodes_[node].sets_in_subtree -= erased;
+    return erased;
+}
+
+size_t BitsetTrie::EraseSubsetsOf(Bitset const& set) {
+    return IsEmpty() ? 0 : EraseSubsetsOf(kRoot, set);
+}
+
+BitsetTrie::NodeIndex BitsetTrie::EraseSubtree(NodeIndex node) {
+    NodeIndex const erased = nodes_[node].sets_in_subtree;
+    nodes_[node].terminal = false;
+    nodes_[node].sets_in_subtree = 0;
+    for (NodeIndex child = nodes_[node].first_child; child != kNoNode;
+         child = nodes_[child].next_sibling) {
+        if (nodes_[child].sets_in_subtree != 0) {
+            EraseSubtree(child);
+        }
+    }
+    return erased;
+}
+
+BitsetTrie::NodeIndex BitsetTrie::EraseSupersetsOf(NodeIndex node, Bitset const& set,
+                                                    size_t next_bit) {
+    if (next_bit == Bitset::npos) {
+        return EraseSubtree(node);
+    }
+    NodeIndex erased = 0;
+    for (NodeIndex child = nodes_[node].first_child; child != kNoNode;
+         child = nodes_[child].next_sibling) {
+        if (nodes_[child].bit > next_bit) {
+            break;
+        }
+        if (nodes_[child].sets_in_subtree == 0) {
+            continue;
+        }
+        size_t const child_next_bit =
+                nodes_[child].bit == next_bit ? set.find_next(next_bit) : next_bit;
+        erased += EraseSupersetsOf(child, set, child_next_bit);
+    }
+    nodes_[node].sets_in_subtree -= erased;
+    return erased;
+}
+
+size_t BitsetTrie::EraseSupersetsOf(Bitset const& set) {
+    return IsEmpty() ? 0 : EraseSupersetsOf(kRoot, set, set.find_first());
+}
+
+void BitsetTrie::ForEach(NodeIndex node, Bitset& path,
+                         std::function<void(Bitset const&)> const& action) const {
+    if (nodes_[node].terminal) {
+        action(path);
+    }
+    for (NodeIndex child = nodes_[node].first_child; child != kNoNode;
+         child = nodes_[child].next_sibling) {
+        if (nodes_[child].sets_in_subtree == 0) {
+            continue;
+        }
+        path.set(nodes_[child].bit);
+        ForEach(child, path, action);
+        path.reset(nodes_[child].bit);
+    }
+}
+
+void BitsetTrie::ForEach(std::function<void(Bitset const&)> const& action) const {
+    Bitset path(dimension_);
+    if (!IsEmpty()) {
+        ForEach(kRoot, path, action);
+    }
+}
+
+void BitsetTrie::Clear() {
+    nodes_.clear();
+    nodes_.emplace_back(kNoNode);
+}
+
+}  // namespace util
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace util {
+
+/* Set-trie storing a family of subsets of {0, ..., dimension - 1}. A set is stored as the path of
+ * its set bits in ascending order. All nodes live in one vector and are linked by 32-bit indices
+ * (first child / next sibling, siblings sorted by bit), so inserting a set allocates at most once
+ * and queries never chase heap pointers. Every node counts the sets stored in its subtree, which
+ * lets subset/superset queries skip branches that only contain erased sets.
+ */
+class BitsetTrie {
+public:
+    using Bitset = boost::dynamic_bitset<>;
+    using NodeIndex = std::uint32_t;
+
+private:
+    static constexpr NodeIndex kNoNode = static_cast<NodeIndex>(-1);
+    static constexpr NodeIndex kRoot = 0;
+
+    struct Node {
+        NodeIndex bit;
+        NodeIndex first_child = kNoNode;
+        NodeIndex next_sibling = kNoNode;
+        NodeIndex sets_in_subtree = 0;
+        bool terminal = false;
+
+        explicit Node(NodeIndex bit) : bit(bit) {}
+    };
+
+    size_t dimension_;
+    std::vector<Node> nodes_;
+
+    NodeIndex FindChild(NodeIndex parent, NodeIndex bit) const;
+    NodeIndex FindOrCreateChild(NodeIndex parent, NodeIndex bit);
+
+    bool ContainsSubsetOf(NodeIndex node, Bitset const& set) const;
+    // next_bit is the smallest bit of the set that is not on the path to node yet
+    bool ContainsSupersetOf(NodeIndex node, Bitset const& set, size_t next_bit) const;
+    NodeIndex EraseSubsetsOf(NodeIndex node, Bitset const& set);
+    NodeIndex EraseSupersetsOf(NodeIndex node, Bitset const& set, size_t next_bit);
+    NodeIndex EraseSubtree(NodeIndex node);
+    void ForEach(NodeIndex node, Bitset& path,
+                 std::function<void(Bitset const&)> const& action) const;
+
+public:
+    explicit BitsetTrie(size_t dimension = 0) : dimension_(dimension), nodes_{Node(kNoNode)} {}
+
+    size_t GetDimension() const noexcept {
+        return dimension_;
+    }
+    size_t Size() const noexcept {
+        return nodes_[kRoot].sets_in_subtree;
+    }
+    bool IsEmpty() const noexcept {
+        return Size() == 0;
+    }
+
+    // Returns false if the set is already stored
+    bool Insert(Bitset const& set);
+    // Returns false if the set is not stored
+    bool Erase(Bitset const& set);
+    bool Contains(Bitset const& set) const;
+
+    // Checks whether some stored set is a subset (superset) of the given one
+    bool ContainsSubsetOf(Bitset const& set) const;
+    bool ContainsSupersetOf(Bitset const& set) const;
+
+    // Erase all stored sets that are subsets (supersets) of the given one, return their number
+    size_t EraseSubsetsOf(Bitset const& set);
+    size_t EraseSupersetsOf(Bitset const& set);
+
+    void ForEach(std::function<void(Bitset const&)> const& action) const;
+    void Clear();
+};
+
+}  // namespace util
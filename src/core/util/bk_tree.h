@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+/* Burkhard-Keller tree over values with a metric that takes whole values, e.g. the Levenshtein
+ * distance. Every child of a node is labelled with its distance to the node, and all values in
+ * the subtree of the child are at that distance from the node. By the triangle inequality a value
+ * at distance d from the node is at most d + label away from everything in the subtree, so far
+ * queries skip the subtrees that are too close to contain an answer. Equal values are stored once.
+ */
+template <typename T>
+class BKTree {
+public:
+    using DistanceFunction = std::function<unsigned(T const&, T const&)>;
+
+private:
+    struct Node {
+        T value;
+        // Labels and indices of the children
+        std::vector<std::pair<unsigned, size_t>> children;
+
+        explicit Node(T value) : value(std::move(value)) {}
+    };
+
+    std::vector<Node> nodes_;
+    DistanceFunction dist_;
+
+public:
+    explicit BKTree(DistanceFunction dist) : dist_(std::move(dist)) {}
+
+    // Returns false if an equal value is stored already
+    bool Insert(T value) {
+        if (nodes_.empty()) {
+            nodes_.emplace_back(std::move(value));
+            return true;
+        }
+        size_t node = 0;
+        while (true) {
+            unsigned const distance = dist_(value, nodes_[node].value);
+            if (distance == 0) {
+                return false;
+            }
+            auto& children = nodes_[node].children;
+            auto child = std::find_if(children.begin(), children.end(),
+                                      [distance](auto const& c) { return c.first == distance; });
+            if (child == children.end()) {
+                children.emplace_back(distance, nodes_.size());
+                nodes_.emplace_back(std::move(value));
+                return true;
+            }
+            node = child->second;
+        }
+    }
+
+    // Checks whether some stored value is farther than radius from the given one
+    bool HasFartherThan(T const& value, unsigned radius) const {
+        if (nodes_.empty()) {
+            return false;
+        }
+        std::vector<size_t> to_visit{0};
+        while (!to_visit.empty()) {
+            Node const& node = nodes_[to_visit.back()];
+            to_visit.pop_back();
+            unsigned const distance = dist_(value, node.value);
+            if (distance > radius) {
+                return true;
+            }
+            for (auto const& [label, child] : node.children) {
+                if (distance + label > radius) {
+                    to_visit.push_back(child);
+                }
+            }
+        }
+        return false;
+    }
+
+    size_t Size() const noexcept {
+        return nodes_.size();
+    }
+};
+
+}  // namespace util
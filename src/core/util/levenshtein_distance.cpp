@@ -1,44 +1,164 @@
 #include "levenshtein_distance.h"
 
 #include <algorithm>
-#include <cassert>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
 #include <vector>
 
 namespace util {
 
-/* Levenshtein distance computation algorithm taken from
- * https://en.wikipedia.org/wiki/Levenshtein_distance
+namespace {
+
+using Word = std::uint64_t;
+constexpr size_t kWordSize = 64;
+constexpr size_t kAlphabetSize = 256;
+constexpr Word kHighBit = Word{1} << (kWordSize - 1);
+
+size_t CharIndex(char c) {
+    return static_cast<unsigned char>(c);
+}
+
+/* Myers' algorithm, https://doi.org/10.1145/316542.316550, for a pattern of at most 64
+ * characters. Bit i of pv (mv) is set when D[i + 1][j] - D[i][j] = +1 (-1) for the current column
+ * j of the matrix, score is D[m][j]. Returns the distance if it is less than bound and a lower
+ * bound of it that is not less than bound otherwise.
  */
-unsigned LevenshteinDistance(std::string_view l, std::string_view r) {
-    size_t r_size = r.size();
-    std::vector<unsigned> v0(r_size + 1);
-    std::vector<unsigned> v1(r_size + 1);
-
-    for (unsigned i = 0; i != r_size + 1; ++i) {
-        v0[i] = i;
-    }
-
-    for (unsigned i = 0; i != l.size(); ++i) {
-        v1[0] = i + 1;
-
-        for (unsigned j = 0; j != r.size(); ++j) {
-            assert(j + 1 < v0.size());
-            unsigned del_cost = v0[j + 1] + 1;
-            unsigned insert_cost = v1[j] + 1;
-            unsigned substition_cost;
-            if (l[i] == r[j]) {
-                substition_cost = v0[j];
-            } else {
-                substition_cost = v0[j] + 1;
+unsigned SingleWordDistance(std::string_view pattern, std::string_view text, unsigned bound) {
+    std::array<Word, kAlphabetSize> peq{};
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        peq[CharIndex(pattern[i])] |= Word{1} << i;
+    }
+
+    Word pv = ~Word{0};
+    Word mv = 0;
+    Word const last = Word{1} << (pattern.size() - 1);
+    size_t score = pattern.size();
+    size_t remaining = text.size();
+    for (char c : text) {
+        Word const eq = peq[CharIndex(c)];
+        Word const xv = eq | mv;
+        Word const xh = (((eq & pv) + pv) ^ pv) | eq;
+        Word ph = mv | ~(xh | pv);
+        Word mh = pv & xh;
+        if (ph & last) {
+            ++score;
+        } else if (mh & last) {
+            --score;
+        }
+        // D[0][j] = j, so the first row grows by one in every column
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // Every remaining column lowers the score by one at most
+        --remaining;
+        if (score >= bound + remaining) {
+            return score - remaining;
+        }
+    }
+    return score;
+}
+
+/* Myers' algorithm with the column split into 64-bit blocks as described by Hyyrö,
+ * https://doi.org/10.1145/1005813.1041517. The horizontal delta at the bottom of a block is
+ * passed to the next one.
+ */
+unsigned BlockedDistance(std::string_view pattern, std::string_view text, unsigned bound) {
+    size_t const blocks = (pattern.size() + kWordSize - 1) / kWordSize;
+    // Kept between the calls of a thread so that long values do not allocate every time
+    thread_local std::vector<Word> peq;
+    thread_local std::vector<Word> pv;
+    thread_local std::vector<Word> mv;
+    peq.assign(kAlphabetSize * blocks, 0);
+    pv.assign(blocks, ~Word{0});
+    mv.assign(blocks, 0);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        peq[CharIndex(pattern[i]) * blocks + i / kWordSize] |= Word{1} << (i % kWordSize);
+    }
+
+    Word const last = Word{1} << ((pattern.size() - 1) % kWordSize);
+    size_t score = pattern.size();
+    size_t remaining = text.size();
+    for (char c : text) {
+        Word const* block_eq = &peq[CharIndex(c) * blocks];
+        // Horizontal delta at the top of the block
+        int hin = 1;
+        for (size_t k = 0; k < blocks; ++k) {
+            Word eq = block_eq[k];
+            Word const xv = eq | mv[k];
+            if (hin < 0) {
+                eq |= 1;
+            }
+            Word const xh = (((eq & pv[k]) + pv[k]) ^ pv[k]) | eq;
+            Word ph = mv[k] | ~(xh | pv[k]);
+            Word mh = pv[k] & xh;
+            Word const high = k + 1 == blocks ? last : kHighBit;
+            int const hout = (ph & high) ? 1 : ((mh & high) ? -1 : 0);
+            ph <<= 1;
+            mh <<= 1;
+            if (hin < 0) {
+                mh |= 1;
+            } else if (hin > 0) {
+                ph |= 1;
             }
+            pv[k] = mh | ~(xv | ph);
+            mv[k] = ph & xv;
+            hin = hout;
+        }
+        if (hin > 0) {
+            ++score;
+        } else if (hin < 0) {
+            --score;
+        }
 
-            v1[j + 1] = std::min({del_cost, insert_cost, substition_cost});
+        --remaining;
+        if (score >= bound + remaining) {
+            return score - remaining;
         }
+    }
+    return score;
+}
 
-        std::swap(v0, v1);
+unsigned BoundedDistance(std::string_view l, std::string_view r, unsigned bound) {
+    // Common prefix and suffix do not change the distance
+    size_t const prefix = std::mismatch(l.begin(), l.end(), r.begin(), r.end()).first - l.begin();
+    l.remove_prefix(prefix);
+    r.remove_prefix(prefix);
+    size_t const suffix =
+            std::mismatch(l.rbegin(), l.rend(), r.rbegin(), r.rend()).first - l.rbegin();
+    l.remove_suffix(suffix);
+    r.remove_suffix(suffix);
+
+    // The shorter string is the pattern, so that it takes fewer blocks
+    if (l.size() > r.size()) {
+        std::swap(l, r);
+    }
+    if (l.empty()) {
+        return r.size();
     }
+    if (l.size() <= kWordSize) {
+        return SingleWordDistance(l, r, bound);
+    }
+    return BlockedDistance(l, r, bound);
+}
 
-    return v0.back();
+}  // namespace
+
+unsigned LevenshteinDistance(std::string_view l, std::string_view r) {
+    return BoundedDistance(l, r, std::numeric_limits<unsigned>::max());
+}
+
+bool LevenshteinDistanceIsLess(std::string_view l, std::string_view r, unsigned bound) {
+    // The distance is not less than the difference of the lengths
+    size_t const length_difference = std::max(l.size(), r.size()) - std::min(l.size(), r.size());
+    if (length_difference >= bound) {
+        return false;
+    }
+    return BoundedDistance(l, r, bound) < bound;
 }
 
 }  // namespace util
@@ -4,6 +4,14 @@
 
 namespace util {
 
+/* Levenshtein distance computed by Myers' bit-parallel algorithm, 64 cells of a column of the
+ * dynamic programming matrix at once. Patterns longer than 64 characters are split into blocks.
+ */
 unsigned LevenshteinDistance(std::string_view l, std::string_view r);
 
+/* Checks whether the Levenshtein distance between l and r is less than bound. Stops as soon as
+ * the rest of the strings cannot bring the distance below bound.
+ */
+bool LevenshteinDistanceIsLess(std::string_view l, std::string_view r, unsigned bound);
+
 }  // namespace util
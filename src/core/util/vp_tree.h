@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+/* Vantage-point tree over values with a metric that takes real values. Every node splits the
+ * values of its subtree by the median of their distances to the node into an inner and an outer
+ * part, and keeps the largest distance to each part. By the triangle inequality a value at
+ * distance d from the node is at most d + that radius away from everything in the part, so the
+ * pairs of parts that are close enough are skipped as a whole.
+ */
+template <typename T>
+class VPTree {
+public:
+    using DistanceFunction = std::function<long double(T const&, T const&)>;
+
+private:
+    static constexpr size_t kNoNode = std::numeric_limits<size_t>::max();
+
+    struct Node {
+        T value;
+        size_t inner = kNoNode;
+        size_t outer = kNoNode;
+        long double inner_radius = 0;
+        long double outer_radius = 0;
+
+        explicit Node(T value) : value(std::move(value)) {}
+    };
+
+    std::vector<Node> nodes_;
+    DistanceFunction dist_;
+
+    size_t Build(std::vector<T> values) {
+        if (values.empty()) {
+            return kNoNode;
+        }
+        size_t const index = nodes_.size();
+        nodes_.emplace_back(values.front());
+
+        std::vector<std::pair<long double, T>> by_distance;
+        by_distance.reserve(values.size() - 1);
+        for (auto value = std::next(values.begin()); value != values.end(); ++value) {
+            by_distance.emplace_back(dist_(values.front(), *value), std::move(*value));
+        }
+        auto const median = by_distance.begin() + by_distance.size() / 2;
+        std::nth_element(by_distance.begin(), median, by_distance.end(),
+                         [](auto const& a, auto const& b) { return a.first < b.first; });
+
+        std::vector<T> inner;
+        std::vector<T> outer;
+        long double inner_radius = 0;
+        long double outer_radius = 0;
+        for (auto it = by_distance.begin(); it != by_distance.end(); ++it) {
+            if (it < median) {
+                inner_radius = std::max(inner_radius, it->first);
+                inner.push_back(std::move(it->second));
+            } else {
+                outer_radius = std::max(outer_radius, it->first);
+                outer.push_back(std::move(it->second));
+            }
+        }
+        size_t const inner_index = Build(std::move(inner));
+        size_t const outer_index = Build(std::move(outer));
+
+        Node& node = nodes_[index];
+        node.inner = inner_index;
+        node.outer = outer_index;
+        node.inner_radius = inner_radius;
+        node.outer_radius = outer_radius;
+        return index;
+    }
+
+public:
+    VPTree(std::vector<T> values, DistanceFunction dist) : dist_(std::move(dist)) {
+        nodes_.reserve(values.size());
+        Build(std::move(values));
+    }
+
+    // Checks whether some two stored values are farther than radius from each other. Pairs of
+    // subtrees are compared at once, a pair is split only when the distance between their nodes
+    // together with both radii exceeds the given radius.
+    bool HasPairFartherThan(long double radius) const {
+        return HasPairFartherThan(radius, [](T const&, T const&) { return true; });
+    }
+
+    // Same, but a pair farther than radius counts only if confirm(first, second) holds. Lets the
+    // caller prune by a rounded distance with some slack and decide on every candidate exactly.
+    template <typename Confirm>
+    bool HasPairFartherThan(long double radius, Confirm confirm) const {
+        if (nodes_.size() < 2) {
+            return false;
+        }
+        // A node alone or together with its descendants
+        struct Part {
+            size_t node;
+            bool subtree;
+        };
+        // Distance between the values of the nodes of the parts, negative if not calculated yet
+        struct PartPair {
+            Part first;
+            Part second;
+            long double distance;
+        };
+        auto const part_radius = [this](Part const& part) {
+            Node const& node = nodes_[part.node];
+            return part.subtree ? std::max(node.inner_radius, node.outer_radius) : 0;
+        };
+        auto const has_descendants = [this](Part const& part) {
+            Node const& node = nodes_[part.node];
+            return part.subtree && (node.inner != kNoNode || node.outer != kNoNode);
+        };
+
+        std::vector<PartPair> to_visit{{{0, true}, {0, true}, 0}};
+        while (!to_visit.empty()) {
+            auto [first, second, distance] = to_visit.back();
+            to_visit.pop_back();
+            if (first.node == second.node) {
+                // Values of one subtree: its node with both parts, pairs within and between them
+                Node const& node = nodes_[first.node];
+                for (size_t part : {node.inner, node.outer}) {
+                    if (part != kNoNode) {
+                        to_visit.push_back({{first.node, false}, {part, true}, -1});
+                        to_visit.push_back({{part, true}, {part, true}, 0});
+                    }
+                }
+                if (node.inner != kNoNode && node.outer != kNoNode) {
+                    to_visit.push_back({{node.inner, true}, {node.outer, true}, -1});
+                }
+                continue;
+            }
+
+            if (distance < 0) {
+                T const& first_value = nodes_[first.node].value;
+                T const& second_value = nodes_[second.node].value;
+                distance = dist_(first_value, second_value);
+                if (distance > radius && confirm(first_value, second_value)) {
+                    return true;
+                }
+            }
+            long double first_radius = part_radius(first);
+            long double second_radius = part_radius(second);
+            if (distance + first_radius + second_radius <= radius) {
+                continue;
+            }
+            if (!has_descendants(first) && !has_descendants(second)) {
+                // Two values already compared
+                continue;
+            }
+            if (!has_descendants(first) ||
+                (has_descendants(second) && first_radius < second_radius)) {
+                std::swap(first, second);
+            }
+            // The node of the split part keeps the distance to the other one
+            Node const& node = nodes_[first.node];
+            to_visit.push_back({{first.node, false}, second, distance});
+            for (size_t part : {node.inner, node.outer}) {
+                if (part != kNoNode) {
+                    to_visit.push_back({{part, true}, second, -1});
+                }
+            }
+        }
+        return false;
+    }
+
+    size_t Size() const noexcept {
+        return nodes_.size();
+    }
+};
+
+}  // namespace util
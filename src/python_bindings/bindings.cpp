@@ -76,6 +76,7 @@ namespace python_bindings {
 namespace py = pybind11;
 // AR mining algorithms
 using PyApriori = PyArAlgorithm<algos::Apriori>;
+using PyFPGrowth = PyArAlgorithm<algos::FPGrowth>;
 // FD mining algorithms
 using PyTane = PyFDAlgorithm<algos::Tane>;
 using PyPyro = PyFDAlgorithm<algos::Pyro>;
@@ -248,6 +249,7 @@ PYBIND11_MODULE(desbordante, module) {
     DEFINE_ALGORITHM(MetricVerifier, Algorithm).def("mfd_holds", &PyMetricVerifier::MfdHolds);
 
     DEFINE_AR_ALGORITHM(Apriori);
+    DEFINE_AR_ALGORITHM(FPGrowth);
 
     DEFINE_ALGORITHM(ACAlgorithm, Algorithm)
             .def("get_ac_ranges", &PyACAlgorithm::GetACRanges)
@@ -70,6 +70,7 @@ py::tuple GetPyType(std::type_index type_index) {
             PyTypePair<algos::metric::Metric, py_str>,
             PyTypePair<algos::metric::MetricAlgo, py_str>,
             PyTypePair<algos::InputFormat, py_str>,
+            PyTypePair<algos::SupportCounting, py_str>,
             PyTypePair<std::vector<unsigned int>, py_list, py_int>,
             {typeid(config::InputTable),
              []() { return MakeTypeTuple(py::type::of<config::InputTable>()); }},
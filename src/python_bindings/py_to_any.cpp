@@ -106,6 +106,7 @@ const std::unordered_map<std::type_index, ConvFunc> converters{
         EnumConvPair<algos::metric::Metric>,
         EnumConvPair<algos::metric::MetricAlgo>,
         EnumConvPair<algos::InputFormat>,
+        EnumConvPair<algos::SupportCounting>,
         CharEnumConvPair<algos::Binop>,
         {typeid(config::InputTable), InputTableToAny},
 };
@@ -4,7 +4,10 @@
 
 #include "algorithms/algo_factory.h"
 #include "algorithms/association_rules/apriori.h"
+#include "algorithms/association_rules/ar_algorithm_enums.h"
+#include "algorithms/association_rules/fp_growth.h"
 #include "config/names.h"
+#include "config/thread_number/type.h"
 #include "table_config.h"
 
 namespace fs = std::filesystem;
@@ -347,4 +350,62 @@ TEST_F(ARAlgorithmTest, RepeatedExecutionConsistentResult) {
     }
 }
 
+TEST_F(ARAlgorithmTest, SupportCountingMethodsAgree) {
+    auto const path = test_data_dir / "transactional_data" / "rules-kaggle-rows.csv";
+    auto execute_with = [&path](algos::SupportCounting support_counting) {
+        algos::StdParamsMap params = GetParamMap(0.05, 0.5, path, true, ',', true);
+        params[config::names::kSupportCounting] = support_counting;
+        auto algorithm = algos::CreateAndLoadAlgorithm<algos::Apriori>(params);
+        algorithm->Execute();
+        return algorithm;
+    };
+    auto const hash_tree = execute_with(algos::SupportCounting::hash_tree);
+    auto const tid_bitmap = execute_with(algos::SupportCounting::tid_bitmap);
+
+    auto const frequent = hash_tree->GetFrequentList();
+    CheckFrequentListsEquality(tid_bitmap->GetFrequentList(),
+                               std::set<std::set<std::string>>(frequent.begin(), frequent.end()));
+    CheckAssociationRulesListsEquality(tid_bitmap->GetArStringsList(),
+                                       ToSet(hash_tree->GetArStringsList()));
+}
+
+TEST_F(ARAlgorithmTest, ParallelApriori) {
+    auto const path = test_data_dir / "transactional_data" / "rules-kaggle-rows.csv";
+    for (algos::SupportCounting support_counting :
+         {algos::SupportCounting::hash_tree, algos::SupportCounting::tid_bitmap}) {
+        auto execute_with = [&path, support_counting](config::ThreadNumType threads) {
+            algos::StdParamsMap params = GetParamMap(0.05, 0.5, path, true, ',', true);
+            params[config::names::kSupportCounting] = support_counting;
+            params[config::names::kThreads] = threads;
+            auto algorithm = algos::CreateAndLoadAlgorithm<algos::Apriori>(params);
+            algorithm->Execute();
+            return algorithm;
+        };
+        auto const sequential = execute_with(1);
+        auto const parallel = execute_with(4);
+
+        auto const frequent = sequential->GetFrequentList();
+        CheckFrequentListsEquality(
+                parallel->GetFrequentList(),
+                std::set<std::set<std::string>>(frequent.begin(), frequent.end()));
+        CheckAssociationRulesListsEquality(parallel->GetArStringsList(),
+                                           ToSet(sequential->GetArStringsList()));
+    }
+}
+
+TEST_F(ARAlgorithmTest, FPGrowthMatchesApriori) {
+    auto const path = test_data_dir / "transactional_data" / "rules-kaggle-rows.csv";
+    auto const params = GetParamMap(0.05, 0.5, path, true, ',', true);
+    auto apriori = algos::CreateAndLoadAlgorithm<algos::Apriori>(params);
+    apriori->Execute();
+    auto fp_growth = algos::CreateAndLoadAlgorithm<algos::FPGrowth>(params);
+    fp_growth->Execute();
+
+    auto const frequent = apriori->GetFrequentList();
+    CheckFrequentListsEquality(fp_growth->GetFrequentList(),
+                               std::set<std::set<std::string>>(frequent.begin(), frequent.end()));
+    CheckAssociationRulesListsEquality(fp_growth->GetArStringsList(),
+                                       ToSet(apriori->GetArStringsList()));
+}
+
 }  // namespace tests
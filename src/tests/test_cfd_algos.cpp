@@ -9,6 +9,7 @@
 #include "algorithms/cfd/enums.h"
 #include "algorithms/cfd/fd_first_algorithm.h"
 #include "config/names.h"
+#include "config/thread_number/type.h"
 #include "table_config.h"
 
 namespace tests {
@@ -32,7 +33,8 @@ protected:
     static std::unique_ptr<algos::cfd::FDFirstAlgorithm> CreateAlgorithmInstance(
             unsigned minsup, double minconf, const std::filesystem::path& path,
             char const* substrategy, unsigned int max_lhs, unsigned columns_number = 0,
-            unsigned tuples_number = 0, char separator = ',', bool has_header = true) {
+            unsigned tuples_number = 0, char separator = ',', bool has_header = true,
+            config::ThreadNumType threads = 1) {
         using namespace config::names;
 
         algos::StdParamsMap params{
@@ -44,7 +46,8 @@ protected:
                 {kCfdMaximumLhs, max_lhs},
                 {kCfdSubstrategy, algos::cfd::Substrategy::_from_string(substrategy)},
                 {kCfdTuplesNumber, tuples_number},
-                {kCfdColumnsNumber, columns_number}};
+                {kCfdColumnsNumber, columns_number},
+                {kThreads, threads}};
         return algos::CreateAndLoadAlgorithm<algos::cfd::FDFirstAlgorithm>(params);
     }
 };
@@ -128,4 +131,24 @@ TEST_F(CFDAlgorithmTest, PartialMushroomDataset) {
 
     CheckCfdSetsEquality(actual_cfds, expected_cfds);
 }
+
+TEST_F(CFDAlgorithmTest, ParallelMushroomDataset) {
+    auto const path = test_data_dir / "cfd_data" / "mushroom.csv";
+    for (char const* substrategy : {"dfs", "bfs"}) {
+        auto algorithm = CreateAlgorithmInstance(4, 0.9, path, substrategy, 4, 6, 200);
+        algorithm->Execute();
+        std::vector<std::string> expected_cfds;
+        for (auto const& cfd : algorithm->GetItemsetCfds()) {
+            expected_cfds.push_back(algorithm->GetCfdString(cfd));
+        }
+
+        algorithm = CreateAlgorithmInstance(4, 0.9, path, substrategy, 4, 6, 200, ',', true, 4);
+        algorithm->Execute();
+        std::vector<std::string> actual_cfds;
+        for (auto const& cfd : algorithm->GetItemsetCfds()) {
+            actual_cfds.push_back(algorithm->GetCfdString(cfd));
+        }
+        ASSERT_EQ(actual_cfds, expected_cfds) << "substrategy " << substrategy;
+    }
+}
 }  // namespace tests
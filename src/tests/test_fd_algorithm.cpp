@@ -6,14 +6,18 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "algorithms/fd/aidfd/aid.h"
 #include "algorithms/fd/depminer/depminer.h"
 #include "algorithms/fd/dfd/dfd.h"
 #include "algorithms/fd/fastfds/fastfds.h"
+#include "algorithms/fd/fd_mine/fd_mine.h"
 #include "algorithms/fd/fdep/fdep.h"
 #include "algorithms/fd/fun/fun.h"
 #include "algorithms/fd/hyfd/hyfd.h"
 #include "algorithms/fd/pyro/pyro.h"
 #include "algorithms/fd/tane/tane.h"
+#include "config/names.h"
+#include "config/thread_number/type.h"
 #include "model/table/relational_schema.h"
 #include "table_config.h"
 #include "test_fd_util.h"
@@ -132,4 +136,84 @@ using Algorithms = ::testing::Types<algos::Tane, algos::Pyro, algos::FastFDs, al
                                     algos::Depminer, algos::FDep, algos::FUN, algos::hyfd::HyFD>;
 INSTANTIATE_TYPED_TEST_SUITE_P(AlgorithmTest, AlgorithmTest, Algorithms);
 
+std::vector<TableConfig> const kParallelTestDatasets = {
+        kWDC_astronomical, kWDC_age,     kWDC_appearances,    kWDC_game,
+        kWDC_kepler,       kWDC_symbols, kCIPublicHighway10k, kneighbors10k};
+
+template <typename T>
+std::list<FD> MineFds(TableConfig const& config, algos::StdParamsMap params) {
+    params.emplace(config::names::kTable, config.MakeInputTable());
+    auto algorithm = algos::CreateAndLoadAlgorithm<T>(params);
+    algorithm->Execute();
+    return algorithm->FdList();
+}
+
+std::vector<std::pair<std::vector<unsigned int>, unsigned int>> FDsToVector(
+        std::list<FD> const& fds) {
+    std::vector<std::pair<std::vector<unsigned int>, unsigned int>> fd_vector;
+    for (auto const& fd : fds) {
+        auto const& raw_fd = fd.ToRawFD();
+        fd_vector.emplace_back(BitsetToIndexVector(raw_fd.lhs_), raw_fd.rhs_);
+    }
+    return fd_vector;
+}
+
+TEST(DFDTest, FixedSeedReproducesResult) {
+    using namespace config::names;
+    for (auto const& config : kParallelTestDatasets) {
+        for (int seed : {0, 42}) {
+            auto const expected = FDsToVector(MineFds<algos::DFD>(
+                    config, {{kSeed, seed}, {kThreads, config::ThreadNumType{1}}}));
+            for (config::ThreadNumType threads : {1, 4}) {
+                EXPECT_EQ(expected, FDsToVector(MineFds<algos::DFD>(
+                                            config, {{kSeed, seed}, {kThreads, threads}})))
+                        << "DFD with seed " << seed << " and " << threads
+                        << " threads changed the FD list at " << config.name;
+            }
+        }
+    }
+}
+
+/* The FDs must not depend on the number of threads. Every algorithm gets the options that make
+ * its result deterministic otherwise and the datasets it mines in reasonable time. */
+template <typename T>
+class ThreadNumberTest : public ::testing::Test {
+protected:
+    static algos::StdParamsMap GetParams() {
+        return {};
+    }
+
+    static std::vector<TableConfig> const& GetDatasets() {
+        return kParallelTestDatasets;
+    }
+};
+
+template <>
+algos::StdParamsMap ThreadNumberTest<algos::Pyro>::GetParams() {
+    using namespace config::names;
+    return {{kError, config::ErrorType{0.0}}, {kSeed, 0}};
+}
+
+template <>
+std::vector<TableConfig> const& ThreadNumberTest<algos::Fd_mine>::GetDatasets() {
+    static std::vector<TableConfig> const datasets = {
+            kWDC_astronomical, kWDC_age,     kWDC_appearances,   kWDC_game,
+            kWDC_kepler,       kWDC_symbols, kCIPublicHighway700};
+    return datasets;
+}
+
+using ParallelAlgorithms = ::testing::Types<algos::Aid, algos::Pyro, algos::FUN, algos::Fd_mine>;
+TYPED_TEST_SUITE(ThreadNumberTest, ParallelAlgorithms);
+
+TYPED_TEST(ThreadNumberTest, SeveralThreadsMatchOne) {
+    for (auto const& config : TestFixture::GetDatasets()) {
+        algos::StdParamsMap params = TestFixture::GetParams();
+        params[config::names::kThreads] = config::ThreadNumType{1};
+        auto const one_thread_fds = FDsToSet(MineFds<TypeParam>(config, params));
+        params[config::names::kThreads] = config::ThreadNumType{4};
+        EXPECT_TRUE(CheckFdListEquality(one_thread_fds, MineFds<TypeParam>(config, params)))
+                << "Several threads changed the FDs at " << config.name;
+    }
+}
+
 }  // namespace tests
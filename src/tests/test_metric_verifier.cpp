@@ -1,7 +1,10 @@
+#include <algorithm>
 #include <filesystem>
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -11,6 +14,7 @@
 #include "algorithms/metric/enums.h"
 #include "algorithms/metric/metric_verifier.h"
 #include "config/names.h"
+#include "config/thread_number/type.h"
 #include "table_config.h"
 
 namespace tests {
@@ -36,7 +40,8 @@ struct MetricVerifyingParams {
                   {onam::kMetric, algos::metric::Metric::_from_string(metric)},
                   {onam::kQGramLength, q},
                   {onam::kMetricAlgorithm, algos::metric::MetricAlgo::_from_string(algo)},
-                  {onam::kDistFromNullIsInfinity, dist_from_null_is_infinity}}),
+                  {onam::kDistFromNullIsInfinity, dist_from_null_is_infinity},
+                  {onam::kThreads, static_cast<config::ThreadNumType>(1)}}),
           expected(expected) {}
 };
 
@@ -60,7 +65,8 @@ struct HighlightTestParams {
                   {onam::kMetric, algos::metric::Metric::_from_string(metric)},
                   {onam::kQGramLength, q},
                   {onam::kMetricAlgorithm, algos::metric::MetricAlgo::_from_string(algo)},
-                  {onam::kDistFromNullIsInfinity, dist_from_null_is_infinity}}),
+                  {onam::kDistFromNullIsInfinity, dist_from_null_is_infinity},
+                  {onam::kThreads, static_cast<config::ThreadNumType>(1)}}),
           highlight_distances(std::move(highlight_distances)) {}
 };
 
@@ -112,12 +118,70 @@ TEST_P(TestMetricVerifying, ConsistentRepeatedExecution) {
     }
 }
 
-TEST_P(TestHighlights, DefaultTest) {  // Assumes that highlights are sorted by distance in reverse
-    auto const& params = GetParam().params;
-    auto const& highlight_distances = GetParam().highlight_distances;
+TEST_P(TestMetricVerifying, ParallelTest) {
+    auto params = GetParam().params;
+    params[onam::kThreads] = static_cast<config::ThreadNumType>(4);
     auto verifier = CreateMetricVerifier(params);
-    auto const& highlights = GetHighlights(*verifier);
+    ASSERT_EQ(GetResult(*verifier), GetParam().expected);
+}
+
+// In MetricMixedNulls.csv the LHS "a" makes a cluster whose check throws before a violating
+// cluster, and "b" makes a violating cluster before a larger one whose check throws. The approx
+// result must be the one of a sequential check whatever the number of threads.
+TEST(MetricVerifierApproxTest, FirstDecidingClusterWins) {
+    for (config::ThreadNumType threads : {1, 4}) {
+        for (unsigned lhs_index : {0, 1}) {
+            algos::StdParamsMap params =
+                    MetricVerifyingParams("euclidean", 1, {lhs_index}, {2, 3},
+                                          "MetricMixedNulls.csv", "approx")
+                            .params;
+            params[onam::kThreads] = threads;
+            auto verifier = CreateMetricVerifier(params);
+            if (lhs_index == 0) {
+                EXPECT_THROW(GetResult(*verifier), std::runtime_error) << threads << " threads";
+            } else {
+                EXPECT_FALSE(GetResult(*verifier)) << threads << " threads";
+            }
+        }
+    }
+}
+
+// A cluster with a parameter equal to its diameter satisfies the metric FD, while the cosine check
+// prunes pairs by rounded angles. The diameters are the largest distances of the highlights.
+TEST(MetricVerifierCosineTest, ParameterEqualToClusterDiameter) {
+    // LHS index, RHS index and q
+    std::vector<std::tuple<unsigned, unsigned, unsigned>> const columns = {
+            {0, 7, 2}, {1, 7, 2}, {0, 8, 3}, {1, 8, 3}, {0, 6, 2}, {1, 5, 1}};
+    for (auto [lhs_index, rhs_index, q] : columns) {
+        algos::StdParamsMap params = MetricVerifyingParams("cosine", 0, {lhs_index}, {rhs_index},
+                                                           "TestMetric.csv", "brute", false, true,
+                                                           q)
+                                             .params;
+        std::vector<long double> diameters;
+        auto zero_verifier = CreateMetricVerifier(params);
+        for (auto const& cluster_highlights : GetHighlights(*zero_verifier)) {
+            ASSERT_FALSE(cluster_highlights.empty());
+            diameters.push_back(cluster_highlights.front().max_distance);
+        }
+        ASSERT_FALSE(diameters.empty());
+        long double const max_diameter = *std::max_element(diameters.begin(), diameters.end());
+
+        for (config::ThreadNumType threads : {1, 4}) {
+            for (long double diameter : diameters) {
+                params[onam::kParameter] = diameter;
+                params[onam::kThreads] = threads;
+                auto verifier = CreateMetricVerifier(params);
+                EXPECT_EQ(GetResult(*verifier), diameter == max_diameter)
+                        << "lhs " << lhs_index << ", rhs " << rhs_index << ", parameter "
+                        << diameter << ", " << threads << " threads";
+            }
+        }
+    }
+}
 
+static void CheckHighlightDistances(
+        std::vector<std::vector<algos::metric::Highlight>> const& highlights,
+        std::vector<std::vector<long double>> const& highlight_distances) {
     ASSERT_TRUE(highlights.size() == highlight_distances.size());
     for (size_t i = 0; i < highlights.size(); ++i) {
         ASSERT_TRUE(highlights[i].size() == highlight_distances[i].size());
@@ -129,6 +193,19 @@ TEST_P(TestHighlights, DefaultTest) {  // Assumes that highlights are sorted by
     }
 }
 
+TEST_P(TestHighlights, DefaultTest) {  // Assumes that highlights are sorted by distance in reverse
+    auto const& params = GetParam().params;
+    auto verifier = CreateMetricVerifier(params);
+    CheckHighlightDistances(GetHighlights(*verifier), GetParam().highlight_distances);
+}
+
+TEST_P(TestHighlights, ParallelTest) {
+    auto params = GetParam().params;
+    params[onam::kThreads] = static_cast<config::ThreadNumType>(4);
+    auto verifier = CreateMetricVerifier(params);
+    CheckHighlightDistances(GetHighlights(*verifier), GetParam().highlight_distances);
+}
+
 INSTANTIATE_TEST_SUITE_P(
         MetricVerifierTestSuite, TestMetricVerifying,
         ::testing::Values(
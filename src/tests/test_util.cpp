@@ -1,21 +1,31 @@
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
 #include <thread>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "fd/aidfd/search_tree.h"
+#include "fd/hyfd/model/fd_tree.h"
 #include "fd/pyro/model/list_agree_set_sample.h"
 #include "levenshtein_distance.h"
 #include "model/table/agree_set_factory.h"
 #include "model/table/column_layout_relation_data.h"
 #include "model/table/identifier_set.h"
 #include "table_config.h"
+#include "util/bitset_trie.h"
+#include "util/bk_tree.h"
+#include "util/vp_tree.h"
 
 namespace tests {
 
 using std::deque, std::vector, std::cout, std::endl, std::unique_ptr, model::AgreeSetFactory,
         model::MCGenMethod, model::AgreeSetsGenMethod;
-using ::testing::ContainerEq, ::testing::Eq;
+using ::testing::ContainerEq, ::testing::Eq, ::testing::ElementsAre;
 
 namespace fs = std::filesystem;
 
@@ -80,13 +90,285 @@ TEST(pliIntersectChecker, first) {
     ASSERT_THAT(intersection->GetIndex(), ContainerEq(ans));
 }
 
-TEST(testingBitsetToLonglong, first) {
-    size_t encoded_num = 1254;
-    boost::dynamic_bitset<> simple_bitset{20, encoded_num};
+TEST(pliIntersectChecker, probeAllMatchesPairwiseProbes) {
+    auto csv_parser = std::make_unique<CSVParser>(test_data_dir / "CIPublicHighway700.csv");
+    auto relation = ColumnLayoutRelationData::CreateFrom(*csv_parser, true);
+    size_t const num_columns = relation->GetNumColumns();
+
+    // The other columns are probed twice, so the longest operand lists need probe keys wider
+    // than 64 bits
+    for (size_t base_column = 0; base_column < num_columns; ++base_column) {
+        model::PositionListIndex const* base =
+                relation->GetColumnData(base_column).GetPositionListIndex();
+        vector<model::PositionListIndex const*> operands;
+        unique_ptr<model::PositionListIndex> expected;
+        for (size_t i = 0; i < 2 * num_columns; ++i) {
+            size_t const column = i % num_columns;
+            if (column == base_column) continue;
+            model::PositionListIndex const* operand =
+                    relation->GetColumnData(column).GetPositionListIndex();
+            operands.push_back(operand);
+            model::PositionListIndex const* previous = expected ? expected.get() : base;
+            expected = previous->Probe(operand->CalculateAndGetProbingTable());
+
+            auto actual = base->ProbeAll(operands);
+            ASSERT_THAT(actual->GetIndex(), ContainerEq(expected->GetIndex()))
+                    << "column " << base_column << " probed with " << operands.size()
+                    << " columns";
+            ASSERT_EQ(actual->GetNepAsLong(), expected->GetNepAsLong());
+            ASSERT_EQ(actual->GetSize(), expected->GetSize());
+        }
+    }
+}
+
+TEST(listAgreeSetSampleChecker, countsSupersets) {
+    auto csv_parser = std::make_unique<CSVParser>(test_data_dir / "TestFD.csv");
+    auto relation = ColumnLayoutRelationData::CreateFrom(*csv_parser, true);
+    RelationalSchema const* schema = relation->GetSchema();
+    auto make = [schema](std::string const& bits) {
+        return Vertical(schema, boost::dynamic_bitset<>(bits));
+    };
+
+    // Counts above 64 take several count planes
+    std::unordered_map<boost::dynamic_bitset<>, int> const agree_set_counters = {
+            {boost::dynamic_bitset<>(std::string("000111")), 3},
+            {boost::dynamic_bitset<>(std::string("000011")), 2},
+            {boost::dynamic_bitset<>(std::string("001101")), 70},
+    };
+    model::ListAgreeSetSample sample(relation.get(), make("000001"), 75, 150, agree_set_counters);
+
+    EXPECT_EQ(sample.GetNumAgreeSupersets(make("000001")), 75);
+    EXPECT_EQ(sample.GetNumAgreeSupersets(make("000010")), 5);
+    EXPECT_EQ(sample.GetNumAgreeSupersets(make("000100")), 73);
+    EXPECT_EQ(sample.GetNumAgreeSupersets(make("000010"), make("000100")), 2);
+    EXPECT_EQ(sample.GetNumAgreeSupersets(make("000100"), make("001000")), 3);
+    EXPECT_EQ(sample.GetNumAgreeSupersets(make("110000")), 0);
+    EXPECT_THAT(*sample.GetNumAgreeSupersetsExt(make("000101"), make("001000")),
+                ElementsAre(73, 3));
+}
+
+TEST(BitsetTrieTest, SubsetSupersetQueries) {
+    auto make = [](std::string const& bits) { return boost::dynamic_bitset<>(bits); };
+    util::BitsetTrie trie(6);
+
+    ASSERT_TRUE(trie.Insert(make("000110")));
+    ASSERT_TRUE(trie.Insert(make("101000")));
+    ASSERT_TRUE(trie.Insert(make("001011")));
+    ASSERT_FALSE(trie.Insert(make("000110")));
+    ASSERT_EQ(trie.Size(), 3);
+
+    EXPECT_TRUE(trie.ContainsSubsetOf(make("011110")));
+    EXPECT_FALSE(trie.ContainsSubsetOf(make("010110") & make("110011")));
+    EXPECT_TRUE(trie.ContainsSupersetOf(make("001001")));
+    EXPECT_FALSE(trie.ContainsSupersetOf(make("100001")));
+
+    EXPECT_EQ(trie.EraseSupersetsOf(make("001000")), 2);
+    EXPECT_FALSE(trie.Contains(make("101000")));
+    EXPECT_FALSE(trie.ContainsSupersetOf(make("001000")));
+    EXPECT_EQ(trie.EraseSubsetsOf(make("111110")), 1);
+    EXPECT_TRUE(trie.IsEmpty());
+
+    ASSERT_TRUE(trie.Insert(make("001011")));
+    std::vector<boost::dynamic_bitset<>> stored;
+    trie.ForEach([&stored](boost::dynamic_bitset<> const& set) { stored.push_back(set); });
+    ASSERT_THAT(stored, ElementsAre(make("001011")));
+}
+
+TEST(MetricTreeTest, FartherThanQueries) {
+    std::vector<std::string> const values = {"book", "back", "boon", "cook", "brook", "book",
+                                             "cake", "bake", "books", "look"};
+    auto dist = [](std::string_view l, std::string_view r) {
+        return util::LevenshteinDistance(l, r);
+    };
+    for (size_t count = 1; count <= values.size(); ++count) {
+        for (unsigned radius = 0; radius <= 5; ++radius) {
+            bool has_farther = false;
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t j = i + 1; j < count; ++j) {
+                    has_farther |= dist(values[i], values[j]) > radius;
+                }
+            }
+
+            util::BKTree<std::string_view> bk_tree(dist);
+            bool bk_has_farther = false;
+            for (size_t i = 0; i < count && !bk_has_farther; ++i) {
+                bk_has_farther = bk_tree.HasFartherThan(values[i], radius);
+                bk_tree.Insert(values[i]);
+            }
+            EXPECT_EQ(bk_has_farther, has_farther) << count << " values, radius " << radius;
+
+            util::VPTree<std::string_view> vp_tree(
+                    std::vector<std::string_view>(values.begin(), values.begin() + count), dist);
+            EXPECT_EQ(vp_tree.HasPairFartherThan(radius), has_farther)
+                    << count << " values, radius " << radius;
+        }
+    }
 
-    auto res_vector = *model::ListAgreeSetSample::BitSetToLongLongVector(simple_bitset);
-    ASSERT_EQ(res_vector.size(), 1);
-    for (auto long_long_repr : res_vector) ASSERT_EQ(encoded_num, long_long_repr);
+    util::BKTree<std::string_view> bk_tree(dist);
+    for (std::string const& value : values) {
+        bk_tree.Insert(value);
+    }
+    EXPECT_EQ(bk_tree.Size(), values.size() - 1);
+}
+
+TEST(SearchTreeTest, MatchesLinearScan) {
+    using Bitset = SearchTree::Bitset;
+    std::mt19937 gen(0);
+    // 100 attributes do not fit into one bitset block
+    for (size_t num_attributes : {7, 100}) {
+        // sets are sparse and queries are dense, so that queries have some stored subsets
+        auto random_set = [&gen, num_attributes](double density) {
+            std::bernoulli_distribution has_bit(density);
+            Bitset set(num_attributes);
+            while (set.none()) {
+                for (size_t bit = 0; bit < num_attributes; ++bit) {
+                    set[bit] = has_bit(gen);
+                }
+            }
+            return set;
+        };
+        double const set_density = num_attributes < 10 ? 0.3 : 0.05;
+        SearchTree tree(num_attributes);
+        std::set<Bitset> expected;
+
+        for (int step = 0; step < 2000; ++step) {
+            Bitset const set = random_set(set_density);
+            if (step % 5 == 4 && !expected.empty()) {
+                // remove a stored set or, now and then, a random one
+                Bitset const to_remove = step % 5 == 0 ? set : *expected.begin();
+                ASSERT_EQ(tree.Remove(to_remove), expected.erase(to_remove) == 1);
+            } else {
+                ASSERT_EQ(tree.Add(set), expected.insert(set).second);
+            }
+            ASSERT_EQ(tree.GetCardinality(), expected.size());
+
+            Bitset const query = random_set(1 - set_density);
+            std::set<Bitset> expected_subsets;
+            for (Bitset const& stored : expected) {
+                if (stored.is_subset_of(query)) expected_subsets.insert(stored);
+            }
+            std::set<Bitset> subsets;
+            tree.ForEachSubset(query, [&subsets](Bitset const& subset) {
+                EXPECT_TRUE(subsets.insert(subset).second);
+            });
+            ASSERT_EQ(subsets, expected_subsets) << "step " << step;
+            ASSERT_EQ(tree.ContainsAnySubsetOf(query), !expected_subsets.empty());
+        }
+
+        std::set<Bitset> stored;
+        tree.ForEach([&stored](Bitset const& set) { EXPECT_TRUE(stored.insert(set).second); });
+        ASSERT_EQ(stored, expected);
+    }
+}
+
+TEST(FDTreeTest, MatchesLinearScan) {
+    using Bitset = boost::dynamic_bitset<>;
+    using algos::hyfd::fd_tree::FDTree;
+    std::mt19937 gen(0);
+    // 70 attributes do not fit into one bitset block
+    for (size_t num_attributes : {6, 70}) {
+        auto random_set = [&gen, num_attributes](size_t max_size) {
+            Bitset set(num_attributes);
+            size_t const size = std::uniform_int_distribution<size_t>(0, max_size)(gen);
+            for (size_t i = 0; i < size; ++i) {
+                set.set(std::uniform_int_distribution<size_t>(0, num_attributes - 1)(gen));
+            }
+            return set;
+        };
+        auto random_attribute = [&gen, num_attributes]() {
+            return std::uniform_int_distribution<size_t>(0, num_attributes - 1)(gen);
+        };
+        FDTree tree(num_attributes);
+        // RHSs of every stored LHS. As in HyFD, the LHSs of one RHS never contain each other, and
+        // the tree starts with the empty LHS determining every attribute
+        std::map<Bitset, Bitset> expected{{Bitset(num_attributes), Bitset(num_attributes).set()}};
+        // leave the empty LHS only for the even attributes, so that the odd ones get other LHSs
+        for (size_t rhs = 1; rhs < num_attributes; rhs += 2) {
+            tree.Remove(Bitset(num_attributes), rhs);
+            expected.begin()->second.reset(rhs);
+        }
+        auto has_comparable_lhs = [&expected](Bitset const& lhs, size_t rhs) {
+            for (auto const& [stored_lhs, rhss] : expected) {
+                if (rhss[rhs] && (stored_lhs.is_subset_of(lhs) || lhs.is_subset_of(stored_lhs))) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        // every vertex of the tree is an ascending prefix of a stored LHS
+        auto get_vertex_lhss = [&expected, num_attributes]() {
+            std::set<Bitset> vertex_lhss{Bitset(num_attributes)};
+            for (auto const& [lhs, rhss] : expected) {
+                Bitset prefix(num_attributes);
+                for (size_t bit = lhs.find_first(); bit != Bitset::npos; bit = lhs.find_next(bit)) {
+                    prefix.set(bit);
+                    vertex_lhss.insert(prefix);
+                }
+            }
+            return vertex_lhss;
+        };
+
+        for (int step = 0; step < 2000; ++step) {
+            Bitset lhs = random_set(2);
+            lhs.set(random_attribute());
+            size_t const rhs = random_attribute();
+            if (step % 5 == 4 && !expected.empty()) {
+                auto it = std::next(expected.begin(), gen() % expected.size());
+                Bitset const stored_lhs = it->first;
+                size_t stored_rhs = it->second.find_first();
+                for (size_t skip = gen() % it->second.count(); skip != 0; --skip) {
+                    stored_rhs = it->second.find_next(stored_rhs);
+                }
+                tree.Remove(stored_lhs, stored_rhs);
+                it->second.reset(stored_rhs);
+                if (it->second.none()) expected.erase(it);
+                ASSERT_FALSE(tree.ContainsFD(stored_lhs, stored_rhs));
+            } else if (!lhs[rhs] && !has_comparable_lhs(lhs, rhs)) {
+                bool const is_new_vertex = lhs.any() && get_vertex_lhss().count(lhs) == 0;
+                ASSERT_EQ(tree.AddFD(lhs, rhs) != FDTree::kNoVertex, is_new_vertex);
+                expected.try_emplace(lhs, num_attributes).first->second.set(rhs);
+            }
+            ASSERT_EQ(tree.ContainsFD(lhs, rhs), expected.count(lhs) != 0 && expected[lhs][rhs]);
+
+            // GetFdAndGenerals expects a non-empty LHS as well
+            Bitset query = random_set(num_attributes);
+            query.set(random_attribute());
+            std::set<Bitset> expected_generals;
+            for (auto const& [stored_lhs, rhss] : expected) {
+                if (rhss[rhs] && stored_lhs.is_subset_of(query)) {
+                    expected_generals.insert(stored_lhs);
+                }
+            }
+            std::vector<Bitset> const generals = tree.GetFdAndGenerals(query, rhs);
+            ASSERT_EQ(std::set<Bitset>(generals.begin(), generals.end()), expected_generals)
+                    << "step " << step;
+            ASSERT_EQ(generals.size(), expected_generals.size());
+            ASSERT_EQ(tree.FindFdOrGeneral(query, rhs), !expected_generals.empty());
+
+            if (step % 100 != 99) continue;
+            std::map<Bitset, Bitset> stored;
+            for (RawFD const& fd : tree.FillFDs()) {
+                Bitset& rhss = stored.try_emplace(fd.lhs_, num_attributes).first->second;
+                ASSERT_FALSE(rhss[fd.rhs_]);
+                rhss.set(fd.rhs_);
+            }
+            ASSERT_EQ(stored, expected);
+
+            std::set<Bitset> const vertex_lhss = get_vertex_lhss();
+            size_t num_vertices = 0;
+            for (unsigned level = 0; level <= num_attributes; ++level) {
+                for (auto const& [vertex, vertex_lhs] : tree.GetLevel(level)) {
+                    ASSERT_EQ(vertex_lhs.count(), level);
+                    ASSERT_EQ(vertex_lhss.count(vertex_lhs), 1);
+                    auto it = expected.find(vertex_lhs);
+                    ASSERT_EQ(tree.GetFDs(vertex),
+                              it == expected.end() ? Bitset(num_attributes) : it->second);
+                    ++num_vertices;
+                }
+            }
+            ASSERT_EQ(num_vertices, vertex_lhss.size());
+        }
+    }
 }
 
 TEST(IdentifierSetTest, Computation) {
@@ -224,6 +506,8 @@ TEST_P(TestLevenshtein, Default) {
     TestLevenshteinParam const& p = GetParam();
     unsigned actual = util::LevenshteinDistance(p.l, p.r);
     EXPECT_EQ(actual, p.expected);
+    EXPECT_FALSE(util::LevenshteinDistanceIsLess(p.l, p.r, p.expected));
+    EXPECT_TRUE(util::LevenshteinDistanceIsLess(p.l, p.r, p.expected + 1));
 }
 
 INSTANTIATE_TEST_SUITE_P(TestLevenshteinSuite, TestLevenshtein,
@@ -233,6 +517,53 @@ INSTANTIATE_TEST_SUITE_P(TestLevenshteinSuite, TestLevenshtein,
                                            TestLevenshteinParam("book", "back", 2),
                                            TestLevenshteinParam("book", "", 4),
                                            TestLevenshteinParam("", "book", 4),
-                                           TestLevenshteinParam("randomstring", "juststring", 6)));
+                                           TestLevenshteinParam("randomstring", "juststring", 6),
+                                           TestLevenshteinParam(std::string(100, 'a'),
+                                                                std::string(70, 'a') +
+                                                                        std::string(30, 'b'),
+                                                                30),
+                                           TestLevenshteinParam(std::string(130, 'a'),
+                                                                std::string(130, 'b'), 130)));
+
+// Textbook dynamic programming over the whole matrix
+static unsigned DPLevenshteinDistance(std::string const& l, std::string const& r) {
+    std::vector<unsigned> prev(r.size() + 1);
+    std::vector<unsigned> curr(r.size() + 1);
+    std::iota(prev.begin(), prev.end(), 0);
+    for (size_t i = 1; i <= l.size(); ++i) {
+        curr[0] = i;
+        for (size_t j = 1; j <= r.size(); ++j) {
+            curr[j] = std::min({prev[j] + 1, curr[j - 1] + 1,
+                                prev[j - 1] + (l[i - 1] == r[j - 1] ? 0 : 1)});
+        }
+        std::swap(prev, curr);
+    }
+    return prev[r.size()];
+}
+
+// Strings over small alphabets match often, so the patterns longer than 64 characters carry
+// horizontal deltas of both signs between their blocks
+TEST(LevenshteinTest, LongPatternsMatchDynamicProgramming) {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<size_t> length_dist(60, 200);
+    for (int i = 0; i < 2000; ++i) {
+        std::uniform_int_distribution<int> letter_dist(0, 1 + i % 3);
+        auto random_string = [&]() {
+            std::string str(length_dist(gen), ' ');
+            for (char& c : str) c = static_cast<char>('a' + letter_dist(gen));
+            return str;
+        };
+        std::string const l = random_string();
+        std::string const r = random_string();
+        unsigned const expected = DPLevenshteinDistance(l, r);
+
+        ASSERT_EQ(util::LevenshteinDistance(l, r), expected) << l << ' ' << r;
+        ASSERT_EQ(util::LevenshteinDistance(r, l), expected) << l << ' ' << r;
+        for (unsigned bound : {expected / 2, expected, expected + 1, expected + 10}) {
+            ASSERT_EQ(util::LevenshteinDistanceIsLess(l, r, bound), expected < bound)
+                    << l << ' ' << r << ' ' << bound;
+        }
+    }
+}
 
 }  // namespace tests